@@ -0,0 +1,261 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * An accumulator of the observations made by a time series measure
+ *
+ * An accumulator splits a measure into its stages: it is created for a
+ * particular measure and set of parameters (e.g. with
+ * inform_active_info_acc), fed chunks of time series with
+ * inform_acc_accumulate, optionally merged with accumulators built
+ * elsewhere with inform_acc_merge, and finally reduced with
+ * inform_acc_finalize. Only the histograms and the last few time steps are
+ * retained, so a time series never has to be held in memory all at once.
+ *
+ * Consecutive chunks are treated as a single time series: observations
+ * which straddle the boundary between two chunks are made exactly as if the
+ * chunks had been concatenated. Calling inform_acc_restart starts a new
+ * initial condition.
+ */
+typedef struct inform_accumulator inform_acc;
+
+/**
+ * Accumulate observations from the next chunk of a time series.
+ *
+ * For measures of a single variable, `series` holds `m` time steps. For
+ * measures of several variables, e.g. mutual information, `series` holds `m`
+ * time steps of each variable, one after the other, in the same layout
+ * accepted by the corresponding measure.
+ *
+ * The chunk is validated before anything is observed, so an invalid chunk
+ * leaves the accumulator untouched.
+ *
+ * @param[in,out] acc the accumulator
+ * @param[in] series  the chunk of the time series
+ * @param[in] m       the number of time steps in the chunk
+ * @param[out] err    an error structure
+ * @return true if an error occurred
+ */
+EXPORT bool inform_acc_accumulate(inform_acc *acc, int const *series,
+    size_t m, inform_error *err);
+
+/**
+ * A source of the time steps of a time series, e.g. a file, from which
+ * inform_acc_read pulls one chunk at a time
+ *
+ * The reader writes up to `m` time steps of each of the accumulator's
+ * streams into `series`, the time steps of stream `s` starting at
+ * `series + s * m`, and returns the number of time steps it wrote. It returns
+ * 0 once the time series is exhausted. If it fails, it should set `err` and
+ * return 0.
+ *
+ * @param[in,out] arg the reader's state
+ * @param[out] series the buffer
+ * @param[in] m       the most time steps to write
+ * @param[out] err    an error structure
+ * @return the number of time steps written
+ */
+typedef size_t (*inform_reader)(void *arg, int *series, size_t m,
+    inform_error *err);
+
+/**
+ * Accumulate every chunk pulled from a reader until it is exhausted.
+ *
+ * Each chunk is accumulated as if by inform_acc_accumulate, so the chunks
+ * continue the current time series and only a buffer of `chunk` time steps
+ * of each stream is ever held in memory, however long the series. If a
+ * chunk is invalid or the reader fails, reading stops; the chunks before it
+ * remain accumulated.
+ *
+ * @param[in,out] acc the accumulator
+ * @param[in] read    the reader
+ * @param[in,out] arg the reader's state
+ * @param[in] chunk   the most time steps to pull at once
+ * @param[out] err    an error structure
+ * @return true if an error occurred
+ */
+EXPORT bool inform_acc_read(inform_acc *acc, inform_reader read, void *arg,
+    size_t chunk, inform_error *err);
+
+/**
+ * End the current time series so that the next chunk accumulated is
+ * treated as a new initial condition.
+ *
+ * @param[in,out] acc the accumulator
+ */
+EXPORT void inform_acc_restart(inform_acc *acc);
+
+/**
+ * Add the observations of one accumulator to another.
+ *
+ * The accumulators must have been created for the same measure with the
+ * same parameters. The time series being accumulated by the destination is
+ * unaffected, i.e. the source's observations are treated as having come
+ * from other initial conditions.
+ *
+ * @param[in] src      the accumulator whose observations are added
+ * @param[in,out] dest the accumulator to add them to
+ * @param[out] err     an error structure
+ * @return true if an error occurred
+ */
+EXPORT bool inform_acc_merge(inform_acc const *src, inform_acc *dest,
+    inform_error *err);
+
+/**
+ * Get the number of observations made by an accumulator.
+ *
+ * @param[in] acc the accumulator
+ * @return the number of observations
+ */
+EXPORT uint64_t inform_acc_observations(inform_acc const *acc);
+
+/**
+ * Compute the measure over every observation accumulated so far.
+ *
+ * The accumulator is not modified, so accumulation may continue.
+ *
+ * @param[in] acc  the accumulator
+ * @param[out] err an error structure
+ * @return the value of the measure
+ */
+EXPORT double inform_acc_finalize(inform_acc const *acc, inform_error *err);
+
+/**
+ * Compute the local values of the measure for a time series, relative to
+ * the observations accumulated so far.
+ *
+ * The time series is laid out as for inform_acc_accumulate, but is treated
+ * as a time series in its own right; in particular, it is unaffected by the
+ * chunks which have been accumulated. One local value is computed for each
+ * observation that fits within the series. Observations which were never
+ * accumulated have infinite or undefined local values.
+ *
+ * @param[in] acc    the accumulator
+ * @param[in] series the time series
+ * @param[in] m      the number of time steps in the time series
+ * @param[out] local the local values, or NULL to allocate them
+ * @param[out] err   an error structure
+ * @return a pointer to the local values
+ */
+EXPORT double *inform_acc_local(inform_acc const *acc, int const *series,
+    size_t m, double *local, inform_error *err);
+
+/**
+ * A sink for the local values of a measure, e.g. a file, to which
+ * inform_acc_read_local pushes one chunk at a time
+ *
+ * The writer receives the next `n` local values, in order. If it fails, it
+ * should set `err`.
+ *
+ * @param[in,out] arg the writer's state
+ * @param[in] local   the local values
+ * @param[in] n       the number of local values
+ * @param[out] err    an error structure
+ */
+typedef void (*inform_writer)(void *arg, double const *local, size_t n,
+    inform_error *err);
+
+/**
+ * Compute the local values of the measure for every chunk pulled from a
+ * reader, relative to the observations accumulated so far, and push them to
+ * a writer.
+ *
+ * This is the second pass over a time series too long to hold in memory:
+ * the first accumulates it with inform_acc_read, and the second re-reads it
+ * from the start. The chunks are treated as a single time series in their
+ * own right, as for inform_acc_local, so the local values written are
+ * exactly those inform_acc_local would compute for their concatenation.
+ * Only a buffer of `chunk` time steps of each stream and `chunk` local values
+ * are ever held in memory besides the histograms. If a chunk is invalid, or
+ * the reader or writer fails, reading stops; the local values before it
+ * have been written.
+ *
+ * @param[in] acc         the accumulator
+ * @param[in] read        the reader
+ * @param[in,out] arg     the reader's state
+ * @param[in] chunk       the most time steps to pull at once
+ * @param[in] write       the writer
+ * @param[in,out] write_arg the writer's state
+ * @param[out] err        an error structure
+ * @return true if an error occurred
+ */
+EXPORT bool inform_acc_read_local(inform_acc const *acc, inform_reader read,
+    void *arg, size_t chunk, inform_writer write, void *write_arg,
+    inform_error *err);
+
+/**
+ * Serialize an accumulator into a buffer.
+ *
+ * The record holds the measure, its parameters, the histograms and the
+ * unfinished history of the current time series, so that accumulation can
+ * be resumed exactly where it left off. If the buffer is NULL or too small,
+ * nothing is written, but the required size is still returned.
+ *
+ * @param[in] acc     the accumulator
+ * @param[out] buffer the buffer, or NULL
+ * @param[in] n       the size of the buffer
+ * @param[out] err    an error structure
+ * @return the size of the record, or 0 on error
+ */
+EXPORT size_t inform_acc_serialize(inform_acc const *acc, uint8_t *buffer,
+    size_t n, inform_error *err);
+
+/**
+ * Deserialize an accumulator from a buffer.
+ *
+ * The buffer is only read sequentially, and need not be aligned, so it may
+ * point directly into a memory-mapped file. Since records are
+ * self-delimiting, several may be stored one after another.
+ *
+ * @param[in] buffer the buffer
+ * @param[in] n      the size of the buffer
+ * @param[out] used  the size of the record read, or NULL
+ * @param[out] err   an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_acc_deserialize(uint8_t const *buffer, size_t n,
+    size_t *used, inform_error *err);
+
+/**
+ * Save an accumulator to a file, replacing its contents.
+ *
+ * @param[in] acc  the accumulator
+ * @param[in] path the path of the file
+ * @param[out] err an error structure
+ * @return true if an error occurred
+ */
+EXPORT bool inform_acc_save(inform_acc const *acc, char const *path,
+    inform_error *err);
+
+/**
+ * Load an accumulator saved with inform_acc_save.
+ *
+ * @param[in] path the path of the file
+ * @param[out] err an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_acc_load(char const *path, inform_error *err);
+
+/**
+ * Free an accumulator.
+ *
+ * @param[in] acc the accumulator
+ */
+EXPORT void inform_acc_free(inform_acc *acc);
+
+#ifdef __cplusplus
+}
+#endif
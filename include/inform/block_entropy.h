@@ -3,7 +3,10 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/local_summary.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +27,19 @@ extern "C"
 EXPORT double inform_block_entropy(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err);
 
+/**
+ * Compute the block entropy of a validated ensemble of time series
+ *
+ * The series are not scanned again.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the block size
+ * @param[out] err   an error structure
+ * @return the block entropy for the ensemble
+ */
+EXPORT double inform_block_entropy_series(inform_series const *series, size_t k,
+    inform_error *err);
+
 /**
  * Compute the local block entropy of a ensemble of time series
  *
@@ -39,6 +55,102 @@ EXPORT double inform_block_entropy(int const *series, size_t n, size_t m, int b,
 EXPORT double *inform_local_block_entropy(int const *series, size_t n, size_t m,
     int b, size_t k, double *ent, inform_error *err);
 
+/**
+ * Compute the local block entropy of a validated ensemble of time series
+ *
+ * See inform_block_entropy_series.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] be    the local block entropy, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local block entropy array
+ */
+EXPORT double *inform_local_block_entropy_series(inform_series const *series,
+    size_t k, double *be, inform_error *err);
+
+/**
+ * Compute the local block entropy of an ensemble of time series in single
+ * precision
+ *
+ * See inform_local_block_entropy.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the block size
+ * @param[out] be    the local block entropy, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local block entropy array
+ */
+EXPORT float *inform_local_block_entropy_float(int const *series, size_t n,
+    size_t m, int b, size_t k, float *be, inform_error *err);
+
+/**
+ * Compute the local block entropy of a validated ensemble of time series in
+ * single precision
+ *
+ * See inform_block_entropy_series.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] be    the local block entropy, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local block entropy array
+ */
+EXPORT float *inform_local_block_entropy_float_series(
+    inform_series const *series, size_t k, float *be, inform_error *err);
+
+/**
+ * Summarize the local block entropy of an ensemble of time series without
+ * storing it
+ *
+ * Each local value is added to the summary as it is computed; see
+ * inform_local_summary.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the block size
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err   an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_block_entropy_summary(
+    int const *series, size_t n, size_t m, int b, size_t k,
+    inform_local_summary *summary, inform_error *err);
+
+/**
+ * Summarize the local block entropy of a validated ensemble of time series
+ * without storing it
+ *
+ * See inform_block_entropy_series and inform_local_block_entropy_summary.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err   an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_block_entropy_summary_series(
+    inform_series const *series, size_t k, inform_local_summary *summary,
+    inform_error *err);
+
+/**
+ * Create an accumulator of the block entropy of a time series
+ *
+ * Each chunk accumulated is a single time series of `m` time steps. See
+ * inform_acc for how the accumulator is used.
+ *
+ * @param[in] b    the base or number of distinct states at each time step
+ * @param[in] k    the block size
+ * @param[out] err an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_block_entropy_acc(int b, size_t k, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -17,6 +19,16 @@ extern "C"
 EXPORT double inform_conditional_entropy(int const *xs, int const *ys,
     size_t n, int bx, int by, inform_error *err);
 
+/**
+ * Compute the conditional entropy between two validated ensembles of time
+ * series, each treated as a single sequence of observations, using the first
+ * as the condition. The series are not scanned again; the handles must have
+ * the same number of observations, though not necessarily the same shape or
+ * base.
+ */
+EXPORT double inform_conditional_entropy_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err);
+
 /**
  * Compute the local conditional entropy between two timeseries, using the
  * first as the condition.
@@ -24,6 +36,22 @@ EXPORT double inform_conditional_entropy(int const *xs, int const *ys,
 EXPORT double *inform_local_conditional_entropy(int const *xs, int const *ys,
     size_t n, int bx, int by, double *mi, inform_error *err);
 
+/**
+ * Compute the local conditional entropy between two validated ensembles of
+ * time series, using the first as the condition; see
+ * inform_conditional_entropy_series.
+ */
+EXPORT double *inform_local_conditional_entropy_series(inform_series const *xs,
+    inform_series const *ys, double *ce, inform_error *err);
+
+/**
+ * Create an accumulator of the conditional entropy between two timeseries,
+ * using the first as the condition. Each chunk accumulated holds `m` time
+ * steps of the first time series followed by `m` time steps of the second.
+ */
+EXPORT inform_acc *inform_conditional_entropy_acc(int bx, int by,
+    inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +25,21 @@ extern "C"
 EXPORT double inform_cross_entropy(int const *ps, int const *qs, size_t n,
     int b, inform_error *err);
 
+/**
+ * Compute the cross entropy between two validated ensembles of time series,
+ * each treated as a single sequence of samples.
+ *
+ * The series are not scanned again. The handles must have the same number of
+ * observations, and the larger of their bases is used.
+ *
+ * @param[in] ps      the handle of the "true" time series
+ * @param[in] qs      the handle of the "unnatural" time series
+ * @param[in,out] err the error structure
+ * @return the cross entropy between the time series
+ */
+EXPORT double inform_cross_entropy_series(inform_series const *ps,
+    inform_series const *qs, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
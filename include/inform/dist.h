@@ -288,6 +288,123 @@ EXPORT size_t inform_dist_dump(inform_dist const *dist, double *probs, size_t n)
  */
 EXPORT size_t inform_dist_accumulate(inform_dist *dist, int const *events,
     size_t n);
+/**
+ * Add the observations of one distribution to another.
+ *
+ * This is the reduction step of map-reduce style aggregation: partial
+ * distributions accumulated over disjoint pieces of a data set merge into
+ * exactly the distribution that would have been accumulated over the whole.
+ *
+ * If either distribution is `NULL`, the supports differ, or an event's count
+ * would overflow, the destination is left untouched and `NULL` is returned.
+ *
+ * @param[in] src      the distribution whose observations are added
+ * @param[in,out] dest the distribution to add to
+ * @return the destination
+ */
+EXPORT inform_dist* inform_dist_merge(inform_dist const *src,
+    inform_dist *dest);
+/**
+ * Remove the observations of one distribution from another.
+ *
+ * This undoes inform_dist_merge, e.g. to drop a shard's contribution or to
+ * slide a window across a data set.
+ *
+ * If either distribution is `NULL`, the supports differ, or any event was
+ * observed more often in the source than in the destination, the destination
+ * is left untouched and `NULL` is returned.
+ *
+ * @param[in] src      the distribution whose observations are removed
+ * @param[in,out] dest the distribution to remove them from
+ * @return the destination
+ */
+EXPORT inform_dist* inform_dist_subtract(inform_dist const *src,
+    inform_dist *dest);
+/**
+ * Accumulate observations from a series into a collection of partial
+ * distributions.
+ *
+ * The series is split into `k` contiguous pieces, the `i`-th of which is
+ * accumulated into `parts[i]`. When more than one thread is allowed (see
+ * inform_set_num_threads), the pieces are accumulated concurrently.
+ *
+ * As with inform_dist_accumulate, only the events preceding the first
+ * invalid event are observed. If any of the parts is `NULL`, or the parts
+ * have differing supports, no events are observed.
+ *
+ * @param[in] events    the events to observe
+ * @param[in] n         the number of events provided
+ * @param[in,out] parts the partial distributions
+ * @param[in] k         the number of partial distributions
+ * @return the number of valid observations
+ */
+EXPORT size_t inform_dist_scatter(int const *events, size_t n,
+    inform_dist **parts, size_t k);
+
+/**
+ * Add the observations of a collection of partial distributions to a
+ * destination.
+ *
+ * Either every part is added or, if any of the parts is `NULL`, has a
+ * different support from the destination, or a count would overflow, none
+ * are; in the latter case `NULL` is returned.
+ *
+ * @param[in] parts    the partial distributions
+ * @param[in] k        the number of partial distributions
+ * @param[in,out] dest the distribution to add to
+ * @return the destination
+ */
+EXPORT inform_dist* inform_dist_gather(inform_dist * const *parts, size_t k,
+    inform_dist *dest);
+
+/**
+ * Serialize a distribution into a buffer.
+ *
+ * The record is a fixed eight-byte header followed by the counts as
+ * variable-length integers, written either densely or as a gap-coded list
+ * of the non-zero counts, whichever is smaller. If the buffer is `NULL` or
+ * too small, nothing is written, but the required size is still returned.
+ *
+ * @param[in] dist    the distribution
+ * @param[out] buffer the buffer, or `NULL`
+ * @param[in] n       the size of the buffer
+ * @return the size of the record, or 0 if the distribution is `NULL`
+ */
+EXPORT size_t inform_dist_serialize(inform_dist const *dist, uint8_t *buffer,
+    size_t n);
+
+/**
+ * Deserialize a distribution from a buffer.
+ *
+ * The buffer is only read sequentially, and need not be aligned, so it may
+ * point directly into a memory-mapped file. Since records are
+ * self-delimiting, several may be stored one after another.
+ *
+ * @param[in] buffer the buffer
+ * @param[in] n      the size of the buffer
+ * @param[out] used  the size of the record read, or `NULL`
+ * @return the distribution, or `NULL` if the record is malformed or memory
+ *         could not be allocated
+ */
+EXPORT inform_dist* inform_dist_deserialize(uint8_t const *buffer, size_t n,
+    size_t *used);
+
+/**
+ * Save a distribution to a file, replacing its contents.
+ *
+ * @param[in] dist the distribution
+ * @param[in] path the path of the file
+ * @return the number of bytes written, or 0 on failure
+ */
+EXPORT size_t inform_dist_save(inform_dist const *dist, char const *path);
+
+/**
+ * Load a distribution saved with inform_dist_save.
+ *
+ * @param[in] path the path of the file
+ * @return the distribution, or `NULL` on failure
+ */
+EXPORT inform_dist* inform_dist_load(char const *path);
 
 #ifdef __cplusplus
 }
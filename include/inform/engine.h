@@ -0,0 +1,83 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/export.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The strategies available for counting the observations made by the time
+ * series measures
+ */
+typedef enum
+{
+    /// choose an engine based on the size of the support and the data
+    INFORM_ENGINE_AUTO   = 0,
+    /// count observations into dense histograms
+    INFORM_ENGINE_DENSE  = 1,
+    /// count observations into hash-backed sparse histograms
+    INFORM_ENGINE_SPARSE = 2,
+    /// radix-sort the encoded observations and count the runs
+    INFORM_ENGINE_SORT   = 3,
+} inform_engine;
+
+/**
+ * Select the counting engine used by subsequent calls made from the calling
+ * thread.
+ *
+ * The engine only affects how the observations are counted, never the value
+ * computed. Dense histograms are fastest when the support is small, while
+ * the sorting engine costs @f O(N) @f time and memory regardless of the size
+ * of the support. The sorting engine only applies to the average (global)
+ * measures; local measures fall back to histograms.
+ *
+ * Invalid engines are ignored.
+ *
+ * @param[in] engine the engine to use
+ */
+EXPORT void inform_set_engine(inform_engine engine);
+
+/**
+ * Get the counting engine used by calls made from the calling thread.
+ *
+ * @return the current engine
+ */
+EXPORT inform_engine inform_get_engine(void);
+
+/**
+ * Set the maximum number of threads used by subsequent calls made from the
+ * calling thread.
+ *
+ * By default every call runs entirely on the calling thread. With more than
+ * one thread, large batches of observations are split across worker threads,
+ * each of which counts into a private histogram, and the histograms are
+ * summed once the workers finish. The time series measures divide their
+ * initial conditions among the workers or, if there are fewer initial
+ * conditions than workers, split each time series into blocks which overlap
+ * by a history length. If summing their histograms would overflow a count,
+ * the measure fails with INFORM_FAILURE. Small inputs are always counted on
+ * the calling thread since starting a thread would cost more than it saves.
+ *
+ * A value of 0 is ignored.
+ *
+ * @param[in] n the maximum number of threads
+ */
+EXPORT void inform_set_num_threads(size_t n);
+
+/**
+ * Get the maximum number of threads used by calls made from the calling
+ * thread.
+ *
+ * @return the maximum number of threads
+ */
+EXPORT size_t inform_get_num_threads(void);
+
+#ifdef __cplusplus
+}
+#endif
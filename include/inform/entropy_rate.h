@@ -3,7 +3,10 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/local_summary.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +27,20 @@ extern "C"
 EXPORT double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err);
 
+/**
+ * Compute the entropy rate of a validated ensemble of time series
+ *
+ * The series are not scanned again, and their encoded histories are used if
+ * they have length `k`.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length used to calculate the entropy rate
+ * @param[out] err   an error structure
+ * @return the entropy rate for the ensemble
+ */
+EXPORT double inform_entropy_rate_series(inform_series const *series, size_t k,
+    inform_error *err);
+
 /**
  * Compute the local entropy rate of an ensemble of time series
  *
@@ -39,6 +56,153 @@ EXPORT double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
 EXPORT double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
     size_t k, double *er, inform_error *err);
 
+/**
+ * Compute the local entropy rate of a validated ensemble of time series
+ *
+ * See inform_entropy_rate_series.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] er    the local entropy rate, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local entropy rate array
+ */
+EXPORT double *inform_local_entropy_rate_series(inform_series const *series,
+    size_t k, double *er, inform_error *err);
+
+/**
+ * Compute the local entropy rate of an ensemble of time series in single
+ * precision
+ *
+ * See inform_local_entropy_rate.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[out] er    the local entropy rate, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local entropy rate array
+ */
+EXPORT float *inform_local_entropy_rate_float(int const *series, size_t n,
+    size_t m, int b, size_t k, float *er, inform_error *err);
+
+/**
+ * Compute the local entropy rate of a validated ensemble of time series in
+ * single precision
+ *
+ * See inform_entropy_rate_series.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] er    the local entropy rate, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local entropy rate array
+ */
+EXPORT float *inform_local_entropy_rate_float_series(
+    inform_series const *series, size_t k, float *er, inform_error *err);
+
+/**
+ * Summarize the local entropy rate of an ensemble of time series without
+ * storing it
+ *
+ * Each local value is added to the summary as it is computed; see
+ * inform_local_summary.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err   an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_entropy_rate_summary(
+    int const *series, size_t n, size_t m, int b, size_t k,
+    inform_local_summary *summary, inform_error *err);
+
+/**
+ * Summarize the local entropy rate of a validated ensemble of time series
+ * without storing it
+ *
+ * See inform_entropy_rate_series and inform_local_entropy_rate_summary.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err   an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_entropy_rate_summary_series(
+    inform_series const *series, size_t k, inform_local_summary *summary,
+    inform_error *err);
+
+/**
+ * Compute the entropy rate of an ensemble of time series at every history
+ * length from 1 to `kmax`
+ *
+ * The series are scanned once, at the longest history length, and the
+ * histograms of every shorter history length are derived from those counts,
+ * so the whole curve costs little more than a single call to
+ * inform_entropy_rate. The value for history length `k` is stored at
+ * `er[k - 1]`.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] kmax   the longest history length
+ * @param[out] er    the entropy rate at each history length, or NULL to
+ *                   allocate them
+ * @param[out] err   an error structure
+ * @return a pointer to the entropy rate at each history length
+ */
+EXPORT double *inform_entropy_rate_sweep(int const *series, size_t n, size_t m,
+    int b, size_t kmax, double *er, inform_error *err);
+
+/**
+ * Compute the entropy rate of an ensemble of time series over a sliding
+ * window
+ *
+ * The window spans `window` time steps of every initial condition and
+ * advances `stride` time steps at a time, so there are
+ * `(m - window) / stride + 1` windows. Each window after the first removes
+ * the observations which fell off its trailing edge and adds those which
+ * entered at its leading edge, keeping running sums over its histograms, so
+ * its cost is proportional to `stride` rather than `window`. The value for
+ * the window starting at time step `i * stride` is stored at `er[i]`.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[in] window the number of time steps in each window, greater than `k`
+ * @param[in] stride the number of time steps between windows
+ * @param[out] er    the entropy rate of each window, or NULL to allocate
+ *                   them
+ * @param[out] err   an error structure
+ * @return a pointer to the entropy rate of each window
+ */
+EXPORT double *inform_entropy_rate_windowed(int const *series, size_t n,
+    size_t m, int b, size_t k, size_t window, size_t stride, double *er,
+    inform_error *err);
+
+/**
+ * Create an accumulator of the entropy rate of a time series
+ *
+ * Each chunk accumulated is a single time series of `m` time steps. See
+ * inform_acc for how the accumulator is used.
+ *
+ * @param[in] b    the base or number of distinct states at each time step
+ * @param[in] k    the history length used to calculate the entropy rate
+ * @param[out] err an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_entropy_rate_acc(int b, size_t k, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
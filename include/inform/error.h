@@ -38,6 +38,8 @@ typedef enum
     INFORM_ETPMROW      = 17, /// all zero row in transition probability matrix
     INFORM_ESIZE        = 18, /// invalid size,
     INFORM_EPARTS       = 19, /// invalid partitioning
+    INFORM_EFORMAT      = 20, /// malformed serialized data
+    INFORM_EIO          = 21, /// file could not be read or written
 } inform_error;
 
 /// set an error as pointed to by ERR
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +26,19 @@ extern "C"
 EXPORT double inform_excess_entropy(int const *series, size_t n, size_t m,
     int b, size_t k, inform_error *err);
 
+/**
+ * Compute the excess entropy of a validated ensemble of time series
+ *
+ * The series are not scanned again.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] err   an error structure
+ * @return the excess entropy for the ensemble
+ */
+EXPORT double inform_excess_entropy_series(inform_series const *series,
+    size_t k, inform_error *err);
+
 /**
  * Compute the local excess entropy of a ensemble of time series
  *
@@ -39,6 +54,34 @@ EXPORT double inform_excess_entropy(int const *series, size_t n, size_t m,
 EXPORT double *inform_local_excess_entropy(int const *series, size_t n,
     size_t m, int b, size_t k, double *ee, inform_error *err);
 
+/**
+ * Compute the local excess entropy of a validated ensemble of time series
+ *
+ * See inform_excess_entropy_series.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] k      the history length
+ * @param[out] ee    the local excess entropy, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local excess entropy array
+ */
+EXPORT double *inform_local_excess_entropy_series(inform_series const *series,
+    size_t k, double *ee, inform_error *err);
+
+/**
+ * Create an accumulator of the excess entropy of a time series
+ *
+ * Each chunk accumulated is a single time series of `m` time steps. See
+ * inform_acc for how the accumulator is used.
+ *
+ * @param[in] b    the base or number of distinct states at each time step
+ * @param[in] k    the history length
+ * @param[out] err an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_excess_entropy_acc(int b, size_t k,
+    inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
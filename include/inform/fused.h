@@ -0,0 +1,85 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <inform/series.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The measures of a single time series which can be computed together by
+ * inform_fused_measures
+ */
+typedef enum inform_fused_measure
+{
+    INFORM_FUSED_ACTIVE_INFO,      ///< inform_active_info
+    INFORM_FUSED_BLOCK_ENTROPY,    ///< inform_block_entropy
+    INFORM_FUSED_ENTROPY_RATE,     ///< inform_entropy_rate
+    INFORM_FUSED_EXCESS_ENTROPY,   ///< inform_excess_entropy
+    INFORM_FUSED_PREDICTIVE_INFO,  ///< inform_predictive_info
+} inform_fused_measure;
+
+/**
+ * A request for one measure from inform_fused_measures
+ */
+typedef struct inform_fused_spec
+{
+    /// the measure to compute
+    inform_fused_measure measure;
+    /// the history length, or the past length of the predictive information
+    size_t k;
+    /// the future length of the predictive information, ignored otherwise
+    size_t kfuture;
+} inform_fused_spec;
+
+/**
+ * Compute several measures of the same ensemble of time series at once
+ *
+ * The series are validated once, and every length-`w` block is encoded and
+ * counted once, where `w` is the longest block any of the measures needs.
+ * The histograms of each measure, e.g. of the histories and futures of the
+ * active information, are then derived from those counts rather than
+ * recounted from the series. Each value is the same as would be computed by
+ * the corresponding function, e.g. inform_active_info.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] specs  the measures to compute
+ * @param[in] count  the number of measures
+ * @param[out] values the value of each measure, or NULL to allocate them
+ * @param[out] err   an error structure
+ * @return a pointer to the values
+ */
+EXPORT double *inform_fused_measures(int const *series, size_t n, size_t m,
+    int b, inform_fused_spec const *specs, size_t count, double *values,
+    inform_error *err);
+
+/**
+ * Compute several measures of the same validated ensemble of time series at
+ * once, without scanning the series again
+ *
+ * See inform_fused_measures.
+ *
+ * @param[in] series the handle of the ensemble of time series
+ * @param[in] specs  the measures to compute
+ * @param[in] count  the number of measures
+ * @param[out] values the value of each measure, or NULL to allocate them
+ * @param[out] err   an error structure
+ * @return a pointer to the values
+ */
+EXPORT double *inform_fused_measures_series(inform_series const *series,
+    inform_fused_spec const *specs, size_t count, double *values,
+    inform_error *err);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,8 +4,14 @@
 #pragma once
 
 #include <inform/dist.h>
+#include <inform/sparse_dist.h>
+#include <inform/window_dist.h>
+#include <inform/engine.h>
 #include <inform/error.h>
 #include <inform/utilities.h>
+#include <inform/accumulator.h>
+#include <inform/local_summary.h>
+#include <inform/series.h>
 
 #include <inform/shannon.h>
 
@@ -14,4 +20,6 @@
 #include <inform/block_entropy.h>
 #include <inform/active_info.h>
 #include <inform/entropy_rate.h>
-#include <inform/transfer_entropy.h>
\ No newline at end of file
+#include <inform/transfer_entropy.h>
+#include <inform/fused.h>
+#include <inform/significance.h>
\ No newline at end of file
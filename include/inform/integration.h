@@ -17,6 +17,9 @@ extern "C"
  * The first and second halves of the returned array contain the minimum and
  * maximum evidence, respectively.
  *
+ * The local surprisal of each block of variables is computed once and shared
+ * by every partitioning in which the block appears.
+ *
  * @param[in] series    the time series
  * @param[in] l         the number of time series
  * @param[in] n         the number of time steps per time series
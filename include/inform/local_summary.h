@@ -0,0 +1,114 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Summary statistics of the local values of a measure
+ *
+ * The `_summary` variants of the local measures, e.g.
+ * inform_local_active_info_summary, stream each local value into a summary
+ * rather than storing it, so that the mean, variance, extrema and an
+ * approximate distribution of the local values can be had without
+ * allocating an array of one value per observation.
+ *
+ * Values are added to whatever the summary already holds, so one summary can
+ * gather the local values of several calls; see inform_local_summary_clear.
+ */
+typedef struct inform_local_summary
+{
+    /// the number of values summarized
+    size_t count;
+    /// the mean of the values
+    double mean;
+    /// the sum of the squared deviations of the values from their mean
+    double m2;
+    /// the smallest value
+    double min;
+    /// the largest value
+    double max;
+    /// the number of bins in the histogram, or 0 if there is none
+    size_t bins;
+    /// the lower bound of the histogram's range
+    double lo;
+    /// the upper bound of the histogram's range
+    double hi;
+    /// the number of values in each of the equal-width bins spanning
+    /// [lo, hi); values outside of the range are counted in the first or
+    /// last bin
+    uint64_t *histogram;
+} inform_local_summary;
+
+/**
+ * Allocate an empty summary of local values.
+ *
+ * @param[in] bins the number of histogram bins, or 0 to keep no histogram
+ * @param[in] lo   the lower bound of the histogram's range
+ * @param[in] hi   the upper bound of the histogram's range
+ * @param[out] err an error structure
+ * @return the summary, or NULL if `bins` is nonzero and `lo < hi` does not
+ *         hold
+ */
+EXPORT inform_local_summary *inform_local_summary_alloc(size_t bins,
+    double lo, double hi, inform_error *err);
+
+/**
+ * Free a summary along with its histogram.
+ *
+ * @param[in] summary the summary to free
+ */
+EXPORT void inform_local_summary_free(inform_local_summary *summary);
+
+/**
+ * Empty a summary, keeping its histogram's bins and range.
+ *
+ * @param[in,out] summary the summary
+ */
+EXPORT void inform_local_summary_clear(inform_local_summary *summary);
+
+/**
+ * Add a value to a summary.
+ *
+ * @param[in,out] summary the summary
+ * @param[in] value       the value
+ */
+EXPORT void inform_local_summary_add(inform_local_summary *summary,
+    double value);
+
+/**
+ * Get the (population) variance of the values in a summary.
+ *
+ * @param[in] summary the summary
+ * @return the variance, or NaN if the summary is empty
+ */
+EXPORT double inform_local_summary_variance(
+    inform_local_summary const *summary);
+
+/**
+ * Estimate a quantile of the values in a summary from its histogram.
+ *
+ * The estimate interpolates linearly within the bin containing the quantile,
+ * so it is accurate to within a bin's width, and is clamped to the smallest
+ * and largest values.
+ *
+ * @param[in] summary the summary
+ * @param[in] p       the probability, in [0, 1]
+ * @return the estimated quantile, or NaN if the summary is empty, has no
+ *         histogram or `p` is out of range
+ */
+EXPORT double inform_local_summary_quantile(
+    inform_local_summary const *summary, double p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -23,6 +25,21 @@ extern "C"
 EXPORT double inform_mutual_info(int const *series, size_t l, size_t n,
     int const *b, inform_error *err);
 
+/**
+ * Compute the mutual information between two validated ensembles of time
+ * series, each treated as a single sequence of observations
+ *
+ * The series are not scanned again. The handles must have the same number of
+ * observations, though not necessarily the same shape or base.
+ *
+ * @param[in] xs  the handle of the first ensemble
+ * @param[in] ys  the handle of the second ensemble
+ * @param[in] err an error code
+ * @return the mutual information between the ensembles
+ */
+EXPORT double inform_mutual_info_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err);
+
 /**
  * Compute the pointwise mutual information between time series
  *
@@ -37,6 +54,36 @@ EXPORT double inform_mutual_info(int const *series, size_t l, size_t n,
 EXPORT double *inform_local_mutual_info(int const *series, size_t l, size_t n,
     int const *b, double *mi, inform_error *err);
 
+/**
+ * Compute the pointwise mutual information between two validated ensembles
+ * of time series
+ *
+ * See inform_mutual_info_series.
+ *
+ * @param[in] xs   the handle of the first ensemble
+ * @param[in] ys   the handle of the second ensemble
+ * @param[out] mi  the pointwise mutual information, or NULL to allocate it
+ * @param[in] err  an error code
+ * @return the pointwise mutual information between the ensembles
+ */
+EXPORT double *inform_local_mutual_info_series(inform_series const *xs,
+    inform_series const *ys, double *mi, inform_error *err);
+
+/**
+ * Create an accumulator of the mutual information between time series
+ *
+ * Each chunk accumulated holds `m` time steps of each of the `l` time
+ * series, one after the other. See inform_acc for how the accumulator is
+ * used.
+ *
+ * @param[in] l    the number of time series
+ * @param[in] b    the base of each time series
+ * @param[out] err an error code
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_mutual_info_acc(size_t l, int const *b,
+    inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -25,6 +27,20 @@ extern "C"
 EXPORT double inform_predictive_info(int const *series, size_t n, size_t m,
     int b, size_t kpast, size_t kfuture, inform_error *err);
 
+/**
+ * Compute the predictive information of a validated ensemble of time series
+ *
+ * The series are not scanned again.
+ *
+ * @param[in] series  the handle of the ensemble of time series
+ * @param[in] kpast   the history length
+ * @param[in] kfuture the future length
+ * @param[out] err    an error structure
+ * @return the predictive information for the ensemble
+ */
+EXPORT double inform_predictive_info_series(inform_series const *series,
+    size_t kpast, size_t kfuture, inform_error *err);
+
 /**
  * Compute the local predictive information of a ensemble of time series
  *
@@ -42,6 +58,38 @@ EXPORT double *inform_local_predictive_info(int const *series, size_t n,
     size_t m, int b, size_t kpast, size_t kfuture, double *pi,
     inform_error *err);
 
+/**
+ * Compute the local predictive information of a validated ensemble of time
+ * series
+ *
+ * See inform_predictive_info_series.
+ *
+ * @param[in] series  the handle of the ensemble of time series
+ * @param[in] kpast   the history length
+ * @param[in] kfuture the future length
+ * @param[out] pi     the local predictive information, or NULL to allocate it
+ * @param[out] err    an error structure
+ * @return a pointer to the local predictive information array
+ */
+EXPORT double *inform_local_predictive_info_series(
+    inform_series const *series, size_t kpast, size_t kfuture, double *pi,
+    inform_error *err);
+
+/**
+ * Create an accumulator of the predictive information of a time series
+ *
+ * Each chunk accumulated is a single time series of `m` time steps. See
+ * inform_acc for how the accumulator is used.
+ *
+ * @param[in] b       the base or number of distinct states at each time step
+ * @param[in] kpast   the history length
+ * @param[in] kfuture the future length
+ * @param[out] err    an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_predictive_info_acc(int b, size_t kpast,
+    size_t kfuture, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
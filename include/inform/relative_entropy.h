@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -17,6 +18,15 @@ extern "C"
 EXPORT double inform_relative_entropy(int const *xs, int const *ys, size_t n,
     int b, inform_error *err);
 
+/**
+ * Compute the relative entropy between two validated ensembles of time
+ * series, each treated as a single sequence of samples. The series are not
+ * scanned again; the handles must have the same number of observations, and
+ * the larger of their bases is used.
+ */
+EXPORT double inform_relative_entropy_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err);
+
 /**
  * Compute the pointwise relative entropy between two timeseries, each
  * considered as a timeseries of samples from two distributions.
@@ -24,6 +34,13 @@ EXPORT double inform_relative_entropy(int const *xs, int const *ys, size_t n,
 EXPORT double *inform_local_relative_entropy(int const *xs, int const *ys,
     size_t n, int b, double *re, inform_error *err);
 
+/**
+ * Compute the pointwise relative entropy between two validated ensembles of
+ * time series; see inform_relative_entropy_series.
+ */
+EXPORT double *inform_local_relative_entropy_series(inform_series const *xs,
+    inform_series const *ys, double *re, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -26,6 +27,24 @@ extern "C"
 EXPORT double inform_separable_info(int const *srcs, int const *dest, size_t l,
     size_t n, size_t m, int b, size_t k, inform_error *err);
 
+/**
+ * Compute the separable information into a node from a set of sources, all
+ * validated
+ *
+ * The series are not scanned again. The sources are stacked as the initial
+ * conditions of a single handle, i.e. it holds `l * n` initial conditions of
+ * the same `m` time steps as the destination. See
+ * inform_active_info_series and inform_transfer_entropy_series.
+ *
+ * @param[in] srcs the handle of the ensembles of the source nodes
+ * @param[in] dest the handle of the ensemble of the target node
+ * @param[in] k    the history length
+ * @param[out] err an error structure
+ * @return the separable information of the ensemble
+ */
+EXPORT double inform_separable_info_series(inform_series const *srcs,
+    inform_series const *dest, size_t k, inform_error *err);
+
 /**
  * Compute the local separable information into a node from a set of sources
  *
@@ -44,6 +63,22 @@ EXPORT double *inform_local_separable_info(int const *srcs, int const *dest,
     size_t l, size_t n, size_t m, int b, size_t k, double *si,
     inform_error *err);
 
+/**
+ * Compute the local separable information into a node from a set of
+ * sources, all validated
+ *
+ * See inform_separable_info_series.
+ *
+ * @param[in] srcs the handle of the ensembles of the source nodes
+ * @param[in] dest the handle of the ensemble of the target node
+ * @param[in] k    the history length
+ * @param[out] si  the separable information array, or NULL to allocate it
+ * @param[out] err an error structure
+ * @return a pointer to the separable information array
+ */
+EXPORT double *inform_local_separable_info_series(inform_series const *srcs,
+    inform_series const *dest, size_t k, double *si, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,91 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * An ensemble of time series which has been validated once
+ *
+ * Every measure scans its time series for negative or out-of-base states
+ * before it counts them, a pass which can cost as much as the measure
+ * itself. A handle performs that scan once, when it is allocated, and the
+ * `_series` variants of the measures, e.g. inform_active_info_series, accept
+ * the handle in place of the series without scanning it again. The active
+ * information, block entropy, conditional, cross and relative entropy,
+ * entropy rate, excess entropy, mutual information, predictive information,
+ * separable information, transfer entropy and fused measures, and each of
+ * their local forms, have such variants.
+ *
+ * The handle borrows the series, which must outlive it and must not be
+ * modified while it is in use. The handle may also hold the encoded
+ * length-`k` histories of the series (see inform_series_encode), which the
+ * measures with history length `k` then use rather than encoding their own.
+ */
+typedef struct inform_series
+{
+    /// the ensemble of time series, borrowed from the caller
+    int const *data;
+    /// the number of initial conditions
+    size_t n;
+    /// the number of time steps in each time series
+    size_t m;
+    /// the base of the time series
+    int b;
+    /// the largest state observed in the time series
+    int max_state;
+    /// the length of the encoded histories, or 0 if there are none
+    size_t k;
+    /// the n * (m - k) histories preceding each time step after the first k
+    /// of each time series, or NULL
+    uint64_t *histories;
+} inform_series;
+
+/**
+ * Validate an ensemble of time series and wrap it in a handle.
+ *
+ * The series are scanned once, in full, for states outside of [0, b).
+ *
+ * @param[in] data  the ensemble of time series
+ * @param[in] n     the number of initial conditions
+ * @param[in] m     the number of time steps in each time series
+ * @param[in] b     the base of the time series
+ * @param[out] err  an error structure
+ * @return the handle, or NULL if the series are invalid
+ */
+EXPORT inform_series *inform_series_alloc(int const *data, size_t n, size_t m,
+    int b, inform_error *err);
+
+/**
+ * Encode and store the length-`k` histories of a handle's time series,
+ * replacing any histories encoded before.
+ *
+ * @param[in,out] series the handle
+ * @param[in] k          the history length
+ * @param[out] err       an error structure
+ * @return true if the histories could not be encoded
+ */
+EXPORT bool inform_series_encode(inform_series *series, size_t k,
+    inform_error *err);
+
+/**
+ * Free a handle along with its encoded histories, but not the time series
+ * it wraps.
+ *
+ * @param[in] series the handle to free
+ */
+EXPORT void inform_series_free(inform_series *series);
+
+#ifdef __cplusplus
+}
+#endif
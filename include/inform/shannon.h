@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/dist.h>
+#include <inform/sparse_dist.h>
 #include <math.h>
 
 #ifdef __cplusplus
@@ -35,6 +36,19 @@ EXPORT double inform_shannon_si(inform_dist const *dist, size_t event, double ba
  */
 EXPORT double inform_shannon_entropy(inform_dist const *dist, double base);
 
+/**
+ * Compute the Shannon information of a sparse distribution.
+ *
+ * This function will return `NaN` if the distribution is not valid,
+ * i.e. `!inform_sparse_dist_is_valid(dist)`.
+ *
+ * @param[in] dist the sparse probability distribution
+ * @param[in] base the logarithmic base
+ * @return the shannon information
+ */
+EXPORT double inform_shannon_sparse_entropy(inform_sparse_dist const *dist,
+    double base);
+
 /**
  * Compute the pointwise mutual information of an combination of events
  *
@@ -0,0 +1,118 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The ways in which a surrogate of the source of a measure can be drawn
+ */
+typedef enum inform_surrogate_method
+{
+    /// shuffle the source's observations
+    INFORM_SURROGATE_PERMUTE = 0,
+    /// shuffle consecutive blocks of the source's observations, preserving
+    /// its short-range structure
+    INFORM_SURROGATE_BLOCK   = 1,
+    /// rotate the source's observations of each initial condition by a
+    /// random offset, preserving all but the alignment
+    INFORM_SURROGATE_SHIFT   = 2,
+} inform_surrogate_method;
+
+/**
+ * How the null distribution of a measure is to be sampled
+ */
+typedef struct inform_surrogates
+{
+    /// the method used to draw each surrogate
+    inform_surrogate_method method;
+    /// the number of surrogates to draw
+    size_t count;
+    /// the number of observations in each block of INFORM_SURROGATE_BLOCK
+    size_t block;
+    /// the seed of the random number generator
+    uint64_t seed;
+} inform_surrogates;
+
+/**
+ * Test the significance of the transfer entropy from one time series to
+ * another against surrogates in which the source has been resampled.
+ *
+ * Only the source is resampled, so the destination's histories are encoded
+ * and counted once for every surrogate, and the histograms are reused from
+ * one surrogate to the next. The surrogates are divided among up to
+ * inform_get_num_threads() threads, and are the same for a given seed
+ * regardless of the number of threads.
+ *
+ * @param[in] src        the ensemble of the source node
+ * @param[in] dst        the ensemble of the destination node
+ * @param[in] n          the number of initial conditions
+ * @param[in] m          the number of time steps in each time series
+ * @param[in] b          the base or number of distinct states at each time step
+ * @param[in] k          the history length
+ * @param[in] surrogates how the null distribution is sampled
+ * @param[out] null      the measure of each surrogate, or NULL
+ * @param[out] value     the measure of the original series, or NULL
+ * @param[out] err       an error structure
+ * @return the p-value, the proportion of the surrogates, counting the
+ *         original series, at least as large as the original
+ */
+EXPORT double inform_transfer_entropy_significance(int const *src,
+    int const *dst, size_t n, size_t m, int b, size_t k,
+    inform_surrogates const *surrogates, double *null, double *value,
+    inform_error *err);
+
+/**
+ * Test the significance of the active information of a time series against
+ * surrogates in which each history's future has been resampled.
+ *
+ * See inform_transfer_entropy_significance.
+ *
+ * @param[in] series     the ensemble of time series
+ * @param[in] n          the number of initial conditions
+ * @param[in] m          the number of time steps in each time series
+ * @param[in] b          the base or number of distinct states at each time step
+ * @param[in] k          the history length
+ * @param[in] surrogates how the null distribution is sampled
+ * @param[out] null      the measure of each surrogate, or NULL
+ * @param[out] value     the measure of the original series, or NULL
+ * @param[out] err       an error structure
+ * @return the p-value
+ */
+EXPORT double inform_active_info_significance(int const *series, size_t n,
+    size_t m, int b, size_t k, inform_surrogates const *surrogates,
+    double *null, double *value, inform_error *err);
+
+/**
+ * Test the significance of the mutual information between two time series
+ * against surrogates in which the second series has been resampled.
+ *
+ * See inform_transfer_entropy_significance.
+ *
+ * @param[in] xs         the first time series
+ * @param[in] ys         the second time series
+ * @param[in] n          the number of time steps in each time series
+ * @param[in] bx         the base of the first time series
+ * @param[in] by         the base of the second time series
+ * @param[in] surrogates how the null distribution is sampled
+ * @param[out] null      the measure of each surrogate, or NULL
+ * @param[out] value     the measure of the original series, or NULL
+ * @param[out] err       an error structure
+ * @return the p-value
+ */
+EXPORT double inform_mutual_info_significance(int const *xs, int const *ys,
+    size_t n, int bx, int by, inform_surrogates const *surrogates,
+    double *null, double *value, inform_error *err);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/dist.h>
+#include <inform/export.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * A sparse distribution of observed event frequencies
+ *
+ * Where inform_dist stores a frequency for every event in a dense support
+ * @f {0, 1, ..., N-1} @f, this structure only stores the events which have
+ * actually been observed. The events are arbitrary 64-bit integers kept in an
+ * open-addressing hash table, so the memory used scales with the number of
+ * distinct observed events rather than with the size of the support.
+ *
+ * This makes the sparse distribution the natural choice when the support is
+ * astronomically large, e.g. the @f b^{k+1} @f states of a history of length
+ * @f k @f, but only a handful of those states are ever observed.
+ *
+ * The slots of the table can be iterated directly: slot `i` holds an
+ * observed event if and only if `histogram[i] != 0`, in which case the event
+ * is `events[i]`.
+ */
+typedef struct inform_sparse_distribution
+{
+    /// the event stored in each slot of the hash table
+    uint64_t *events;
+    /// the observation frequency of each slot (zero marks an empty slot)
+    uint32_t *histogram;
+    /// the number of slots in the hash table (always a power of two)
+    size_t capacity;
+    /// the number of distinct events with non-zero frequency
+    size_t size;
+    /// the number of observations made so far
+    uint64_t counts;
+} inform_sparse_dist;
+
+/**
+ * Allocate a sparse distribution with room for a number of distinct events.
+ *
+ * The table grows as needed, so `n` is only a hint. A hint of zero is
+ * perfectly acceptable.
+ *
+ * The allocation will fail and return `NULL` if memory cannot be allocated.
+ *
+ * Immediately following allocation, the distribution is invalid.
+ *
+ * @param[in] n the expected number of distinct events
+ * @return the distribution
+ */
+EXPORT inform_sparse_dist *inform_sparse_dist_alloc(size_t n);
+/**
+ * Duplicate a sparse distribution.
+ *
+ * If the allocation fails or the source distribution is `NULL`, then the
+ * return value is `NULL`.
+ *
+ * @param[in] dist the source distribution
+ * @return the new distribution
+ */
+EXPORT inform_sparse_dist *inform_sparse_dist_dup(inform_sparse_dist const *dist);
+/**
+ * Create a sparse distribution from a dense distribution.
+ *
+ * If the source distribution is `NULL` or the allocation fails, `NULL` is
+ * returned.
+ *
+ * @param[in] dist the dense distribution
+ * @return the new sparse distribution
+ */
+EXPORT inform_sparse_dist *inform_sparse_dist_from_dist(inform_dist const *dist);
+/**
+ * Create a dense distribution with support `n` from a sparse distribution.
+ *
+ * If the sparse distribution is `NULL`, contains an event greater than or
+ * equal to `n`, or the allocation fails, `NULL` is returned.
+ *
+ * @param[in] dist the sparse distribution
+ * @param[in] n    the size of the dense support
+ * @return the new dense distribution
+ */
+EXPORT inform_dist *inform_sparse_dist_to_dist(inform_sparse_dist const *dist,
+    size_t n);
+/**
+ * Remove all observations from a sparse distribution, keeping its memory.
+ *
+ * @param[in,out] dist the distribution
+ */
+EXPORT void inform_sparse_dist_clear(inform_sparse_dist *dist);
+/**
+ * Free all dynamically allocated memory associated with a sparse
+ * distribution.
+ *
+ * @param[in] dist the distribution to free
+ */
+EXPORT void inform_sparse_dist_free(inform_sparse_dist *dist);
+
+/**
+ * Get the number of distinct events observed with non-zero frequency.
+ *
+ * If the distribution is `NULL`, then `0` is returned.
+ *
+ * @param[in] dist the distribution
+ * @return the number of observed events
+ */
+EXPORT size_t inform_sparse_dist_size(inform_sparse_dist const *dist);
+/**
+ * Get the total number of observations so far made.
+ *
+ * If the distribution is `NULL`, then return `0`.
+ *
+ * @param[in] dist the distribution
+ * @return the number of observations thus far made
+ */
+EXPORT uint64_t inform_sparse_dist_counts(inform_sparse_dist const *dist);
+/**
+ * Determine whether or not the sparse distribution is valid.
+ *
+ * The distribution must be non-`NULL` and have at least one observation.
+ *
+ * @param[in] dist the distribution
+ * @return the validity of the distribution
+ */
+EXPORT bool inform_sparse_dist_is_valid(inform_sparse_dist const *dist);
+
+/**
+ * Get the number of occurances of a given event.
+ *
+ * If the distribution is `NULL` or the event has never been observed, `0` is
+ * returned.
+ *
+ * @param[in] dist  the distribution
+ * @param[in] event the event in question
+ * @return the number of observed occurances of the event
+ */
+EXPORT uint32_t inform_sparse_dist_get(inform_sparse_dist const *dist,
+    uint64_t event);
+/**
+ * Set the number of occurances of a given event.
+ *
+ * Setting the frequency to zero removes the event from the table.
+ *
+ * If the distribution is `NULL` or the table could not grow, then nothing
+ * happens and zero is returned.
+ *
+ * @param[in,out] dist the distribution
+ * @param[in] event    the event in question
+ * @param[in] x        the new number of occurances
+ * @return the new number of observed occurances of the event
+ */
+EXPORT uint32_t inform_sparse_dist_set(inform_sparse_dist *dist, uint64_t event,
+    uint32_t x);
+/**
+ * Increment the number of observations of a given event.
+ *
+ * If the distribution is `NULL`, the table could not grow, or the event has
+ * already been observed `UINT32_MAX` times, then nothing happens and zero is
+ * returned.
+ *
+ * @param[in,out] dist the distribution
+ * @param[in] event    the event in question
+ * @return the new number of occurances of the event
+ */
+EXPORT uint32_t inform_sparse_dist_tick(inform_sparse_dist *dist, uint64_t event);
+/**
+ * Extract the probability of an event.
+ *
+ * If the distribution is `NULL` or no observations have yet been made, then
+ * a zero probability is returned.
+ *
+ * @param[in] dist  the distribution
+ * @param[in] event the event in question
+ * @return the heuristic probability of the event
+ */
+EXPORT double inform_sparse_dist_prob(inform_sparse_dist const *dist,
+    uint64_t event);
+/**
+ * Accumulate observations from a series.
+ *
+ * If the distribution or events are `NULL`, no events will be observed (0 will
+ * be returned). If a negative event is encountered, or the table cannot grow,
+ * then the number of valid events to that point will be returned.
+ *
+ * @param[in,out] dist the distribution
+ * @param[in] events   the events to observe
+ * @param[in] n        the number of events provided
+ * @return the number of valid observations
+ */
+EXPORT size_t inform_sparse_dist_accumulate(inform_sparse_dist *dist,
+    int const *events, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
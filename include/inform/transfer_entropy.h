@@ -3,7 +3,10 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/accumulator.h>
 #include <inform/error.h>
+#include <inform/local_summary.h>
+#include <inform/series.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -28,6 +31,29 @@ EXPORT double inform_transfer_entropy(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
     inform_error *err);
 
+/**
+ * Compute the transfer entropy from one validated ensemble of time series to
+ * another, conditioned on validated background nodes
+ *
+ * The series are not scanned again. The background handle wraps the
+ * ensembles of the `l` background nodes one after the other, laid out as
+ * for inform_transfer_entropy, i.e. it holds `l * n` initial conditions of
+ * the same `m` time steps as the source and destination. Without background,
+ * the destination's encoded histories are used if they have length `k`. The
+ * source and destination must have the same shape, and the largest of the
+ * bases is used.
+ *
+ * @param[in] src  the handle of the ensemble of the source node
+ * @param[in] dst  the handle of the ensemble of the destination node
+ * @param[in] back the handle of the background nodes, or NULL for none
+ * @param[in] k    the history length used to calculate the transfer entropy
+ * @param[out] err an error structure
+ * @return the transfer entropy of the ensemble
+ */
+EXPORT double inform_transfer_entropy_series(inform_series const *src,
+    inform_series const *dst, inform_series const *back, size_t k,
+    inform_error *err);
+
 /**
  * Compute the local transfer entropy from one time series to another
  *
@@ -47,6 +73,285 @@ EXPORT double *inform_local_transfer_entropy(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
     inform_error *err);
 
+/**
+ * Compute the local transfer entropy between validated ensembles of time
+ * series
+ *
+ * See inform_transfer_entropy_series.
+ *
+ * @param[in] src  the handle of the ensemble of the source node
+ * @param[in] dst  the handle of the ensemble of the destination node
+ * @param[in] back the handle of the background nodes, or NULL for none
+ * @param[in] k    the history length
+ * @param[out] te  the local transfer entropy, or NULL to allocate it
+ * @param[out] err an error structure
+ * @return a pointer to the local transfer entropy array
+ */
+EXPORT double *inform_local_transfer_entropy_series(inform_series const *src,
+    inform_series const *dst, inform_series const *back, size_t k, double *te,
+    inform_error *err);
+
+/**
+ * Compute the local transfer entropy of an ensemble of time series in single
+ * precision
+ *
+ * See inform_local_transfer_entropy.
+ *
+ * @param[in] src    the ensemble of the source node
+ * @param[in] dst    the ensemble of the target node
+ * @param[in] back   the collection of background nodes
+ * @param[in] l      the number of background nodes
+ * @param[in] n      the number initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[out] te    the local transfer entropy, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the local transfer entropy array
+ */
+EXPORT float *inform_local_transfer_entropy_float(int const *src,
+    int const *dst, int const *back, size_t l, size_t n, size_t m, int b,
+    size_t k, float *te, inform_error *err);
+
+/**
+ * Compute the local transfer entropy between validated ensembles of time
+ * series in single precision
+ *
+ * See inform_transfer_entropy_series.
+ *
+ * @param[in] src  the handle of the ensemble of the source node
+ * @param[in] dst  the handle of the ensemble of the destination node
+ * @param[in] back the handle of the background nodes, or NULL for none
+ * @param[in] k    the history length
+ * @param[out] te  the local transfer entropy, or NULL to allocate it
+ * @param[out] err an error structure
+ * @return a pointer to the local transfer entropy array
+ */
+EXPORT float *inform_local_transfer_entropy_float_series(
+    inform_series const *src, inform_series const *dst,
+    inform_series const *back, size_t k, float *te, inform_error *err);
+
+/**
+ * Summarize the local transfer entropy of an ensemble of time series without
+ * storing it
+ *
+ * Each local value is added to the summary as it is computed; see
+ * inform_local_summary.
+ *
+ * @param[in] src    the ensemble of the source node
+ * @param[in] dst    the ensemble of the target node
+ * @param[in] back   the collection of background nodes
+ * @param[in] l      the number of background nodes
+ * @param[in] n      the number initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err   an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_transfer_entropy_summary(
+    int const *src, int const *dst, int const *back, size_t l, size_t n,
+    size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err);
+
+/**
+ * Summarize the local transfer entropy between validated ensembles of time
+ * series without storing it
+ *
+ * See inform_transfer_entropy_series and
+ * inform_local_transfer_entropy_summary.
+ *
+ * @param[in] src  the handle of the ensemble of the source node
+ * @param[in] dst  the handle of the ensemble of the destination node
+ * @param[in] back the handle of the background nodes, or NULL for none
+ * @param[in] k    the history length
+ * @param[in,out] summary the summary to which the values are added
+ * @param[out] err an error structure
+ * @return the summary, or NULL on error
+ */
+EXPORT inform_local_summary *inform_local_transfer_entropy_summary_series(
+    inform_series const *src, inform_series const *dst,
+    inform_series const *back, size_t k, inform_local_summary *summary,
+    inform_error *err);
+
+/**
+ * Compute the transfer entropy between every ordered pair of a collection of
+ * time series
+ *
+ * The series are validated once and the histories of each destination are
+ * encoded and counted once, then shared by every source. The destinations
+ * are divided among up to inform_get_num_threads() threads. No background
+ * nodes are conditioned on; each entry is the same as inform_transfer_entropy
+ * would compute for the pair with `l = 0`.
+ *
+ * @param[in] series the ensembles of the `l` nodes, one after the other, each
+ *                   of `n` initial conditions of `m` time steps
+ * @param[in] l      the number of nodes
+ * @param[in] n      the number initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length used to calculate the transfer entropy
+ * @param[out] te    the `l x l` matrix, with the transfer entropy from node
+ *                   `i` to node `j` at `te[i * l + j]`, or NULL to allocate it
+ * @param[out] err   an error structure
+ * @return a pointer to the transfer entropy matrix
+ */
+EXPORT double *inform_transfer_entropy_matrix(int const *series, size_t l,
+    size_t n, size_t m, int b, size_t k, double *te, inform_error *err);
+
+/**
+ * Compute the transfer entropy from one time series to another at each of a
+ * range of source lags
+ *
+ * At lag `d`, the source state of the observation at time step `t` is the
+ * embedding of the `ks` time steps of the source ending at `t - d`; with
+ * `ks = 1` and `d = 1` this is the source state used by
+ * inform_transfer_entropy. Every lag is estimated from the same
+ * observations, those at time steps `t >= max(k, max_lag + ks - 1)`. The
+ * destination's histories are encoded and counted once, the histograms of
+ * several lags are filled in a single sweep over them, and the lags are
+ * divided among up to inform_get_num_threads() threads. The transfer entropy
+ * at lag `d` is stored at `te[d - min_lag]`.
+ *
+ * @param[in] src     the ensemble of the source node
+ * @param[in] dst     the ensemble of the target node
+ * @param[in] n       the number of initial conditions
+ * @param[in] m       the number of time steps in each time series
+ * @param[in] b       the base or number of distinct states at each time step
+ * @param[in] k       the history length of the target
+ * @param[in] ks      the embedding length of the source, at least 1
+ * @param[in] min_lag the smallest lag, at least 1
+ * @param[in] max_lag the largest lag, at least `min_lag`
+ * @param[out] te     the transfer entropy at each lag, or NULL to allocate
+ *                    them
+ * @param[out] err    an error structure
+ * @return a pointer to the transfer entropy at each lag
+ */
+EXPORT double *inform_transfer_entropy_lag_scan(int const *src,
+    int const *dst, size_t n, size_t m, int b, size_t k, size_t ks,
+    size_t min_lag, size_t max_lag, double *te, inform_error *err);
+
+/**
+ * Compute the transfer entropy from one time series to another over a sliding
+ * window
+ *
+ * The window spans `window` time steps of every initial condition and
+ * advances `stride` time steps at a time, so there are
+ * `(m - window) / stride + 1` windows. Each window after the first removes
+ * the observations which fell off its trailing edge and adds those which
+ * entered at its leading edge, keeping running sums over its histograms, so
+ * its cost is proportional to `stride` rather than `window`. The value for
+ * the window starting at time step `i * stride` is stored at `te[i]`.
+ *
+ * @param[in] src    the ensemble of the source node
+ * @param[in] dst    the ensemble of the target node
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length
+ * @param[in] window the number of time steps in each window, greater than `k`
+ * @param[in] stride the number of time steps between windows
+ * @param[out] te    the transfer entropy of each window, or NULL to allocate
+ *                   them
+ * @param[out] err   an error structure
+ * @return a pointer to the transfer entropy of each window
+ */
+EXPORT double *inform_transfer_entropy_windowed(int const *src, int const *dst,
+    size_t n, size_t m, int b, size_t k, size_t window, size_t stride,
+    double *te, inform_error *err);
+
+/**
+ * Create an accumulator of the transfer entropy from one time series to
+ * another
+ *
+ * Each chunk accumulated holds `m` time steps of the source, followed by `m`
+ * time steps of the target and `m` time steps of each of the `l` background
+ * nodes. See inform_acc for how the accumulator is used.
+ *
+ * @param[in] l    the number of background nodes
+ * @param[in] b    the base or number of distinct states at each time step
+ * @param[in] k    the history length used to calculate the transfer entropy
+ * @param[out] err an error structure
+ * @return the accumulator, or NULL on error
+ */
+EXPORT inform_acc *inform_transfer_entropy_acc(size_t l, int b, size_t k,
+    inform_error *err);
+
+/**
+ * An online estimator of the transfer entropy from one time series to
+ * another
+ *
+ * The estimator keeps the four histograms of the transfer entropy resident,
+ * along with the running sum @f \sum_i c_i \log_2 c_i @f over each, so that
+ * pushing the next time step of the source and target updates the transfer
+ * entropy in amortized constant time rather than recomputing it from the
+ * whole history. With a window, only the most recent `window` observations
+ * are held, and each push beyond that retires the oldest.
+ */
+typedef struct inform_online_te inform_online_te;
+
+/**
+ * Create an online estimator of the transfer entropy from one time series
+ * to another
+ *
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length used to calculate the transfer entropy
+ * @param[in] window the largest number of observations held, or 0 to hold
+ *                   every observation
+ * @param[out] err   an error structure
+ * @return the estimator, or NULL on error
+ */
+EXPORT inform_online_te *inform_transfer_entropy_online(int b, size_t k,
+    size_t window, inform_error *err);
+
+/**
+ * Push the next time step of the source and target.
+ *
+ * An observation is made once the target has `k` time steps of history.
+ * Invalid states leave the estimator untouched.
+ *
+ * @param[in,out] te the estimator
+ * @param[in] src    the state of the source
+ * @param[in] dst    the state of the target
+ * @param[out] err   an error structure
+ * @return the transfer entropy over the observations held, or NaN if there
+ *         are none or an error occurred
+ */
+EXPORT double inform_online_te_push(inform_online_te *te, int src, int dst,
+    inform_error *err);
+
+/**
+ * Get the transfer entropy over the observations an estimator holds.
+ *
+ * @param[in] te the estimator
+ * @return the transfer entropy, or NaN if there are no observations
+ */
+EXPORT double inform_online_te_value(inform_online_te const *te);
+
+/**
+ * Get the number of observations an estimator holds.
+ *
+ * @param[in] te the estimator
+ * @return the number of observations
+ */
+EXPORT uint64_t inform_online_te_observations(inform_online_te const *te);
+
+/**
+ * End the current time series so that the next time step pushed starts a
+ * new initial condition; the observations held are kept.
+ *
+ * @param[in,out] te the estimator
+ */
+EXPORT void inform_online_te_restart(inform_online_te *te);
+
+/**
+ * Free an online estimator.
+ *
+ * @param[in] te the estimator
+ */
+EXPORT void inform_online_te_free(inform_online_te *te);
+
 #ifdef __cplusplus
 }
 #endif
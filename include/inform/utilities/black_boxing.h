@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -29,6 +30,28 @@ EXPORT int *inform_black_box(int const *series, size_t l, size_t n, size_t m,
     int const *b, size_t const *r, size_t const *s, int *box,
     inform_error *err);
 
+/**
+ * Black box a collection of time series into 64-bit states.
+ *
+ * This is identical to inform_black_box, except that the black boxed states
+ * may occupy up to 63 bits rather than 30, allowing for much longer histories
+ * and futures or many more time series.
+ *
+ * @param[in] series    the time series
+ * @param[in] l         the number of time series
+ * @param[in] n         the number of initial conditions in each time series
+ * @param[in] m         the number of time steps for each initial condition
+ * @param[in] b         the base of each time series
+ * @param[in] r         the history length for each time series
+ * @param[in] s         the future length for each time series
+ * @param[in,out] box   the array in which to put the black boxed time series
+ * @param[in,out] err   an error code
+ * @return the black boxed time series
+ */
+EXPORT uint64_t *inform_black_box64(int const *series, size_t l, size_t n,
+    size_t m, int const *b, size_t const *r, size_t const *s, uint64_t *box,
+    inform_error *err);
+
 /**
  * Black box a collection of time series according to a partitioning scheme.
  *
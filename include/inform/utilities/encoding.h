@@ -35,6 +35,33 @@ EXPORT int32_t inform_encode(int const *state, size_t n, int b,
 EXPORT void inform_decode(int32_t encoding, int b, int *state, size_t n,
     inform_error *err);
 
+/**
+ * Encode a base-`b` array of integers into a single 64-bit integer.
+ *
+ * The encoding may use at most 63 bits, so that, e.g., a binary state may
+ * have up to 63 terms.
+ *
+ * @param[in] state the state to encode
+ * @param[in] n     the number of base-`b` terms in `states`
+ * @param[in] b     the base of each terms
+ * @param[out] err  the error code
+ * @return the encoded state, or UINT64_MAX on error
+ */
+EXPORT uint64_t inform_encode64(int const *state, size_t n, int b,
+    inform_error *err);
+
+/**
+ * Decode a 64-bit integer into a base-`b` array of integers.
+ *
+ * @param[in] encoding the encoded state
+ * @param[in] b        the base of the encoding
+ * @param[out] state   the decoded state
+ * @param[in] n        the maximum number of decoded base-`b` terms
+ * @param[out]         the error code
+ */
+EXPORT void inform_decode64(uint64_t encoding, int b, int *state, size_t n,
+    inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,151 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/dist.h>
+#include <inform/export.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * A distribution of the events within a sliding window
+ *
+ * The window holds at most `width` of the most recently observed events.
+ * Once it is full, observing an event evicts the oldest one. Along with the
+ * frequencies, the window maintains the running sum @f \sum_i c_i \log_2 c_i
+ * @f over its histogram, so that the entropy of the window, and the mutual
+ * information and conditional entropy of windows observed in lock step, are
+ * available in constant time after every observation rather than requiring a
+ * scan of the support.
+ *
+ * The frequencies are held in an ordinary inform_dist, `dist`, which may be
+ * read (but not modified) with the usual accessors.
+ */
+typedef struct inform_window_distribution
+{
+    /// the frequencies of the events within the window
+    inform_dist *dist;
+    /// the events within the window, as a ring buffer
+    size_t *events;
+    /// the largest number of events the window can hold
+    size_t width;
+    /// the position of the oldest event within the ring buffer
+    size_t head;
+    /// the running sum of c log2 c over the histogram
+    double nlogn;
+    /// the number of updates to nlogn since it was last recomputed
+    size_t updates;
+} inform_window_dist;
+
+/**
+ * Allocate an empty sliding window over a support of `size` events.
+ *
+ * The allocation will fail and return `NULL` if either argument is zero or
+ * memory cannot be allocated.
+ *
+ * @param[in] size  the size of the support
+ * @param[in] width the largest number of events held by the window
+ * @return the window
+ */
+EXPORT inform_window_dist *inform_window_dist_alloc(size_t size, size_t width);
+/**
+ * Remove every event from a window, keeping its memory.
+ *
+ * @param[in,out] wd the window
+ */
+EXPORT void inform_window_dist_clear(inform_window_dist *wd);
+/**
+ * Free all dynamically allocated memory associated with a window.
+ *
+ * @param[in] wd the window to free
+ */
+EXPORT void inform_window_dist_free(inform_window_dist *wd);
+
+/**
+ * Get the number of events currently within the window.
+ *
+ * If the window is `NULL`, then `0` is returned.
+ *
+ * @param[in] wd the window
+ * @return the number of events within the window
+ */
+EXPORT size_t inform_window_dist_counts(inform_window_dist const *wd);
+/**
+ * Observe an event, evicting the oldest event if the window is full.
+ *
+ * If the window is `NULL` or the event is outside of the support, nothing
+ * happens and zero is returned.
+ *
+ * @param[in,out] wd the window
+ * @param[in] event  the event
+ * @return the new number of occurances of the event within the window
+ */
+EXPORT uint32_t inform_window_dist_tick(inform_window_dist *wd, size_t event);
+/**
+ * Evict the oldest event from the window, shrinking it by one.
+ *
+ * If the window is `NULL` or empty, nothing happens.
+ *
+ * @param[in,out] wd the window
+ * @return the number of events remaining within the window
+ */
+EXPORT size_t inform_window_dist_untick(inform_window_dist *wd);
+
+/**
+ * Compute the Shannon entropy of the events within a window.
+ *
+ * This takes constant time. If the window is `NULL` or empty, then `NaN` is
+ * returned.
+ *
+ * @param[in] wd  the window
+ * @param[in] base the logarithmic base
+ * @return the entropy of the window
+ */
+EXPORT double inform_window_dist_entropy(inform_window_dist const *wd,
+    double base);
+/**
+ * Compute the mutual information between the events of two windows, given a
+ * window of their joint events.
+ *
+ * The three windows must have been fed in lock step, so that they hold the
+ * same number of events. This takes constant time. If any window is `NULL`
+ * or empty, or the windows hold different numbers of events, then `NaN` is
+ * returned.
+ *
+ * @param[in] joint      the window of joint events
+ * @param[in] marginal_x the window of the first variable's events
+ * @param[in] marginal_y the window of the second variable's events
+ * @param[in] base       the logarithmic base
+ * @return the mutual information within the windows
+ */
+EXPORT double inform_window_dist_mi(inform_window_dist const *joint,
+    inform_window_dist const *marginal_x, inform_window_dist const *marginal_y,
+    double base);
+/**
+ * Compute the conditional entropy of the events of one variable given those
+ * of another, from a window of their joint events and a window of the
+ * conditioning variable's events.
+ *
+ * The windows must have been fed in lock step, so that they hold the same
+ * number of events. This takes constant time. If either window is `NULL` or
+ * empty, or the windows hold different numbers of events, then `NaN` is
+ * returned.
+ *
+ * @param[in] joint    the window of joint events
+ * @param[in] marginal the window of the conditioning variable's events
+ * @param[in] base     the logarithmic base
+ * @return the conditional entropy within the windows
+ */
+EXPORT double inform_window_dist_ce(inform_window_dist const *joint,
+    inform_window_dist const *marginal, double base);
+
+#ifdef __cplusplus
+}
+#endif
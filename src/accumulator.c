@@ -0,0 +1,649 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "accumulator.h"
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/conditional_entropy.h>
+#include <inform/entropy_rate.h>
+#include <inform/mutual_info.h>
+#include <inform/predictive_info.h>
+#include <inform/transfer_entropy.h>
+#include <limits.h>
+#include <string.h>
+#include "serialize.h"
+
+inform_acc *inform_acc_alloc(inform_acc_vtable const *vtable,
+    int const *bases, size_t streams, size_t window, uint64_t const *sizes,
+    size_t nhs, inform_error *err)
+{
+    inform_acc *acc = calloc(1, sizeof(inform_acc));
+    if (acc == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    acc->vtable = vtable;
+    acc->streams = streams;
+    acc->window = window;
+    acc->nhs = nhs;
+
+    size_t const tail_size = streams * (window - 1);
+    acc->bases = malloc(streams * sizeof(int));
+    acc->hs = malloc(nhs * sizeof(histogram));
+    acc->sizes = malloc(nhs * sizeof(uint64_t));
+    if (tail_size != 0)
+    {
+        acc->tail = malloc(tail_size * sizeof(int));
+        acc->scratch = malloc(2 * tail_size * sizeof(int));
+    }
+    // the number of observations is unknown, so the histograms are only
+    // stored sparsely when their supports are too large to be dense
+    if (acc->bases == NULL || acc->hs == NULL || acc->sizes == NULL ||
+        (tail_size != 0 && (acc->tail == NULL || acc->scratch == NULL)) ||
+        histograms_init(acc->hs, sizes, nhs, 0))
+    {
+        free(acc->bases);
+        free(acc->hs);
+        free(acc->sizes);
+        free(acc->tail);
+        free(acc->scratch);
+        free(acc);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    memcpy(acc->bases, bases, streams * sizeof(int));
+    memcpy(acc->sizes, sizes, nhs * sizeof(uint64_t));
+    return acc;
+}
+
+/**
+ * Check that every stream of a block lies within its base.
+ *
+ * @return true if an invalid state was found
+ */
+static bool check_states(inform_acc const *acc, int const *series, size_t m,
+    inform_error *err)
+{
+    for (size_t s = 0; s < acc->streams; ++s, series += m)
+    {
+        size_t const i = inform_valid_prefix(series, m, acc->bases[s]);
+        if (i != m)
+        {
+            INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+                INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
+
+/**
+ * Join the last `tail_len < W` time steps of each of `S` streams, stored
+ * `W - 1` apart in `tail`, to the first `W - 1` time steps of the next chunk
+ * of `m` time steps. Every window of `W` time steps within the join starts
+ * within the tail, so none of them are seen twice.
+ *
+ * @return the number of time steps in the join
+ */
+static size_t join_tail(int const *tail, size_t tail_len, int const *series,
+    size_t m, size_t S, size_t W, int *scratch)
+{
+    size_t const head = (m < W - 1) ? m : W - 1;
+    size_t const L = tail_len + head;
+    for (size_t s = 0; s < S && W > 1; ++s)
+    {
+        int *joint = scratch + s * L;
+        memcpy(joint, tail + s * (W - 1), tail_len * sizeof(int));
+        memcpy(joint + tail_len, series + s * m, head * sizeof(int));
+    }
+    return L;
+}
+
+/**
+ * Keep the last `W - 1` time steps of a chunk of `m` time steps, or of its
+ * join of `L` time steps if the chunk is shorter, as the next tail.
+ *
+ * @return the number of time steps in the tail
+ */
+static size_t keep_tail(int *tail, int const *scratch, size_t L,
+    int const *series, size_t m, size_t S, size_t W)
+{
+    if (W == 1)
+    {
+        return 0;
+    }
+    int const *source = scratch;
+    size_t stride = L, length = L;
+    if (m >= W - 1)
+    {
+        source = series;
+        stride = length = m;
+    }
+    size_t const keep = (length < W - 1) ? length : W - 1;
+    for (size_t s = 0; s < S; ++s)
+    {
+        memmove(tail + s * (W - 1), source + s * stride + (length - keep),
+            keep * sizeof(int));
+    }
+    return keep;
+}
+
+bool inform_acc_accumulate(inform_acc *acc, int const *series, size_t m,
+    inform_error *err)
+{
+    if (acc == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (check_states(acc, series, m, err))
+    {
+        return true;
+    }
+
+    size_t const W = acc->window;
+    size_t const L = join_tail(acc->tail, acc->tail_len, series, m,
+        acc->streams, W, acc->scratch);
+    bool oom = false;
+    if (acc->tail_len != 0 && L >= W)
+    {
+        oom |= acc->vtable->accumulate(acc, acc->scratch, L);
+    }
+    if (m >= W)
+    {
+        oom |= acc->vtable->accumulate(acc, series, m);
+    }
+
+    acc->tail_len = keep_tail(acc->tail, acc->scratch, L, series, m,
+        acc->streams, W);
+
+    if (oom)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    return false;
+}
+
+/**
+ * Pull the next chunk of at most `chunk` time steps from a reader, laying
+ * its streams out one after the other.
+ *
+ * @return true if the reader failed
+ */
+static bool pull(inform_acc const *acc, inform_reader read, void *arg,
+    int *series, size_t chunk, size_t *m, inform_error *err)
+{
+    inform_error read_err = INFORM_SUCCESS;
+    *m = read(arg, series, chunk, &read_err);
+    if (inform_failed(&read_err))
+    {
+        INFORM_ERROR_RETURN(err, read_err, true);
+    }
+    else if (*m > chunk)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, true);
+    }
+    // the streams were written `chunk` time steps apart
+    for (size_t s = 1; s < acc->streams && *m < chunk; ++s)
+    {
+        memmove(series + s * *m, series + s * chunk, *m * sizeof(int));
+    }
+    return false;
+}
+
+bool inform_acc_read(inform_acc *acc, inform_reader read, void *arg,
+    size_t chunk, inform_error *err)
+{
+    if (acc == NULL || read == NULL || chunk == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    int *series = malloc(acc->streams * chunk * sizeof(int));
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+
+    size_t m;
+    bool failed = pull(acc, read, arg, series, chunk, &m, err);
+    while (!failed && m != 0)
+    {
+        failed = inform_acc_accumulate(acc, series, m, err) ||
+            pull(acc, read, arg, series, chunk, &m, err);
+    }
+    free(series);
+    return failed;
+}
+
+void inform_acc_restart(inform_acc *acc)
+{
+    if (acc != NULL)
+    {
+        acc->tail_len = 0;
+    }
+}
+
+/**
+ * Determine whether two accumulators measure the same thing.
+ */
+static bool compatible(inform_acc const *a, inform_acc const *b)
+{
+    return a->vtable == b->vtable && a->b == b->b && a->k == b->k &&
+        a->k2 == b->k2 && a->l == b->l && a->streams == b->streams &&
+        memcmp(a->bases, b->bases, a->streams * sizeof(int)) == 0;
+}
+
+bool inform_acc_merge(inform_acc const *src, inform_acc *dest,
+    inform_error *err)
+{
+    if (src == NULL || dest == NULL || src == dest || !compatible(src, dest))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    for (size_t i = 0; i < dest->nhs; ++i)
+    {
+        if (!histogram_fits(dest->hs + i, src->hs + i))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_FAILURE, true);
+        }
+    }
+
+    // sparse histograms may fail to grow, so they are merged into copies
+    // which replace the originals only once every merge has succeeded
+    inform_sparse_dist **copies = calloc(dest->nhs, sizeof(inform_sparse_dist*));
+    if (copies == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    for (size_t i = 0; i < dest->nhs; ++i)
+    {
+        if (dest->hs[i].sparse == NULL)
+        {
+            continue;
+        }
+        histogram copy = { { NULL, 0, 0 }, inform_sparse_dist_dup(dest->hs[i].sparse) };
+        copies[i] = copy.sparse;
+        if (copy.sparse == NULL || !histogram_add(&copy, src->hs + i))
+        {
+            for (size_t j = 0; j <= i; ++j)
+            {
+                inform_sparse_dist_free(copies[j]);
+            }
+            free(copies);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+        }
+    }
+    for (size_t i = 0; i < dest->nhs; ++i)
+    {
+        if (copies[i] == NULL)
+        {
+            histogram_add(dest->hs + i, src->hs + i);
+        }
+        else
+        {
+            inform_sparse_dist_free(dest->hs[i].sparse);
+            dest->hs[i].sparse = copies[i];
+        }
+    }
+    free(copies);
+    return false;
+}
+
+uint64_t inform_acc_observations(inform_acc const *acc)
+{
+    return (acc == NULL) ? 0 : histogram_counts(acc->hs);
+}
+
+double inform_acc_finalize(inform_acc const *acc, inform_error *err)
+{
+    if (acc == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
+    uint64_t const N = histogram_counts(acc->hs);
+    if (N == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NAN);
+    }
+    return acc->vtable->finalize(acc, N);
+}
+
+double *inform_acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *local, inform_error *err)
+{
+    if (acc == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    else if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+    }
+    else if (m < acc->window)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, NULL);
+    }
+    else if (histogram_counts(acc->hs) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NULL);
+    }
+    else if (check_states(acc, series, m, err))
+    {
+        return NULL;
+    }
+
+    if (local == NULL)
+    {
+        local = malloc((m - acc->window + 1) * sizeof(double));
+        if (local == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+    acc->vtable->local(acc, series, m, local);
+    return local;
+}
+
+bool inform_acc_read_local(inform_acc const *acc, inform_reader read,
+    void *arg, size_t chunk, inform_writer write, void *write_arg,
+    inform_error *err)
+{
+    if (acc == NULL || read == NULL || write == NULL || chunk == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (histogram_counts(acc->hs) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+
+    // the current time series' tail is kept apart from the accumulator's
+    size_t const W = acc->window, S = acc->streams, tail_size = S * (W - 1);
+    int *series = malloc(S * chunk * sizeof(int));
+    double *local = malloc(chunk * sizeof(double));
+    int *tail = NULL, *scratch = NULL;
+    if (tail_size != 0)
+    {
+        tail = malloc(tail_size * sizeof(int));
+        scratch = malloc(2 * tail_size * sizeof(int));
+    }
+    if (series == NULL || local == NULL ||
+        (tail_size != 0 && (tail == NULL || scratch == NULL)))
+    {
+        free(local);
+        free(scratch);
+        free(tail);
+        free(series);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+
+    size_t m, tail_len = 0;
+    bool failed = pull(acc, read, arg, series, chunk, &m, err);
+    while (!failed && m != 0)
+    {
+        if (check_states(acc, series, m, err))
+        {
+            failed = true;
+            break;
+        }
+
+        // the local values are emitted in order: first those of the windows
+        // which start within the tail, then those within the chunk
+        size_t const L = join_tail(tail, tail_len, series, m, S, W, scratch);
+        size_t count = 0;
+        if (tail_len != 0 && L >= W)
+        {
+            acc->vtable->local(acc, scratch, L, local);
+            count = L - W + 1;
+        }
+        if (m >= W)
+        {
+            acc->vtable->local(acc, series, m, local + count);
+            count += m - W + 1;
+        }
+
+        tail_len = keep_tail(tail, scratch, L, series, m, S, W);
+
+        if (count != 0)
+        {
+            inform_error write_err = INFORM_SUCCESS;
+            write(write_arg, local, count, &write_err);
+            if (inform_failed(&write_err))
+            {
+                INFORM_ERROR(err, write_err);
+                failed = true;
+                break;
+            }
+        }
+        failed = pull(acc, read, arg, series, chunk, &m, err);
+    }
+
+    free(local);
+    free(scratch);
+    free(tail);
+    free(series);
+    return failed;
+}
+
+void inform_acc_free(inform_acc *acc)
+{
+    if (acc != NULL)
+    {
+        histograms_free(acc->hs, acc->nhs);
+        free(acc->hs);
+        free(acc->sizes);
+        free(acc->bases);
+        free(acc->tail);
+        free(acc->scratch);
+        free(acc);
+    }
+}
+
+size_t inform_acc_serialize(inform_acc const *acc, uint8_t *buffer, size_t n,
+    inform_error *err)
+{
+    if (acc == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, 0);
+    }
+    serial_writer w = { buffer, n, 0 };
+    serial_put_header(&w, "INFA");
+    serial_put_varint(&w, acc->vtable->measure);
+    serial_put_varint(&w, (uint64_t) acc->b);
+    serial_put_varint(&w, acc->k);
+    serial_put_varint(&w, acc->k2);
+    serial_put_varint(&w, acc->l);
+    serial_put_varint(&w, acc->streams);
+    for (size_t s = 0; s < acc->streams; ++s)
+    {
+        serial_put_varint(&w, (uint64_t) acc->bases[s]);
+    }
+    serial_put_varint(&w, acc->nhs);
+    for (size_t i = 0; i < acc->nhs; ++i)
+    {
+        if (serial_put_histogram(&w, acc->hs + i, acc->sizes[i]))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+        }
+    }
+    serial_put_varint(&w, acc->tail_len);
+    for (size_t s = 0; s < acc->streams; ++s)
+    {
+        for (size_t j = 0; j < acc->tail_len; ++j)
+        {
+            serial_put_varint(&w, (uint64_t) acc->tail[j + s * (acc->window - 1)]);
+        }
+    }
+    return w.size;
+}
+
+/**
+ * Create an empty accumulator for a serialized measure and its parameters.
+ */
+static inform_acc *create(uint64_t measure, int b, size_t k, size_t k2,
+    size_t l, int const *bases, size_t streams, inform_error *err)
+{
+    switch (measure)
+    {
+        case INFORM_ACC_ACTIVE_INFO:
+            return inform_active_info_acc(b, k, err);
+        case INFORM_ACC_BLOCK_ENTROPY:
+            return inform_block_entropy_acc(b, k, err);
+        case INFORM_ACC_CONDITIONAL_ENTROPY:
+            if (streams != 2) break;
+            return inform_conditional_entropy_acc(bases[0], bases[1], err);
+        case INFORM_ACC_ENTROPY_RATE:
+            return inform_entropy_rate_acc(b, k, err);
+        case INFORM_ACC_MUTUAL_INFO:
+            if (streams != l) break;
+            return inform_mutual_info_acc(l, bases, err);
+        case INFORM_ACC_PREDICTIVE_INFO:
+            return inform_predictive_info_acc(b, k, k2, err);
+        case INFORM_ACC_TRANSFER_ENTROPY:
+            return inform_transfer_entropy_acc(l, b, k, err);
+        default:
+            break;
+    }
+    INFORM_ERROR_RETURN(err, INFORM_EFORMAT, NULL);
+}
+
+inform_acc *inform_acc_deserialize(uint8_t const *buffer, size_t n,
+    size_t *used, inform_error *err)
+{
+    if (buffer == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    serial_reader r = { buffer, n, 0, false };
+    serial_get_header(&r, "INFA");
+    uint64_t const measure = serial_get_varint(&r);
+    uint64_t const b = serial_get_varint(&r);
+    uint64_t const k = serial_get_varint(&r);
+    uint64_t const k2 = serial_get_varint(&r);
+    uint64_t const l = serial_get_varint(&r);
+    uint64_t const streams = serial_get_varint(&r);
+    // every base takes at least a byte, which bounds the allocation
+    if (r.failed || b > INT_MAX || k > SIZE_MAX || k2 > SIZE_MAX ||
+        l > SIZE_MAX || streams == 0 || streams > r.size - r.pos)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EFORMAT, NULL);
+    }
+    int *bases = malloc(streams * sizeof(int));
+    if (bases == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    for (size_t s = 0; s < streams; ++s)
+    {
+        uint64_t const base = serial_get_varint(&r);
+        bases[s] = (base > INT_MAX) ? 0 : (int) base;
+    }
+
+    inform_error create_err = INFORM_SUCCESS;
+    inform_acc *acc = NULL;
+    if (!r.failed)
+    {
+        acc = create(measure, (int) b, k, k2, l, bases, streams, &create_err);
+    }
+    if (acc == NULL)
+    {
+        free(bases);
+        INFORM_ERROR_RETURN(err, (create_err == INFORM_ENOMEM) ?
+            INFORM_ENOMEM : INFORM_EFORMAT, NULL);
+    }
+    bool const matches = acc->streams == streams &&
+        memcmp(acc->bases, bases, streams * sizeof(int)) == 0 &&
+        serial_get_varint(&r) == acc->nhs;
+    free(bases);
+
+    inform_error status = matches ? INFORM_SUCCESS : INFORM_EFORMAT;
+    for (size_t i = 0; i < acc->nhs && status == INFORM_SUCCESS; ++i)
+    {
+        status = serial_get_histogram(&r, acc->hs + i, acc->sizes[i]);
+    }
+    if (status == INFORM_SUCCESS)
+    {
+        uint64_t const tail_len = serial_get_varint(&r);
+        if (tail_len >= acc->window)
+        {
+            status = INFORM_EFORMAT;
+        }
+        for (size_t s = 0; s < acc->streams && status == INFORM_SUCCESS; ++s)
+        {
+            for (size_t j = 0; j < tail_len; ++j)
+            {
+                uint64_t const x = serial_get_varint(&r);
+                if (x >= (uint64_t) acc->bases[s])
+                {
+                    status = INFORM_EFORMAT;
+                    break;
+                }
+                acc->tail[j + s * (acc->window - 1)] = (int) x;
+            }
+        }
+        acc->tail_len = (size_t) tail_len;
+    }
+    if (status == INFORM_SUCCESS && r.failed)
+    {
+        status = INFORM_EFORMAT;
+    }
+    if (status != INFORM_SUCCESS)
+    {
+        inform_acc_free(acc);
+        INFORM_ERROR_RETURN(err, status, NULL);
+    }
+    if (used != NULL)
+    {
+        *used = r.pos;
+    }
+    return acc;
+}
+
+bool inform_acc_save(inform_acc const *acc, char const *path,
+    inform_error *err)
+{
+    if (path == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    size_t const n = inform_acc_serialize(acc, NULL, 0, err);
+    if (n == 0)
+    {
+        return true;
+    }
+    uint8_t *buffer = malloc(n);
+    if (buffer == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    if (inform_acc_serialize(acc, buffer, n, err) == 0)
+    {
+        free(buffer);
+        return true;
+    }
+    bool const failed = serial_write_file(path, buffer, n);
+    free(buffer);
+    if (failed)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EIO, true);
+    }
+    return false;
+}
+
+inform_acc *inform_acc_load(char const *path, inform_error *err)
+{
+    if (path == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    size_t n = 0;
+    uint8_t *buffer = serial_read_file(path, &n, err);
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    inform_acc *acc = inform_acc_deserialize(buffer, n, NULL, err);
+    free(buffer);
+    return acc;
+}
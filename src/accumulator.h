@@ -0,0 +1,93 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/accumulator.h>
+#include "histogram.h"
+
+/**
+ * The measures which can be accumulated, as identified in serialized
+ * accumulators; the values must never change.
+ */
+typedef enum inform_acc_measure
+{
+    INFORM_ACC_ACTIVE_INFO         = 1,
+    INFORM_ACC_BLOCK_ENTROPY       = 2,
+    INFORM_ACC_CONDITIONAL_ENTROPY = 3,
+    INFORM_ACC_ENTROPY_RATE        = 4,
+    INFORM_ACC_MUTUAL_INFO         = 5,
+    INFORM_ACC_PREDICTIVE_INFO     = 6,
+    INFORM_ACC_TRANSFER_ENTROPY    = 7,
+} inform_acc_measure;
+
+/**
+ * The operations which distinguish one measure's accumulator from another's
+ *
+ * Each operation is handed a block of `m` time steps of every stream, laid
+ * out one stream after the other, with `m` no smaller than the window of the
+ * accumulator.
+ */
+typedef struct inform_acc_vtable
+{
+    /// observe every window within a block, returning true if out of memory
+    bool (*accumulate)(inform_acc *acc, int const *series, size_t m);
+    /// compute the measure from the histograms, given `N > 0` observations
+    double (*finalize)(inform_acc const *acc, uint64_t N);
+    /// compute the local value of every window within a block
+    void (*local)(inform_acc const *acc, int const *series, size_t m,
+        double *local);
+    /// the measure, used to recreate a serialized accumulator
+    inform_acc_measure measure;
+} inform_acc_vtable;
+
+struct inform_accumulator
+{
+    /// the measure being accumulated
+    inform_acc_vtable const *vtable;
+    /// the base of the measure's time series
+    int b;
+    /// the measure's history length
+    size_t k;
+    /// the measure's second history length, e.g. the future length
+    size_t k2;
+    /// the number of auxiliary time series, e.g. background processes
+    size_t l;
+    /// the number of time series making up each time step
+    size_t streams;
+    /// the base of each of the time series
+    int *bases;
+    /// the number of consecutive time steps in each observation
+    size_t window;
+    /// the histograms, the first of which receives every observation
+    histogram *hs;
+    /// the support of each histogram
+    uint64_t *sizes;
+    /// the number of histograms
+    size_t nhs;
+    /// the last `window - 1` time steps of each stream
+    int *tail;
+    /// the number of time steps in the tail
+    size_t tail_len;
+    /// room to join the tail to the head of the next chunk
+    int *scratch;
+};
+
+/**
+ * Allocate an empty accumulator with histograms of the given supports.
+ *
+ * The measure's parameters (b, k, k2 and l) are zeroed and should be set by
+ * the caller.
+ *
+ * @param[in] vtable  the measure's operations
+ * @param[in] bases   the base of each stream
+ * @param[in] streams the number of streams
+ * @param[in] window  the number of time steps in each observation
+ * @param[in] sizes   the support of each histogram
+ * @param[in] nhs     the number of histograms
+ * @param[out] err    an error structure
+ * @return the accumulator, or NULL if it could not be allocated
+ */
+inform_acc *inform_acc_alloc(inform_acc_vtable const *vtable,
+    int const *bases, size_t streams, size_t window, uint64_t const *sizes,
+    size_t nhs, inform_error *err);
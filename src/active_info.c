@@ -4,69 +4,208 @@
 #include <inform/active_info.h>
 #include <inform/shannon.h>
 #include <string.h>
+#include "accumulator.h"
+#include "failure.h"
+#include "fused.h"
+#include "histogram.h"
+#include "local.h"
+#include "partition.h"
+#include "radix_sort.h"
+#include "series.h"
+#include "windowed.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    inform_dist *futures)
+/**
+ * Accumulate a block of the observations of a series, validating each state
+ * as it is read.
+ *
+ * @return true if a state is invalid, in which case the accumulation stops,
+ *         or if out of memory
+ */
+static bool accumulate_observations(int const* series, size_t m, int b,
+    size_t k, observation_block block, histogram *states,
+    histogram *histories, histogram *futures)
 {
-    for (size_t i = 0; i < n; ++i, series += m)
+    bool ok = true;
+    series += block.begin * m;
+    for (size_t i = block.begin; i < block.end; ++i, series += m)
     {
-        int history = 0, q = 1, state, future;
-        for (size_t j = 0; j < k; ++j)
+        uint64_t history = 0, q = 1, state, future;
+        for (size_t j = block.first - k; j < block.first; ++j)
         {
+            if (inform_invalid_event(series[j], b)) return true;
             q *= b;
             history *= b;
             history += series[j];
         }
-        for (size_t j = k; j < m; ++j)
+        for (size_t j = block.first; j < block.last; ++j)
         {
+            if (inform_invalid_event(series[j], b)) return true;
             future = series[j];
             state  = history * b + future;
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            futures->histogram[future]++;
+            ok &= histogram_tick(states, state);
+            ok &= histogram_tick(histories, history);
+            ok &= histogram_tick(futures, future);
 
             history = state - series[j - k]*q;
         }
     }
+    return !ok;
+}
+
+/// the arguments shared by every block of a series' observations
+typedef struct observations
+{
+    int const *series;
+    size_t m;
+    int b;
+    size_t k;
+} observations;
+
+static bool accumulate_block(void const *arg, observation_block block,
+    histogram *hs)
+{
+    observations const *obs = arg;
+    return accumulate_observations(obs->series, obs->m, obs->b, obs->k, block,
+        hs, hs + 1, hs + 2);
+}
+
+/**
+ * Accumulate the observations of series whose histories have already been
+ * encoded, e.g. by inform_series_encode.
+ */
+static bool accumulate_encoded_observations(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k,
+    histogram *states, histogram *histories, histogram *futures)
+{
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        for (size_t j = k; j < m; ++j)
+        {
+            uint64_t const history = *encoded++;
+            ok &= histogram_tick(states, history * b + series[j]);
+            ok &= histogram_tick(histories, history);
+            ok &= histogram_tick(futures, series[j]);
+        }
+    }
+    return !ok;
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    inform_dist *futures, int *state, int *history, int *future)
+/**
+ * Compute the local active information of each observation of a series,
+ * re-encoding the observations rather than storing them as they were
+ * accumulated.
+ */
+static void local_observations(int const *series, size_t n, size_t m, int b,
+    size_t k, histogram const *states, histogram const *histories,
+    histogram const *futures, local_sink *sink)
 {
-    for (size_t i = 0; i < n; ++i)
+    double const log_N = log2((double) histogram_counts(states));
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            history *= b;
+            history += series[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            future[l] = series[j];
-            state[l] = history[l] * b + future[l];
-
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
-            futures->histogram[future[l]]++;
+            state = history * b + series[j];
+            local_emit(sink,
+                log_N + inform_log2_count(histogram_get(states, state)) -
+                inform_log2_count(histogram_get(histories, history)) -
+                inform_log2_count(histogram_get(futures, series[j])));
+            history = state - series[j - k]*q;
+        }
+    }
+}
 
-            if (j + 1 != m)
-                history[l + 1] = state[l] - series[l]*q;
+/**
+ * Encode the observations of a series, validating each state as it is read
+ * unless the histories have already been encoded.
+ *
+ * @return true if a state is invalid
+ */
+static bool encode_observations(int const* series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, uint64_t *states)
+{
+    if (encoded != NULL)
+    {
+        for (size_t i = 0; i < n; ++i, series += m)
+        {
+            for (size_t j = k; j < m; ++j)
+            {
+                *states++ = *encoded++ * b + series[j];
+            }
         }
-        series += m;
-        state += (m - k);
-        history += (m - k);
-        future += (m - k);
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0, q = 1, state;
+        for (size_t j = 0; j < k; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            q *= b;
+            history *= b;
+            history += series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            state = history * b + series[j];
+            *states++ = state;
+            history = state - series[j - k]*q;
+        }
+    }
+    return false;
+}
+
+static double sorted_active_info(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, uint64_t states_size,
+    inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t *keys = malloc(2 * N * sizeof(uint64_t));
+    uint64_t *futures = calloc(b, sizeof(uint64_t));
+    if (keys == NULL || futures == NULL)
+    {
+        free(keys);
+        free(futures);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    if (encode_observations(series, encoded, n, m, b, k, keys))
+    {
+        free(keys);
+        free(futures);
+        report_failure(series, n, m, b, false, err);
+        return NAN;
+    }
+    uint64_t const *states = inform_radix_sort(keys, keys + N, N, states_size - 1);
+
+    double s = inform_sorted_nlogn(states, N, 1) -
+        inform_sorted_nlogn(states, N, b);
+    for (size_t i = 0; i < N; ++i)
+    {
+        futures[states[i] % b]++;
     }
+    for (int future = 0; future < b; ++future)
+    {
+        s -= inform_nlog2n_count(futures[future]);
+    }
+
+    free(futures);
+    free(keys);
+
+    return log2((double) N) + s / N;
 }
 
-static bool check_arguments(int const *series, size_t n, size_t m, int b,
+static bool check_shape(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
     if (series == NULL)
@@ -93,133 +232,331 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    else if (histogram_support(b, k + 1) == 0)
     {
-        if (series[i] < 0)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-        }
-        else if (b <= series[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
     return false;
 }
 
-double inform_active_info(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+/**
+ * Check the shape of a handle's series, whose states were validated when the
+ * handle was allocated.
+ */
+static bool check_series(inform_series const *series, size_t k,
+    inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NAN;
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    return check_shape(series->data, series->n, series->m, series->b, k, err);
+}
 
+static double active_info(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, inform_error *err)
+{
     size_t const N = n * (m - k);
 
-    size_t const states_size = (size_t) (b * pow((double) b,(double) k));
-    size_t const histories_size = states_size / b;
-    size_t const futures_size = b;
-    size_t const total_size = states_size + histories_size + futures_size;
+    uint64_t const states_size = histogram_support(b, k + 1);
+    uint64_t const histories_size = states_size / b;
+    uint64_t const futures_size = b;
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (histogram_prefers_sort(states_size, N))
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        return sorted_active_info(series, encoded, n, m, b, k, states_size,
+            err);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
-    inform_dist futures   = { data + states_size + histories_size, futures_size, N };
-
-    accumulate_observations(series, n, m, b, k, &states, &histories, &futures);
+    uint64_t const sizes[3] = {states_size, histories_size, futures_size};
+    histogram hs[3];
+    if (histograms_init(hs, sizes, 3, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    histogram *states = hs, *histories = hs + 1, *futures = hs + 2;
 
-    double ai = 0.0;
-    int state;
-    double n_state, n_history, n_future;
-    for (int history = 0; history < (int) histories_size; ++history)
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            3, &overflow) :
+        accumulate_encoded_observations(series, encoded, n, m, b, k, states,
+            histories, futures);
+    if (failed)
     {
-        n_history = histories.histogram[history];
-        if (n_history == 0)
-        {
-            continue;
-        }
-        for (int future = 0; future < b; ++future)
-        {
-            n_future = futures.histogram[future];
-            if (n_future == 0)
-            {
-                continue;
-            }
-            state = history * b + future;
-            n_state = states.histogram[state];
-            if (n_state == 0)
-            {
-                continue;
-            }
-            ai += n_state * log2((N * n_state) / (n_history * n_future));
-        }
+        histograms_free(hs, 3);
+        report_failure(series, n, m, b, overflow, err);
+        return NAN;
     }
 
-    free(data);
+    double ai = log2((double) N) + (histogram_nlogn(states) -
+        histogram_nlogn(histories) - histogram_nlogn(futures)) / N;
+
+    histograms_free(hs, 3);
 
-    return ai / N;
+    return ai;
 }
 
-double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
-    size_t k, double *ai, inform_error *err)
+double inform_active_info(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NULL;
+    if (check_shape(series, n, m, b, k, err)) return NAN;
+    return active_info(series, NULL, n, m, b, k, err);
+}
+
+double inform_active_info_series(inform_series const *series, size_t k,
+    inform_error *err)
+{
+    if (check_series(series, k, err)) return NAN;
+    return active_info(series->data, inform_series_histories(series, k),
+        series->n, series->m, series->b, k, err);
+}
 
+/**
+ * Compute the local active information of a series whose shape has been
+ * checked, writing it to a sink. The histories are encoded as they are
+ * accumulated unless `encoded` holds them already.
+ *
+ * @return true on error
+ */
+static bool local_active_info(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, local_sink sink, inform_error *err)
+{
     size_t const N = n * (m - k);
 
+    uint64_t const states_size = histogram_support(b, k + 1);
+    uint64_t const histories_size = states_size / b;
+    uint64_t const futures_size = b;
+
+    uint64_t const sizes[3] = {states_size, histories_size, futures_size};
+    histogram hs[3];
+    if (histograms_init(hs, sizes, 3, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    histogram *states = hs, *histories = hs + 1, *futures = hs + 2;
+
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            3, &overflow) :
+        accumulate_encoded_observations(series, encoded, n, m, b, k, states,
+            histories, futures);
+    if (failed)
+    {
+        histograms_free(hs, 3);
+        report_failure(series, n, m, b, overflow, err);
+        return true;
+    }
+
+    local_observations(series, n, m, b, k, states, histories, futures, &sink);
+
+    histograms_free(hs, 3);
+
+    return false;
+}
+
+static double *local_active_info_doubles(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k, double *ai,
+    inform_error *err)
+{
     bool allocate_ai = (ai == NULL);
     if (allocate_ai)
     {
-        ai = malloc(N * sizeof(double));
+        ai = malloc(n * (m - k) * sizeof(double));
         if (ai == NULL)
         {
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
 
-    size_t const states_size = (size_t) (b*pow((double) b,(double) k));
-    size_t const histories_size = states_size / b;
-    size_t const futures_size = b;
-    size_t const total_size = states_size + histories_size + futures_size;
-
-    uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
-    if (histogram_data == NULL)
+    if (local_active_info(series, encoded, n, m, b, k, local_doubles(ai), err))
     {
         if (allocate_ai) free(ai);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
-    inform_dist futures   = { histogram_data + states_size + histories_size, futures_size, N };
+    return ai;
+}
 
-    int *state_data = malloc(3 * N * sizeof(int));
-    if (state_data == NULL)
+static float *local_active_info_floats(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k, float *ai,
+    inform_error *err)
+{
+    bool allocate_ai = (ai == NULL);
+    if (allocate_ai)
+    {
+        ai = malloc(n * (m - k) * sizeof(float));
+        if (ai == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    if (local_active_info(series, encoded, n, m, b, k, local_floats(ai), err))
     {
         if (allocate_ai) free(ai);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
-    int *state   = state_data;
-    int *history = state + N;
-    int *future  = history + N;
+    return ai;
+}
 
-    accumulate_local_observations(series, n, m, b, k, &states, &histories,
-        &futures, state, history, future);
+static inform_local_summary *local_active_info_summary(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k,
+    inform_local_summary *summary, inform_error *err)
+{
+    if (summary == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    if (local_active_info(series, encoded, n, m, b, k, local_summary(summary),
+        err))
+    {
+        return NULL;
+    }
+    return summary;
+}
 
-    double r, s, t;
-    for (size_t i = 0; i < N; ++i)
+double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
+    size_t k, double *ai, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_active_info_doubles(series, NULL, n, m, b, k, ai, err);
+}
+
+double *inform_local_active_info_series(inform_series const *series, size_t k,
+    double *ai, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_active_info_doubles(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, ai, err);
+}
+
+float *inform_local_active_info_float(int const *series, size_t n, size_t m,
+    int b, size_t k, float *ai, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_active_info_floats(series, NULL, n, m, b, k, ai, err);
+}
+
+float *inform_local_active_info_float_series(inform_series const *series,
+    size_t k, float *ai, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_active_info_floats(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, ai, err);
+}
+
+inform_local_summary *inform_local_active_info_summary(int const *series,
+    size_t n, size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_active_info_summary(series, NULL, n, m, b, k, summary, err);
+}
+
+inform_local_summary *inform_local_active_info_summary_series(
+    inform_series const *series, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_active_info_summary(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, summary, err);
+}
+
+double *inform_active_info_sweep(int const *series, size_t n, size_t m,
+    int b, size_t kmax, double *ai, inform_error *err)
+{
+    return inform_fused_sweep(series, n, m, b, INFORM_FUSED_ACTIVE_INFO, kmax,
+        ai, err);
+}
+
+static void windowed_encode(windowed_measure const *measure, size_t i,
+    size_t j, uint64_t *events)
+{
+    int const *series = measure->series[0] + i * measure->m;
+    int const b = measure->b;
+    uint64_t history = 0;
+    for (size_t t = j - measure->k; t < j; ++t)
     {
-        r = states.histogram[state[i]];
-        s = histories.histogram[history[i]];
-        t = futures.histogram[future[i]];
-        ai[i] = log2((r * N) / (s * t));
+        history = history * b + series[t];
     }
+    events[0] = history * b + series[j];
+    events[1] = history;
+    events[2] = series[j];
+}
 
-    free(state_data);
-    free(histogram_data);
+static double windowed_value(double const *nlogn, uint64_t N)
+{
+    return log2((double) N) + (nlogn[0] - nlogn[1] - nlogn[2]) / N;
+}
 
-    return ai;
+double *inform_active_info_windowed(int const *series, size_t n, size_t m,
+    int b, size_t k, size_t window, size_t stride, double *ai,
+    inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+
+    uint64_t const states_size = histogram_support(b, k + 1);
+    windowed_measure const measure = {
+        .series = { series }, .streams = 1, .n = n, .m = m, .k = k, .b = b,
+        .nhs = 3, .sizes = { states_size, states_size / b, b },
+        .encode = windowed_encode, .value = windowed_value
+    };
+    return inform_windowed(&measure, window, stride, ai, err);
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    return accumulate_observations(series, m, acc->b, acc->k,
+        (observation_block){ 0, 1, acc->k, m }, acc->hs, acc->hs + 1,
+        acc->hs + 2);
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return log2((double) N) + (histogram_nlogn(acc->hs) -
+        histogram_nlogn(acc->hs + 1) - histogram_nlogn(acc->hs + 2)) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *ai)
+{
+    local_sink sink = local_doubles(ai);
+    local_observations(series, 1, m, acc->b, acc->k, acc->hs, acc->hs + 1,
+        acc->hs + 2, &sink);
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_ACTIVE_INFO
+};
+
+inform_acc *inform_active_info_acc(int b, size_t k, inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    }
+    uint64_t const states_size = histogram_support(b, k + 1);
+    if (states_size == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, &b, 1, k + 1,
+        (uint64_t[]){states_size, states_size / b, b}, 3, err);
+    if (acc != NULL)
+    {
+        acc->b = b;
+        acc->k = k;
+    }
+    return acc;
 }
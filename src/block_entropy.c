@@ -3,14 +3,76 @@
 // license that can be found in the LICENSE file.
 #include <inform/block_entropy.h>
 #include <inform/shannon.h>
+#include "accumulator.h"
+#include "failure.h"
+#include "histogram.h"
+#include "local.h"
+#include "partition.h"
+#include "radix_sort.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states)
+/**
+ * Accumulate the `k`-blocks of a series which end within an observation
+ * block, with `block.first >= k - 1`, validating each state as it is read.
+ *
+ * @return true if a state is invalid, in which case the accumulation stops,
+ *         or if out of memory
+ */
+static bool accumulate_observations(int const* series, size_t m, int b,
+    size_t k, observation_block block, histogram *states)
 {
+    bool ok = true;
+    k -= 1;
+    series += block.begin * m;
+    for (size_t i = block.begin; i < block.end; ++i, series += m)
+    {
+        uint64_t history = 0, q = 1, state;
+        for (size_t j = block.first - k; j < block.first; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            q *= b;
+            history *= b;
+            history += series[j];
+        }
+        for (size_t j = block.first; j < block.last; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            state  = history * b + series[j];
+            ok &= histogram_tick(states, state);
+            history = state - series[j - k]*q;
+        }
+    }
+    return !ok;
+}
+
+/// the arguments shared by every block of a series' observations
+typedef struct observations
+{
+    int const *series;
+    size_t m;
+    int b;
+    size_t k;
+} observations;
+
+static bool accumulate_block(void const *arg, observation_block block,
+    histogram *hs)
+{
+    observations const *obs = arg;
+    return accumulate_observations(obs->series, obs->m, obs->b, obs->k, block,
+        hs);
+}
+
+/**
+ * Compute the local block entropy of each block of a series, re-encoding the
+ * blocks rather than storing them as they were accumulated.
+ */
+static void local_observations(int const *series, size_t n, size_t m, int b,
+    size_t k, histogram const *states, local_sink *sink)
+{
+    double const log_N = log2((double) histogram_counts(states));
     k -= 1;
     for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1, state;
+        uint64_t history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
@@ -19,42 +81,71 @@ static void accumulate_observations(int const* series, size_t n, size_t m,
         }
         for (size_t j = k; j < m; ++j)
         {
-            state  = history * b + series[j];
-            states->histogram[state]++;
+            state = history * b + series[j];
+            local_emit(sink,
+                log_N - inform_log2_count(histogram_get(states, state)));
             history = state - series[j - k]*q;
         }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, int *state)
+/**
+ * Encode the blocks of a series, validating each state as it is read.
+ *
+ * @return true if a state is invalid
+ */
+static bool encode_observations(int const* series, size_t n, size_t m, int b,
+    size_t k, uint64_t *states)
 {
     k -= 1;
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1;
+        uint64_t history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
+            if (inform_invalid_event(series[j], b)) return true;
             q *= b;
             history *= b;
             history += series[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            state[l] = history * b + series[j];
+            if (inform_invalid_event(series[j], b)) return true;
+            state = history * b + series[j];
+            *states++ = state;
+            history = state - series[j - k]*q;
+        }
+    }
+    return false;
+}
 
-            states->histogram[state[l]]++;
+static double sorted_block_entropy(int const *series, size_t n, size_t m,
+    int b, size_t k, uint64_t states_size, inform_error *err)
+{
+    size_t const N = n * (m - k + 1);
 
-            if (j + 1 != m)
-                history = state[l] - series[l]*q;
-        }
-        series += m;
-        state += (m - k);
+    uint64_t *keys = malloc(2 * N * sizeof(uint64_t));
+    if (keys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
+
+    if (encode_observations(series, n, m, b, k, keys))
+    {
+        free(keys);
+        report_failure(series, n, m, b, false, err);
+        return NAN;
+    }
+    uint64_t const *states = inform_radix_sort(keys, keys + N, N, states_size - 1);
+
+    double be = log2((double) N) - inform_sorted_nlogn(states, N, 1) / N;
+
+    free(keys);
+
+    return be;
 }
 
-static bool check_arguments(int const *series, size_t n, size_t m, int b,
+static bool check_shape(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
     if (series == NULL)
@@ -81,93 +172,261 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    else if (histogram_support(b, k) == 0)
     {
-        if (series[i] < 0)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-        }
-        else if (b <= series[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
     return false;
 }
 
-double inform_block_entropy(int const *series, size_t n, size_t m, int b,
+/**
+ * Check the shape of a handle's series, whose states were validated when the
+ * handle was allocated.
+ */
+static bool check_series(inform_series const *series, size_t k,
+    inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    return check_shape(series->data, series->n, series->m, series->b, k, err);
+}
+
+static double block_entropy(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NAN;
+    uint64_t const states_size = histogram_support(b, k);
 
-    size_t const states_size = (size_t) pow((double) b, (double) k);
+    size_t const N = n * (m - k + 1);
 
-    uint32_t *data = calloc(states_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (histogram_prefers_sort(states_size, N))
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        return sorted_block_entropy(series, n, m, b, k, states_size, err);
     }
 
-    size_t const N = n * (m - k + 1);
-
-    inform_dist states = { data, states_size, N };
+    histogram states;
+    if (histograms_init(&states, &states_size, 1, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
 
-    accumulate_observations(series, n, m, b, k, &states);
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    if (inform_accumulate_blocks(accumulate_block, &obs, n, k - 1, m, &states,
+        &states_size, 1, &overflow))
+    {
+        histograms_free(&states, 1);
+        report_failure(series, n, m, b, overflow, err);
+        return NAN;
+    }
 
-    double be = inform_shannon_entropy(&states, 2.0);
+    double be = log2((double) N) - histogram_nlogn(&states) / N;
 
-    free(data);
+    histograms_free(&states, 1);
 
     return be;
 }
 
-double *inform_local_block_entropy(int const *series, size_t n, size_t m, int b,
-    size_t k, double *be, inform_error *err)
+double inform_block_entropy(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NULL;
+    if (check_shape(series, n, m, b, k, err)) return NAN;
+    return block_entropy(series, n, m, b, k, err);
+}
+
+double inform_block_entropy_series(inform_series const *series, size_t k,
+    inform_error *err)
+{
+    if (check_series(series, k, err)) return NAN;
+    return block_entropy(series->data, series->n, series->m, series->b, k,
+        err);
+}
 
+/**
+ * Compute the local block entropy of a series whose shape has been checked,
+ * writing it to a sink.
+ *
+ * @return true on error
+ */
+static bool local_block_entropy(int const *series, size_t n, size_t m, int b,
+    size_t k, local_sink sink, inform_error *err)
+{
     size_t const N = n * (m - k + 1);
 
+    uint64_t const states_size = histogram_support(b, k);
+
+    histogram states;
+    if (histograms_init(&states, &states_size, 1, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    if (inform_accumulate_blocks(accumulate_block, &obs, n, k - 1, m, &states,
+        &states_size, 1, &overflow))
+    {
+        histograms_free(&states, 1);
+        report_failure(series, n, m, b, overflow, err);
+        return true;
+    }
+
+    local_observations(series, n, m, b, k, &states, &sink);
+
+    histograms_free(&states, 1);
+
+    return false;
+}
+
+static double *local_block_entropy_doubles(int const *series, size_t n,
+    size_t m, int b, size_t k, double *be, inform_error *err)
+{
     bool allocate_be = (be == NULL);
     if (allocate_be)
     {
-        be = malloc(N * sizeof(double));
+        be = malloc(n * (m - k + 1) * sizeof(double));
         if (be == NULL)
         {
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
 
-    size_t const states_size = (size_t) pow((double) b, (double) k);
-
-    uint32_t *data = calloc(states_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (local_block_entropy(series, n, m, b, k, local_doubles(be), err))
     {
         if (allocate_be) free(be);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
+    return be;
+}
 
-    inform_dist states = { data, states_size, N };
+static float *local_block_entropy_floats(int const *series, size_t n,
+    size_t m, int b, size_t k, float *be, inform_error *err)
+{
+    bool allocate_be = (be == NULL);
+    if (allocate_be)
+    {
+        be = malloc(n * (m - k + 1) * sizeof(float));
+        if (be == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
 
-    int *state = malloc(N * sizeof(int));
-    if (state == NULL)
+    if (local_block_entropy(series, n, m, b, k, local_floats(be), err))
     {
         if (allocate_be) free(be);
-        free(data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
+    return be;
+}
 
-    accumulate_local_observations(series, n, m, b, k, &states, state);
-
-    double s;
-    for (size_t i = 0; i < N; ++i)
+static inform_local_summary *local_block_entropy_summary(int const *series,
+    size_t n, size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (summary == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    if (local_block_entropy(series, n, m, b, k, local_summary(summary), err))
     {
-        s = states.histogram[state[i]];
-        be[i] = -log2(s/N);
+        return NULL;
     }
+    return summary;
+}
 
-    free(state);
-    free(data);
+double *inform_local_block_entropy(int const *series, size_t n, size_t m, int b,
+    size_t k, double *be, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_block_entropy_doubles(series, n, m, b, k, be, err);
+}
 
-    return be;
+double *inform_local_block_entropy_series(inform_series const *series,
+    size_t k, double *be, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_block_entropy_doubles(series->data, series->n, series->m,
+        series->b, k, be, err);
+}
+
+float *inform_local_block_entropy_float(int const *series, size_t n, size_t m,
+    int b, size_t k, float *be, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_block_entropy_floats(series, n, m, b, k, be, err);
+}
+
+float *inform_local_block_entropy_float_series(inform_series const *series,
+    size_t k, float *be, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_block_entropy_floats(series->data, series->n, series->m,
+        series->b, k, be, err);
+}
+
+inform_local_summary *inform_local_block_entropy_summary(int const *series,
+    size_t n, size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_block_entropy_summary(series, n, m, b, k, summary, err);
+}
+
+inform_local_summary *inform_local_block_entropy_summary_series(
+    inform_series const *series, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_block_entropy_summary(series->data, series->n, series->m,
+        series->b, k, summary, err);
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    return accumulate_observations(series, m, acc->b, acc->k,
+        (observation_block){ 0, 1, acc->k - 1, m }, acc->hs);
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return log2((double) N) - histogram_nlogn(acc->hs) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *be)
+{
+    local_sink sink = local_doubles(be);
+    local_observations(series, 1, m, acc->b, acc->k, acc->hs, &sink);
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_BLOCK_ENTROPY
+};
+
+inform_acc *inform_block_entropy_acc(int b, size_t k, inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    }
+    uint64_t const states_size = histogram_support(b, k);
+    if (states_size == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, &b, 1, k, &states_size,
+        1, err);
+    if (acc != NULL)
+    {
+        acc->b = b;
+        acc->k = k;
+    }
+    return acc;
 }
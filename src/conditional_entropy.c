@@ -3,8 +3,11 @@
 // license that can be found in the LICENSE file.
 #include <inform/conditional_entropy.h>
 #include <inform/shannon.h>
+#include "accumulator.h"
+#include "count.h"
+#include "log_table.h"
 
-static bool check_arguments(int const *xs, int const *ys, size_t n, int bx,
+static bool check_shape(int const *xs, int const *ys, size_t n, int bx,
     int by, inform_error *err)
 {
     if (xs == NULL)
@@ -27,6 +30,16 @@ static bool check_arguments(int const *xs, int const *ys, size_t n, int bx,
     {
         INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
     }
+    return false;
+}
+
+static bool check_arguments(int const *xs, int const *ys, size_t n, int bx,
+    int by, inform_error *err)
+{
+    if (check_shape(xs, ys, n, bx, by, err))
+    {
+        return true;
+    }
     for (size_t i = 0; i < n; ++i)
     {
         if (xs[i] < 0 || ys[i] < 0)
@@ -62,9 +75,9 @@ inline static void accumulate(int const *xs, int const *ys, size_t n, int by,
     x->counts = n;
     xy->counts = n;
 
+    inform_count(x->histogram, x->size, xs, n);
     for (size_t i = 0; i < n; ++i)
     {
-        x->histogram[xs[i]]++;
         xy->histogram[xs[i]*by + ys[i]]++;
     }
 }
@@ -75,11 +88,30 @@ inline static void free_all(inform_dist **x, inform_dist **xy)
     inform_dist_free(*xy);
 }
 
-double inform_conditional_entropy(int const *xs, int const *ys, size_t n,
-    int bx, int by, inform_error *err)
+/**
+ * Check the shapes of a pair of handles, whose states were validated when
+ * the handles were allocated. Each handle is taken as a single series of all
+ * of its time steps.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *xs, inform_series const *ys,
+    inform_error *err)
 {
-    if (check_arguments(xs, ys, n, bx, by, err)) return NAN;
+    if (xs == NULL || ys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (xs->n * xs->m != ys->n * ys->m)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    return check_shape(xs->data, ys->data, xs->n * xs->m, xs->b, ys->b, err);
+}
 
+static double conditional_entropy(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_error *err)
+{
     inform_dist *x = NULL, *xy = NULL;
     if (allocate(bx, by, &x, &xy, err)) return NAN;
 
@@ -92,11 +124,24 @@ double inform_conditional_entropy(int const *xs, int const *ys, size_t n,
     return ce;
 }
 
-double *inform_local_conditional_entropy(int const *xs, int const *ys,
-    size_t n, int bx, int by, double *ce, inform_error *err)
+double inform_conditional_entropy(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_error *err)
 {
-    if (check_arguments(xs, ys, n, bx, by, err)) return NULL;
+    if (check_arguments(xs, ys, n, bx, by, err)) return NAN;
+    return conditional_entropy(xs, ys, n, bx, by, err);
+}
 
+double inform_conditional_entropy_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err)
+{
+    if (check_series(xs, ys, err)) return NAN;
+    return conditional_entropy(xs->data, ys->data, xs->n * xs->m, xs->b,
+        ys->b, err);
+}
+
+static double *local_conditional_entropy(int const *xs, int const *ys,
+    size_t n, int bx, int by, double *ce, inform_error *err)
+{
     bool allocate_ce = (ce == NULL);
     if (allocate_ce)
     {
@@ -114,16 +159,74 @@ double *inform_local_conditional_entropy(int const *xs, int const *ys,
 
     accumulate(xs, ys, n, by, x, xy);
 
-    double s, m;
     for (size_t i = 0; i < n; ++i)
     {
         int z = xs[i]*by + ys[i];
-        s = xy->histogram[z];
-        m = x->histogram[xs[i]];
-        ce[i] = log2(m/s);
+        ce[i] = inform_log2_count(x->histogram[xs[i]]) -
+            inform_log2_count(xy->histogram[z]);
     }
 
     free_all(&x, &xy);
 
     return ce;
-}
\ No newline at end of file
+}
+
+double *inform_local_conditional_entropy(int const *xs, int const *ys,
+    size_t n, int bx, int by, double *ce, inform_error *err)
+{
+    if (check_arguments(xs, ys, n, bx, by, err)) return NULL;
+    return local_conditional_entropy(xs, ys, n, bx, by, ce, err);
+}
+
+double *inform_local_conditional_entropy_series(inform_series const *xs,
+    inform_series const *ys, double *ce, inform_error *err)
+{
+    if (check_series(xs, ys, err)) return NULL;
+    return local_conditional_entropy(xs->data, ys->data, xs->n * xs->m, xs->b,
+        ys->b, ce, err);
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    int const *xs = series, *ys = series + m;
+    int const by = acc->bases[1];
+    bool ok = histogram_count(acc->hs + 1, xs, m);
+    for (size_t i = 0; i < m; ++i)
+    {
+        ok &= histogram_tick(acc->hs, (uint64_t) xs[i]*by + ys[i]);
+    }
+    return !ok;
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return (histogram_nlogn(acc->hs + 1) - histogram_nlogn(acc->hs)) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *ce)
+{
+    int const *xs = series, *ys = series + m;
+    int const by = acc->bases[1];
+    for (size_t i = 0; i < m; ++i)
+    {
+        uint64_t z = (uint64_t) xs[i]*by + ys[i];
+        ce[i] = inform_log2_count(histogram_get(acc->hs + 1, xs[i])) -
+            inform_log2_count(histogram_get(acc->hs, z));
+    }
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_CONDITIONAL_ENTROPY
+};
+
+inform_acc *inform_conditional_entropy_acc(int bx, int by, inform_error *err)
+{
+    if (bx < 2 || by < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    return inform_acc_alloc(&acc_vtable, (int[]){bx, by}, 2, 1,
+        (uint64_t[]){(uint64_t) bx * by, bx}, 2, err);
+}
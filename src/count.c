@@ -0,0 +1,127 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "count.h"
+#include <inform/engine.h>
+#include <stdbool.h>
+#include "thread.h"
+
+/// the fewest events per bin for which summing the sub-histograms pays off
+#define COUNT_MERGE_RATIO 16
+
+/**
+ * Allocate the extra sub-histograms needed to count `n` events, or return
+ * NULL if they are not worth the cost of summing them.
+ */
+static uint32_t *lanes_alloc(size_t size, size_t n)
+{
+    if (size > COUNT_PRIVATE_LIMIT || n < COUNT_MERGE_RATIO * size)
+    {
+        return NULL;
+    }
+    return calloc((COUNT_LANES - 1) * size, sizeof(uint32_t));
+}
+
+static void lanes_merge(uint32_t *histogram, uint32_t *lanes, size_t size,
+    size_t count)
+{
+    for (size_t lane = 0; lane < count; ++lane, lanes += size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            histogram[i] += lanes[i];
+        }
+    }
+}
+
+static void count_serial(uint32_t *histogram, size_t size,
+    int const *events, size_t n)
+{
+    uint32_t *lanes = lanes_alloc(size, n);
+    uint32_t *h0 = histogram, *h1 = histogram, *h2 = histogram, *h3 = histogram;
+    if (lanes != NULL)
+    {
+        h1 = lanes;
+        h2 = lanes + size;
+        h3 = lanes + 2 * size;
+    }
+    size_t i = 0;
+    for (; i + COUNT_LANES <= n; i += COUNT_LANES)
+    {
+        h0[events[i]]++;
+        h1[events[i + 1]]++;
+        h2[events[i + 2]]++;
+        h3[events[i + 3]]++;
+    }
+    for (; i < n; ++i)
+    {
+        h0[events[i]]++;
+    }
+    if (lanes != NULL)
+    {
+        lanes_merge(histogram, lanes, size, COUNT_LANES - 1);
+        free(lanes);
+    }
+}
+
+typedef struct count_job
+{
+    uint32_t *histogram;
+    uint32_t *partials;
+    size_t size;
+    int const *events;
+    size_t n;
+    size_t chunks;
+} count_job;
+
+static void count_chunk(void *arg, size_t index)
+{
+    count_job const *job = arg;
+    size_t const begin = job->n * index / job->chunks;
+    size_t const end = job->n * (index + 1) / job->chunks;
+    uint32_t *histogram = job->histogram;
+    if (index != 0)
+    {
+        histogram = job->partials + (index - 1) * job->size;
+    }
+    count_serial(histogram, job->size, job->events + begin, end - begin);
+}
+
+/**
+ * Count the events across threads, each with its own histogram.
+ *
+ * @return true if the events could not be counted in parallel
+ */
+static bool count_parallel(uint32_t *histogram, size_t size,
+    int const *events, size_t n)
+{
+    size_t chunks = inform_get_num_threads();
+    if (chunks > n / COUNT_THREAD_MIN)
+    {
+        chunks = n / COUNT_THREAD_MIN;
+    }
+    // each extra thread costs a histogram to sum
+    if (chunks < 2 || size > n / chunks)
+    {
+        return true;
+    }
+    uint32_t *partials = calloc((chunks - 1) * size, sizeof(uint32_t));
+    if (partials == NULL)
+    {
+        return true;
+    }
+    count_job job = { histogram, partials, size, events, n, chunks };
+    inform_run_tasks(count_chunk, &job, chunks);
+    lanes_merge(histogram, partials, size, chunks - 1);
+    free(partials);
+    return false;
+}
+
+void inform_count(uint32_t *histogram, size_t size, int const *events,
+    size_t n)
+{
+    if (count_parallel(histogram, size, events, n))
+    {
+        count_serial(histogram, size, events, n);
+    }
+}
@@ -0,0 +1,37 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/// supports no larger than this are counted into private sub-histograms
+#define COUNT_PRIVATE_LIMIT ((size_t) 1 << 12)
+/// the number of sub-histograms the events are spread across
+#define COUNT_LANES 4
+/// the fewest events worth handing to a thread of their own
+#define COUNT_THREAD_MIN ((size_t) 1 << 16)
+
+/**
+ * Add the events to a dense histogram.
+ *
+ * Consecutive events are spread round-robin across `COUNT_LANES`
+ * sub-histograms, which are summed once all of the events are counted, so
+ * that runs of the same event do not serialize on a single counter. The
+ * sub-histograms are only used when the support is small enough to be
+ * cache-resident and the events outnumber the bins, so that the final sum is
+ * cheap. When more than one thread is allowed (see inform_set_num_threads),
+ * large batches of events are also split across threads.
+ *
+ * The events are assumed to lie within @f [0, size) @f; see
+ * inform_valid_prefix for a fast way to check this up front.
+ *
+ * @param[in,out] histogram the histogram
+ * @param[in] size          the size of the histogram's support
+ * @param[in] events        the events to count
+ * @param[in] n             the number of events
+ */
+void inform_count(uint32_t *histogram, size_t size, int const *events,
+    size_t n);
+
@@ -3,8 +3,9 @@
 // license that can be found in the LICENSE file.
 #include <inform/cross_entropy.h>
 #include <inform/shannon.h>
+#include "count.h"
 
-static bool check_arguments(int const *ps, int const *qs, size_t n, int b,
+static bool check_shape(int const *ps, int const *qs, size_t n, int b,
     inform_error *err)
 {
     if (ps == NULL)
@@ -23,6 +24,16 @@ static bool check_arguments(int const *ps, int const *qs, size_t n, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
     }
+    return false;
+}
+
+static bool check_arguments(int const *ps, int const *qs, size_t n, int b,
+    inform_error *err)
+{
+    if (check_shape(ps, qs, n, b, err))
+    {
+        return true;
+    }
     for (size_t i = 0; i < n; ++i)
     {
         if (ps[i] < 0 || qs[i] < 0)
@@ -37,6 +48,28 @@ static bool check_arguments(int const *ps, int const *qs, size_t n, int b,
     return false;
 }
 
+/**
+ * Check the shapes of a pair of handles, whose states were validated when
+ * the handles were allocated. Each handle is taken as a single series of all
+ * of its time steps, and both are valid in the larger of their bases.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *ps, inform_series const *qs,
+    int *b, inform_error *err)
+{
+    if (ps == NULL || qs == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (ps->n * ps->m != qs->n * qs->m)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    *b = (ps->b > qs->b) ? ps->b : qs->b;
+    return check_shape(ps->data, qs->data, ps->n * ps->m, *b, err);
+}
+
 inline static bool allocate(int b, inform_dist **p, inform_dist **q,
     inform_error *err)
 {
@@ -58,11 +91,8 @@ inline static void accumulate(int const *ps, int const *qs, size_t n,
     p->counts = n;
     q->counts = n;
 
-    for (size_t i = 0; i < n; ++i)
-    {
-        p->histogram[ps[i]]++;
-        q->histogram[qs[i]]++;
-    }
+    inform_count(p->histogram, p->size, ps, n);
+    inform_count(q->histogram, q->size, qs, n);
 }
 
 inline static void free_all(inform_dist **p, inform_dist **q)
@@ -71,11 +101,9 @@ inline static void free_all(inform_dist **p, inform_dist **q)
     inform_dist_free(*q);
 }
 
-double inform_cross_entropy(int const *ps, int const *qs, size_t n, int b,
+static double cross_entropy(int const *ps, int const *qs, size_t n, int b,
     inform_error *err)
 {
-    if (check_arguments(ps, qs, n, b, err)) return NAN;
-
     inform_dist *p = NULL, *q = NULL;
     if (allocate(b, &p, &q, err)) return NAN;
 
@@ -87,3 +115,18 @@ double inform_cross_entropy(int const *ps, int const *qs, size_t n, int b,
 
     return ce;
 }
+
+double inform_cross_entropy(int const *ps, int const *qs, size_t n, int b,
+    inform_error *err)
+{
+    if (check_arguments(ps, qs, n, b, err)) return NAN;
+    return cross_entropy(ps, qs, n, b, err);
+}
+
+double inform_cross_entropy_series(inform_series const *ps,
+    inform_series const *qs, inform_error *err)
+{
+    int b;
+    if (check_series(ps, qs, &b, err)) return NAN;
+    return cross_entropy(ps->data, qs->data, ps->n * ps->m, b, err);
+}
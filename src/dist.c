@@ -2,8 +2,14 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/dist.h>
+#include <inform/engine.h>
+#include <limits.h>
 #include <string.h>
 #include <math.h>
+#include "count.h"
+#include "serialize.h"
+#include "simd.h"
+#include "thread.h"
 
 inform_dist* inform_dist_alloc(size_t n)
 {
@@ -409,16 +415,208 @@ size_t inform_dist_accumulate(inform_dist *dist, int const *events, size_t n)
     {
         return 0;
     }
-    // loop over the events and add them to the distribution
-    int const size = (int)dist->size;
-    size_t i = 0;
-    while (i < n)
+    // find the events that precede the first invalid one, and count them
+    uint32_t const bound = (dist->size > INT_MAX) ?
+        (uint32_t) INT_MAX + 1 : (uint32_t) dist->size;
+    size_t const valid = inform_valid_prefix(events, n, bound);
+    inform_count(dist->histogram, dist->size, events, valid);
+    dist->counts += valid;
+    return valid;
+}
+
+inform_dist* inform_dist_merge(inform_dist const *src, inform_dist *dest)
+{
+    if (src == NULL || dest == NULL || src->size != dest->size)
+    {
+        return NULL;
+    }
+    if (inform_add_counts(dest->histogram, src->histogram, dest->size))
+    {
+        return NULL;
+    }
+    dest->counts += src->counts;
+    return dest;
+}
+
+inform_dist* inform_dist_subtract(inform_dist const *src, inform_dist *dest)
+{
+    if (src == NULL || dest == NULL || src->size != dest->size)
+    {
+        return NULL;
+    }
+    if (inform_subtract_counts(dest->histogram, src->histogram, dest->size))
+    {
+        return NULL;
+    }
+    dest->counts -= src->counts;
+    return dest;
+}
+
+typedef struct scatter_job
+{
+    int const *events;
+    size_t n;
+    inform_dist **parts;
+    size_t k;
+    size_t tasks;
+} scatter_job;
+
+static void scatter_parts(void *arg, size_t index)
+{
+    scatter_job const *job = arg;
+    for (size_t i = index; i < job->k; i += job->tasks)
+    {
+        size_t const begin = job->n * i / job->k;
+        size_t const end = job->n * (i + 1) / job->k;
+        inform_count(job->parts[i]->histogram, job->parts[i]->size,
+            job->events + begin, end - begin);
+        job->parts[i]->counts += end - begin;
+    }
+}
+
+size_t inform_dist_scatter(int const *events, size_t n, inform_dist **parts,
+    size_t k)
+{
+    if (events == NULL || parts == NULL || k == 0)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (parts[i] == NULL || parts[i]->size == 0 ||
+            parts[i]->size != parts[0]->size)
+        {
+            return 0;
+        }
+    }
+
+    uint32_t const bound = (parts[0]->size > INT_MAX) ?
+        (uint32_t) INT_MAX + 1 : (uint32_t) parts[0]->size;
+    size_t const valid = inform_valid_prefix(events, n, bound);
+
+    size_t tasks = inform_get_num_threads();
+    if (tasks > k)
     {
-        if (size <= *events || *events < 0) break;
-        dist->histogram[*events] += 1;
-        dist->counts += 1;
-        ++events;
-        ++i;
+        tasks = k;
     }
-    return i;
+    scatter_job job = { events, valid, parts, k, tasks };
+    inform_run_tasks(scatter_parts, &job, tasks);
+    return valid;
+}
+
+inform_dist* inform_dist_gather(inform_dist * const *parts, size_t k,
+    inform_dist *dest)
+{
+    if (parts == NULL || dest == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (parts[i] == NULL || parts[i]->size != dest->size)
+        {
+            return NULL;
+        }
+    }
+
+    // sum into a scratch copy so that an overflow leaves dest untouched
+    inform_dist *sum = inform_dist_dup(dest);
+    if (sum == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (inform_dist_merge(parts[i], sum) == NULL)
+        {
+            inform_dist_free(sum);
+            return NULL;
+        }
+    }
+
+    uint32_t *histogram = dest->histogram;
+    dest->histogram = sum->histogram;
+    dest->counts = sum->counts;
+    sum->histogram = histogram;
+    inform_dist_free(sum);
+    return dest;
+}
+
+size_t inform_dist_serialize(inform_dist const *dist, uint8_t *buffer,
+    size_t n)
+{
+    if (dist == NULL || dist->size == 0)
+    {
+        return 0;
+    }
+    serial_writer w = { buffer, n, 0 };
+    serial_put_header(&w, "INFD");
+    serial_put_counts(&w, dist->size, NULL, dist->histogram, dist->size);
+    return w.size;
+}
+
+inform_dist* inform_dist_deserialize(uint8_t const *buffer, size_t n,
+    size_t *used)
+{
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    serial_reader r = { buffer, n, 0, false };
+    serial_get_header(&r, "INFD");
+    // peek at the support, which leads the block of counts
+    serial_reader peek = r;
+    uint64_t const size = serial_get_varint(&peek);
+    if (peek.failed || size == 0 || size > SIZE_MAX / sizeof(uint32_t))
+    {
+        return NULL;
+    }
+    inform_dist *dist = inform_dist_alloc((size_t) size);
+    if (dist == NULL)
+    {
+        return NULL;
+    }
+    histogram h = { *dist, NULL };
+    if (serial_get_histogram(&r, &h, size) != INFORM_SUCCESS)
+    {
+        inform_dist_free(dist);
+        return NULL;
+    }
+    dist->counts = h.dense.counts;
+    if (used != NULL)
+    {
+        *used = r.pos;
+    }
+    return dist;
+}
+
+size_t inform_dist_save(inform_dist const *dist, char const *path)
+{
+    size_t const n = inform_dist_serialize(dist, NULL, 0);
+    uint8_t *buffer = (n == 0 || path == NULL) ? NULL : malloc(n);
+    if (buffer == NULL)
+    {
+        return 0;
+    }
+    inform_dist_serialize(dist, buffer, n);
+    bool const failed = serial_write_file(path, buffer, n);
+    free(buffer);
+    return failed ? 0 : n;
+}
+
+inform_dist* inform_dist_load(char const *path)
+{
+    if (path == NULL)
+    {
+        return NULL;
+    }
+    size_t n = 0;
+    uint8_t *buffer = serial_read_file(path, &n, NULL);
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    inform_dist *dist = inform_dist_deserialize(buffer, n, NULL);
+    free(buffer);
+    return dist;
 }
@@ -0,0 +1,46 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/engine.h>
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+static THREAD_LOCAL inform_engine current_engine = INFORM_ENGINE_AUTO;
+static THREAD_LOCAL size_t current_num_threads = 1;
+
+void inform_set_engine(inform_engine engine)
+{
+    switch (engine)
+    {
+        case INFORM_ENGINE_AUTO:
+        case INFORM_ENGINE_DENSE:
+        case INFORM_ENGINE_SPARSE:
+        case INFORM_ENGINE_SORT:
+            current_engine = engine;
+            break;
+        default:
+            break;
+    }
+}
+
+inform_engine inform_get_engine(void)
+{
+    return current_engine;
+}
+
+void inform_set_num_threads(size_t n)
+{
+    if (n != 0)
+    {
+        current_num_threads = n;
+    }
+}
+
+size_t inform_get_num_threads(void)
+{
+    return current_num_threads;
+}
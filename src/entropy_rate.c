@@ -3,66 +3,192 @@
 // license that can be found in the LICENSE file.
 #include <inform/entropy_rate.h>
 #include <inform/shannon.h>
+#include "accumulator.h"
+#include "failure.h"
+#include "fused.h"
+#include "histogram.h"
+#include "local.h"
+#include "partition.h"
+#include "radix_sort.h"
+#include "series.h"
+#include "windowed.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories)
+/**
+ * Accumulate a block of the observations of a series, validating each state
+ * as it is read.
+ *
+ * @return true if a state is invalid, in which case the accumulation stops,
+ *         or if out of memory
+ */
+static bool accumulate_observations(int const* series, size_t m, int b,
+    size_t k, observation_block block, histogram *states,
+    histogram *histories)
 {
-    for (size_t i = 0; i < n; ++i, series += m)
+    bool ok = true;
+    series += block.begin * m;
+    for (size_t i = block.begin; i < block.end; ++i, series += m)
     {
-        int history = 0, q = 1, state, future;
-        for (size_t j = 0; j < k; ++j)
+        uint64_t history = 0, q = 1, state, future;
+        for (size_t j = block.first - k; j < block.first; ++j)
         {
+            if (inform_invalid_event(series[j], b)) return true;
             q *= b;
             history *= b;
             history += series[j];
         }
-        for (size_t j = k; j < m; ++j)
+        for (size_t j = block.first; j < block.last; ++j)
         {
+            if (inform_invalid_event(series[j], b)) return true;
             future = series[j];
             state  = history * b + future;
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
+            ok &= histogram_tick(states, state);
+            ok &= histogram_tick(histories, history);
 
             history = state - series[j - k]*q;
         }
     }
+    return !ok;
+}
+
+/// the arguments shared by every block of a series' observations
+typedef struct observations
+{
+    int const *series;
+    size_t m;
+    int b;
+    size_t k;
+} observations;
+
+static bool accumulate_block(void const *arg, observation_block block,
+    histogram *hs)
+{
+    observations const *obs = arg;
+    return accumulate_observations(obs->series, obs->m, obs->b, obs->k, block,
+        hs, hs + 1);
+}
+
+/**
+ * Accumulate the observations of series whose histories have already been
+ * encoded, e.g. by inform_series_encode.
+ */
+static bool accumulate_encoded_observations(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k,
+    histogram *states, histogram *histories)
+{
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        for (size_t j = k; j < m; ++j)
+        {
+            uint64_t const history = *encoded++;
+            ok &= histogram_tick(states, history * b + series[j]);
+            ok &= histogram_tick(histories, history);
+        }
+    }
+    return !ok;
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    int *state, int *history)
+/**
+ * Compute the local entropy rate of each observation of a series,
+ * re-encoding the observations rather than storing them as they were
+ * accumulated.
+ */
+static void local_observations(int const *series, size_t n, size_t m, int b,
+    size_t k, histogram const *states, histogram const *histories,
+    local_sink *sink)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        int q = 1;
-        history[0] = 0;
+        uint64_t history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            history *= b;
+            history += series[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            state[l]  = history[l] * b + series[j];
-
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
+            state = history * b + series[j];
+            local_emit(sink,
+                inform_log2_count(histogram_get(histories, history)) -
+                inform_log2_count(histogram_get(states, state)));
+            history = state - series[j - k]*q;
+        }
+    }
+}
 
-            if (j + 1 != m)
+/**
+ * Encode the observations of a series, validating each state as it is read
+ * unless the histories have already been encoded.
+ *
+ * @return true if a state is invalid
+ */
+static bool encode_observations(int const* series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, uint64_t *states)
+{
+    if (encoded != NULL)
+    {
+        for (size_t i = 0; i < n; ++i, series += m)
+        {
+            for (size_t j = k; j < m; ++j)
             {
-                history[l + 1] = state[l] - series[l]*q;
+                *states++ = *encoded++ * b + series[j];
             }
         }
-        series += m;
-        state += (m - k);
-        history += (m - k);
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0, q = 1, state;
+        for (size_t j = 0; j < k; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            q *= b;
+            history *= b;
+            history += series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            if (inform_invalid_event(series[j], b)) return true;
+            state = history * b + series[j];
+            *states++ = state;
+            history = state - series[j - k]*q;
+        }
     }
+    return false;
 }
 
-static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t k, inform_error *err)
+static double sorted_entropy_rate(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, uint64_t states_size,
+    inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t *keys = malloc(2 * N * sizeof(uint64_t));
+    if (keys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    if (encode_observations(series, encoded, n, m, b, k, keys))
+    {
+        free(keys);
+        report_failure(series, n, m, b, false, err);
+        return NAN;
+    }
+    uint64_t const *states = inform_radix_sort(keys, keys + N, N, states_size - 1);
+
+    double er = (inform_sorted_nlogn(states, N, b) -
+        inform_sorted_nlogn(states, N, 1)) / N;
+
+    free(keys);
+
+    return er;
+}
+
+static bool check_shape(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
 {
     if (series == NULL)
     {
@@ -88,104 +214,325 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    else if (histogram_support(b, k + 1) == 0)
     {
-        if (series[i] < 0)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-        }
-        else if (b <= series[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
     return false;
 }
 
-double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+/**
+ * Check the shape of a handle's series, whose states were validated when the
+ * handle was allocated.
+ */
+static bool check_series(inform_series const *series, size_t k,
+    inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NAN;
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    return check_shape(series->data, series->n, series->m, series->b, k, err);
+}
 
+static double entropy_rate(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, inform_error *err)
+{
     size_t const N = n * (m - k);
 
-    size_t const states_size = (size_t) (b * pow((double) b, (double) k));
-    size_t const histories_size = states_size / b;
-    size_t const total_size = states_size + histories_size;
+    uint64_t const states_size = histogram_support(b, k + 1);
+    uint64_t const histories_size = states_size / b;
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (histogram_prefers_sort(states_size, N))
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        return sorted_entropy_rate(series, encoded, n, m, b, k, states_size,
+            err);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
+    uint64_t const sizes[2] = {states_size, histories_size};
+    histogram hs[2];
+    if (histograms_init(hs, sizes, 2, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    histogram *states = hs, *histories = hs + 1;
 
-    accumulate_observations(series, n, m, b, k, &states, &histories);
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            2, &overflow) :
+        accumulate_encoded_observations(series, encoded, n, m, b, k, states,
+            histories);
+    if (failed)
+    {
+        histograms_free(hs, 2);
+        report_failure(series, n, m, b, overflow, err);
+        return NAN;
+    }
 
-    double er = inform_shannon_ce(&states, &histories, 2.0);
+    double er = (histogram_nlogn(histories) - histogram_nlogn(states)) / N;
 
-    free(data);
+    histograms_free(hs, 2);
 
     return er;
 }
 
-double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
-    size_t k, double *er, inform_error *err)
+double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NAN;
+    return entropy_rate(series, NULL, n, m, b, k, err);
+}
+
+double inform_entropy_rate_series(inform_series const *series, size_t k,
+    inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NULL;
+    if (check_series(series, k, err)) return NAN;
+    return entropy_rate(series->data, inform_series_histories(series, k),
+        series->n, series->m, series->b, k, err);
+}
 
+/**
+ * Compute the local entropy rate of a series whose shape has been checked,
+ * writing it to a sink. The histories are encoded as they are accumulated
+ * unless `encoded` holds them already.
+ *
+ * @return true on error
+ */
+static bool local_entropy_rate(int const *series, uint64_t const *encoded,
+    size_t n, size_t m, int b, size_t k, local_sink sink, inform_error *err)
+{
     size_t const N = n * (m - k);
 
+    uint64_t const states_size = histogram_support(b, k + 1);
+    uint64_t const histories_size = states_size / b;
+
+    uint64_t const sizes[2] = {states_size, histories_size};
+    histogram hs[2];
+    if (histograms_init(hs, sizes, 2, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    histogram *states = hs, *histories = hs + 1;
+
+    observations const obs = { series, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            2, &overflow) :
+        accumulate_encoded_observations(series, encoded, n, m, b, k, states,
+            histories);
+    if (failed)
+    {
+        histograms_free(hs, 2);
+        report_failure(series, n, m, b, overflow, err);
+        return true;
+    }
+
+    local_observations(series, n, m, b, k, states, histories, &sink);
+
+    histograms_free(hs, 2);
+
+    return false;
+}
+
+static double *local_entropy_rate_doubles(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k, double *er,
+    inform_error *err)
+{
     bool allocate_er = (er == NULL);
     if (allocate_er)
     {
-        er = malloc(N * sizeof(double));
+        er = malloc(n * (m - k) * sizeof(double));
         if (er == NULL)
         {
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
 
-    size_t const states_size = (size_t) (b * pow((double) b, (double) k));
-    size_t const histories_size = states_size / b;
-    size_t const total_size = states_size + histories_size;
-
-    uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
-    if (histogram_data == NULL)
+    if (local_entropy_rate(series, encoded, n, m, b, k, local_doubles(er), err))
     {
         if (allocate_er) free(er);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
+    return er;
+}
 
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
-
+static float *local_entropy_rate_floats(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k, float *er,
+    inform_error *err)
+{
+    bool allocate_er = (er == NULL);
+    if (allocate_er)
+    {
+        er = malloc(n * (m - k) * sizeof(float));
+        if (er == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
 
-    int *state_data = malloc(2 * N * sizeof(uint64_t));
-    if (state_data == NULL)
+    if (local_entropy_rate(series, encoded, n, m, b, k, local_floats(er), err))
     {
         if (allocate_er) free(er);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
     }
-    int *state = state_data;
-    int *history = state + N;
+    return er;
+}
+
+static inform_local_summary *local_entropy_rate_summary(int const *series,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k,
+    inform_local_summary *summary, inform_error *err)
+{
+    if (summary == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    if (local_entropy_rate(series, encoded, n, m, b, k, local_summary(summary),
+        err))
+    {
+        return NULL;
+    }
+    return summary;
+}
+
+double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
+    size_t k, double *er, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_entropy_rate_doubles(series, NULL, n, m, b, k, er, err);
+}
+
+double *inform_local_entropy_rate_series(inform_series const *series,
+    size_t k, double *er, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_entropy_rate_doubles(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, er, err);
+}
+
+float *inform_local_entropy_rate_float(int const *series, size_t n, size_t m,
+    int b, size_t k, float *er, inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_entropy_rate_floats(series, NULL, n, m, b, k, er, err);
+}
+
+float *inform_local_entropy_rate_float_series(inform_series const *series,
+    size_t k, float *er, inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_entropy_rate_floats(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, er, err);
+}
+
+inform_local_summary *inform_local_entropy_rate_summary(int const *series,
+    size_t n, size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+    return local_entropy_rate_summary(series, NULL, n, m, b, k, summary, err);
+}
+
+inform_local_summary *inform_local_entropy_rate_summary_series(
+    inform_series const *series, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (check_series(series, k, err)) return NULL;
+    return local_entropy_rate_summary(series->data,
+        inform_series_histories(series, k), series->n, series->m, series->b,
+        k, summary, err);
+}
 
-    accumulate_local_observations(series, n, m, b, k, &states, &histories,
-        state, history);
+double *inform_entropy_rate_sweep(int const *series, size_t n, size_t m,
+    int b, size_t kmax, double *er, inform_error *err)
+{
+    return inform_fused_sweep(series, n, m, b, INFORM_FUSED_ENTROPY_RATE, kmax,
+        er, err);
+}
 
-    double s, h;
-    for (size_t i = 0; i < N; ++i)
+static void windowed_encode(windowed_measure const *measure, size_t i,
+    size_t j, uint64_t *events)
+{
+    int const *series = measure->series[0] + i * measure->m;
+    int const b = measure->b;
+    uint64_t history = 0;
+    for (size_t t = j - measure->k; t < j; ++t)
     {
-        s = states.histogram[state[i]];
-        h = histories.histogram[history[i]];
-        er[i] = log2(h/s);
+        history = history * b + series[t];
     }
+    events[0] = history * b + series[j];
+    events[1] = history;
+}
 
-    free(state_data);
-    free(histogram_data);
+static double windowed_value(double const *nlogn, uint64_t N)
+{
+    return (nlogn[1] - nlogn[0]) / N;
+}
 
-    return er;
+double *inform_entropy_rate_windowed(int const *series, size_t n, size_t m,
+    int b, size_t k, size_t window, size_t stride, double *er,
+    inform_error *err)
+{
+    if (check_shape(series, n, m, b, k, err)) return NULL;
+
+    uint64_t const states_size = histogram_support(b, k + 1);
+    windowed_measure const measure = {
+        .series = { series }, .streams = 1, .n = n, .m = m, .k = k, .b = b,
+        .nhs = 2, .sizes = { states_size, states_size / b },
+        .encode = windowed_encode, .value = windowed_value
+    };
+    return inform_windowed(&measure, window, stride, er, err);
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    return accumulate_observations(series, m, acc->b, acc->k,
+        (observation_block){ 0, 1, acc->k, m }, acc->hs, acc->hs + 1);
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return (histogram_nlogn(acc->hs + 1) - histogram_nlogn(acc->hs)) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *er)
+{
+    local_sink sink = local_doubles(er);
+    local_observations(series, 1, m, acc->b, acc->k, acc->hs, acc->hs + 1,
+        &sink);
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_ENTROPY_RATE
+};
+
+inform_acc *inform_entropy_rate_acc(int b, size_t k, inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    }
+    uint64_t const states_size = histogram_support(b, k + 1);
+    if (states_size == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, &b, 1, k + 1,
+        (uint64_t[]){states_size, states_size / b}, 2, err);
+    if (acc != NULL)
+    {
+        acc->b = b;
+        acc->k = k;
+    }
+    return acc;
 }
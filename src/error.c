@@ -42,6 +42,8 @@ char const *inform_strerror(inform_error const *err)
         case INFORM_ETPMROW:      return "all zero row in TPM";
         case INFORM_ESIZE:        return "invalid size";
         case INFORM_EPARTS:       return "invalid partitioning";
+        case INFORM_EFORMAT:      return "malformed serialized data";
+        case INFORM_EIO:          return "file input/output failed";
         default:                  return "unrecognized error";
     }
 }
@@ -11,8 +11,25 @@ double inform_excess_entropy(int const *series, size_t n, size_t m, int b,
     return inform_predictive_info(series, n, m, b, k, k, err);
 }
 
+double inform_excess_entropy_series(inform_series const *series, size_t k,
+    inform_error *err)
+{
+    return inform_predictive_info_series(series, k, k, err);
+}
+
 double *inform_local_excess_entropy(int const *series, size_t n, size_t m,
     int b, size_t k, double *ee, inform_error *err)
 {
     return inform_local_predictive_info(series, n, m, b, k, k, ee, err);
 }
+
+double *inform_local_excess_entropy_series(inform_series const *series,
+    size_t k, double *ee, inform_error *err)
+{
+    return inform_local_predictive_info_series(series, k, k, ee, err);
+}
+
+inform_acc *inform_excess_entropy_acc(int b, size_t k, inform_error *err)
+{
+    return inform_predictive_info_acc(b, k, k, err);
+}
@@ -0,0 +1,45 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Report why the observations of a series could not be accumulated.
+ *
+ * The states are validated as they are accumulated, which stops at the
+ * first invalid one; only then is the series scanned again, to report the
+ * same error as a scan before accumulation would. Otherwise, a count
+ * overflowed when the histograms of several threads were added, or memory
+ * ran out.
+ *
+ * @param[in] series   the series that was accumulated
+ * @param[in] n        the number of initial conditions
+ * @param[in] m        the number of time steps per initial condition
+ * @param[in] b        the base of the series
+ * @param[in] overflow whether the histograms overflowed when they were added
+ * @param[out] err     the error to report
+ */
+static inline void report_failure(int const *series, size_t n, size_t m,
+    int b, bool overflow, inform_error *err)
+{
+    if (overflow)
+    {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_FAILURE);
+    }
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        if (series[i] < 0)
+        {
+            INFORM_ERROR_RETURN_VOID(err, INFORM_ENEGSTATE);
+        }
+        else if (b <= series[i])
+        {
+            INFORM_ERROR_RETURN_VOID(err, INFORM_EBADSTATE);
+        }
+    }
+    INFORM_ERROR(err, INFORM_ENOMEM);
+}
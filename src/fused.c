@@ -0,0 +1,417 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "fused.h"
+#include "histogram.h"
+
+/**
+ * Get the length of the blocks a measure observes, e.g. a history together
+ * with its future for the active information.
+ */
+static size_t block_length(inform_fused_spec const *spec)
+{
+    switch (spec->measure)
+    {
+        case INFORM_FUSED_ACTIVE_INFO:
+        case INFORM_FUSED_ENTROPY_RATE:
+            return spec->k + 1;
+        case INFORM_FUSED_BLOCK_ENTROPY:
+            return spec->k;
+        case INFORM_FUSED_EXCESS_ENTROPY:
+            return 2 * spec->k;
+        default:
+            return spec->k + spec->kfuture;
+    }
+}
+
+static bool check_spec(inform_fused_spec const *spec, size_t m, int b,
+    inform_error *err)
+{
+    bool const pi = spec->measure == INFORM_FUSED_PREDICTIVE_INFO;
+    if ((unsigned) spec->measure > INFORM_FUSED_PREDICTIVE_INFO)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (spec->k == 0 || (pi && spec->kfuture == 0))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (m <= spec->k || (pi && m <= spec->kfuture))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+
+    size_t const L = block_length(spec);
+    bool const joint = pi || spec->measure == INFORM_FUSED_EXCESS_ENTROPY;
+    if (joint && m <= L)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    else if (histogram_support(b, L) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    return false;
+}
+
+static bool check_shape(int const *series, size_t n, size_t m, int b,
+    inform_fused_spec const *specs, size_t count, inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, true);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    else if (specs == NULL || count == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (check_spec(specs + i, m, b, err))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool check_arguments(int const *series, size_t n, size_t m, int b,
+    inform_fused_spec const *specs, size_t count, inform_error *err)
+{
+    if (check_shape(series, n, m, b, specs, count, err))
+    {
+        return true;
+    }
+    size_t const i = inform_valid_prefix(series, n * m, b);
+    if (i != n * m)
+    {
+        INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+            INFORM_EBADSTATE, true);
+    }
+    return false;
+}
+
+/**
+ * Add a number of observations of an event.
+ *
+ * @return false if the sparse table could not grow to hold the event
+ */
+static bool histogram_tick_by(histogram *h, uint64_t event, uint32_t count)
+{
+    if (h->sparse == NULL)
+    {
+        h->dense.histogram[event] += count;
+        h->dense.counts += count;
+        return true;
+    }
+    return inform_sparse_dist_set(h->sparse, event,
+        inform_sparse_dist_get(h->sparse, event) + count) != 0;
+}
+
+/**
+ * Add the counts of a histogram of blocks to a histogram of their sub-blocks,
+ * each block being mapped to `(block / divisor) % modulus`.
+ *
+ * @return false if the sparse table could not grow to hold the events
+ */
+static bool marginalize(histogram *dest, histogram const *src,
+    uint64_t divisor, uint64_t modulus)
+{
+    uint32_t const *counts = src->dense.histogram;
+    size_t n = src->dense.size;
+    if (src->sparse != NULL)
+    {
+        counts = src->sparse->histogram;
+        n = src->sparse->capacity;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (counts[i] != 0)
+        {
+            uint64_t const event = (src->sparse == NULL) ? i : src->sparse->events[i];
+            ok &= histogram_tick_by(dest, (event / divisor) % modulus, counts[i]);
+        }
+    }
+    return ok;
+}
+
+/**
+ * Count every length-`w` block of each time series, with the first time step
+ * of the block as its most significant digit.
+ *
+ * @return true if out of memory
+ */
+static bool accumulate_blocks(int const *series, size_t n, size_t m, int b,
+    size_t w, histogram *blocks)
+{
+    bool ok = true;
+    uint64_t const q = histogram_support(b, w - 1);
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t block = 0;
+        for (size_t j = 0; j + 1 < w; ++j)
+        {
+            block = block * b + series[j];
+        }
+        for (size_t j = w - 1; j < m; ++j)
+        {
+            block = block * b + series[j];
+            ok &= histogram_tick(blocks, block);
+            block -= series[j + 1 - w] * q;
+        }
+    }
+    return !ok;
+}
+
+/**
+ * Derive the histogram of every length-`l` block from that of the longer
+ * length-`w` blocks: each long block begins with a short one, and the only
+ * short blocks which do not begin a long one are those in the last `w - 1`
+ * time steps of each series.
+ *
+ * @return true if out of memory
+ */
+static bool derive_blocks(int const *series, size_t n, size_t m, int b,
+    size_t w, size_t l, histogram const *blocks, histogram *states)
+{
+    bool ok = marginalize(states, blocks, histogram_support(b, w - l),
+        histogram_support(b, l));
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        for (size_t p = m - w + 1; p + l <= m; ++p)
+        {
+            uint64_t state = 0;
+            for (size_t j = p; j < p + l; ++j)
+            {
+                state = state * b + series[j];
+            }
+            ok &= histogram_tick(states, state);
+        }
+    }
+    return !ok;
+}
+
+/**
+ * Compute @f \sum_i c_i \log_2 c_i @f over the marginal counts of the
+ * sub-blocks of a histogram of length-`l` blocks, i.e. of their first
+ * `len` time steps (if `prefix`) or their last `len`.
+ *
+ * @return true if out of memory
+ */
+static bool marginal_nlogn(histogram const *states, int b, size_t l,
+    size_t len, bool prefix, size_t N, double *s)
+{
+    uint64_t const size = histogram_support(b, len);
+    uint64_t const divisor = prefix ? histogram_support(b, l - len) : 1;
+    histogram marginal;
+    if (histograms_init(&marginal, &size, 1, N))
+    {
+        return true;
+    }
+    bool const failed = !marginalize(&marginal, states, divisor, size);
+    if (!failed)
+    {
+        *s = histogram_nlogn(&marginal);
+    }
+    histograms_free(&marginal, 1);
+    return failed;
+}
+
+/**
+ * Compute every measure whose blocks have length `l` from their histogram.
+ *
+ * The marginals are memoized by length, as several measures, e.g. the active
+ * information and entropy rate, share them.
+ *
+ * @return true if out of memory
+ */
+static bool compute_measures(inform_fused_spec const *specs, size_t count,
+    int b, size_t l, histogram const *states, size_t N, double *values)
+{
+    double prefixes[HISTOGRAM_MAX_BITS + 1], suffixes[HISTOGRAM_MAX_BITS + 1];
+    bool have_prefix[HISTOGRAM_MAX_BITS + 1] = { false };
+    bool have_suffix[HISTOGRAM_MAX_BITS + 1] = { false };
+
+    double const s = histogram_nlogn(states);
+    for (size_t i = 0; i < count; ++i)
+    {
+        inform_fused_spec const *spec = specs + i;
+        if (block_length(spec) != l)
+        {
+            continue;
+        }
+        if (spec->measure == INFORM_FUSED_BLOCK_ENTROPY)
+        {
+            values[i] = log2((double) N) - s / N;
+            continue;
+        }
+
+        // the histories, and for all but the entropy rate the futures
+        size_t const past = spec->k, future = l - past;
+        if (!have_prefix[past])
+        {
+            if (marginal_nlogn(states, b, l, past, true, N, prefixes + past))
+            {
+                return true;
+            }
+            have_prefix[past] = true;
+        }
+        if (spec->measure == INFORM_FUSED_ENTROPY_RATE)
+        {
+            values[i] = (prefixes[past] - s) / N;
+            continue;
+        }
+        if (!have_suffix[future])
+        {
+            if (marginal_nlogn(states, b, l, future, false, N, suffixes + future))
+            {
+                return true;
+            }
+            have_suffix[future] = true;
+        }
+        values[i] = log2((double) N) + (s - prefixes[past] - suffixes[future]) / N;
+    }
+    return false;
+}
+
+/**
+ * Get the longest block length, shorter than `l`, needed by any measure.
+ *
+ * @return the length, or 0 if there is none
+ */
+static size_t next_length(inform_fused_spec const *specs, size_t count,
+    size_t l)
+{
+    size_t next = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t const length = block_length(specs + i);
+        if (length < l && length > next)
+        {
+            next = length;
+        }
+    }
+    return next;
+}
+
+static double *fused_measures(int const *series, size_t n, size_t m, int b,
+    inform_fused_spec const *specs, size_t count, double *values,
+    inform_error *err)
+{
+    size_t w = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t const l = block_length(specs + i);
+        w = (l > w) ? l : w;
+    }
+
+    bool allocate_values = (values == NULL);
+    if (allocate_values)
+    {
+        values = malloc(count * sizeof(double));
+        if (values == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    uint64_t const blocks_size = histogram_support(b, w);
+    histogram states;
+    if (histograms_init(&states, &blocks_size, 1, n * (m - w + 1)))
+    {
+        if (allocate_values) free(values);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    bool failed = accumulate_blocks(series, n, m, b, w, &states);
+
+    // the distinct block lengths are visited longest first, each histogram
+    // being derived from the one before it, which is at most b times larger
+    size_t l = w;
+    while (!failed)
+    {
+        failed = compute_measures(specs, count, b, l, &states,
+            n * (m - l + 1), values);
+        size_t const next = next_length(specs, count, l);
+        if (failed || next == 0)
+        {
+            break;
+        }
+        uint64_t const shorter_size = histogram_support(b, next);
+        histogram shorter;
+        if (histograms_init(&shorter, &shorter_size, 1, n * (m - next + 1)))
+        {
+            failed = true;
+            break;
+        }
+        failed = derive_blocks(series, n, m, b, l, next, &states, &shorter);
+        histograms_free(&states, 1);
+        states = shorter;
+        l = next;
+    }
+    histograms_free(&states, 1);
+
+    if (failed)
+    {
+        if (allocate_values) free(values);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return values;
+}
+
+double *inform_fused_measures(int const *series, size_t n, size_t m, int b,
+    inform_fused_spec const *specs, size_t count, double *values,
+    inform_error *err)
+{
+    if (check_arguments(series, n, m, b, specs, count, err)) return NULL;
+    return fused_measures(series, n, m, b, specs, count, values, err);
+}
+
+double *inform_fused_measures_series(inform_series const *series,
+    inform_fused_spec const *specs, size_t count, double *values,
+    inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+    }
+    else if (check_shape(series->data, series->n, series->m, series->b, specs,
+        count, err))
+    {
+        return NULL;
+    }
+    return fused_measures(series->data, series->n, series->m, series->b,
+        specs, count, values, err);
+}
+
+double *inform_fused_sweep(int const *series, size_t n, size_t m, int b,
+    inform_fused_measure measure, size_t kmax, double *values,
+    inform_error *err)
+{
+    // a single spec with k = 0 lets the usual checks report INFORM_EKZERO
+    size_t const count = (kmax == 0) ? 1 : kmax;
+    inform_fused_spec *specs = malloc(count * sizeof(inform_fused_spec));
+    if (specs == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        specs[i] = (inform_fused_spec){ measure, (kmax == 0) ? 0 : i + 1, 0 };
+    }
+    values = inform_fused_measures(series, n, m, b, specs, count, values, err);
+    free(specs);
+    return values;
+}
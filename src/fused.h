@@ -0,0 +1,24 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/fused.h>
+
+/**
+ * Compute a measure at every history length from 1 to `kmax` in one pass,
+ * storing the value for history length `k` at `values[k - 1]`.
+ *
+ * @param[in] series  the ensemble of time series
+ * @param[in] n       the number of initial conditions
+ * @param[in] m       the number of time steps in each time series
+ * @param[in] b       the base of the time series
+ * @param[in] measure the measure, which must take a single history length
+ * @param[in] kmax    the longest history length
+ * @param[out] values the values, or NULL to allocate them
+ * @param[out] err    an error structure
+ * @return a pointer to the values
+ */
+double *inform_fused_sweep(int const *series, size_t n, size_t m, int b,
+    inform_fused_measure measure, size_t kmax, double *values,
+    inform_error *err);
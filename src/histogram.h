@@ -0,0 +1,439 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/dist.h>
+#include <inform/engine.h>
+#include <inform/shannon.h>
+#include <inform/sparse_dist.h>
+#include <string.h>
+#include "count.h"
+#include "log_table.h"
+#include "simd.h"
+
+/// supports no larger than this are always stored densely
+#define HISTOGRAM_DENSE_LIMIT ((size_t) 1 << 16)
+/// the largest initial table requested for a sparse histogram
+#define HISTOGRAM_SPARSE_HINT ((size_t) 1 << 16)
+/// the largest number of bits in any encoded state
+#define HISTOGRAM_MAX_BITS 63
+
+/**
+ * A histogram of encoded states used by the time series measures
+ *
+ * The histogram is stored densely, as an inform_dist, when its support is
+ * small relative to the number of observations, and sparsely, as an
+ * inform_sparse_dist, when the support dwarfs the number of observations.
+ * Either way, the memory required scales with min(support, observations).
+ */
+typedef struct histogram
+{
+    /// the dense histogram, used whenever sparse is NULL
+    inform_dist dense;
+    /// the sparse histogram, if one is in use
+    inform_sparse_dist *sparse;
+} histogram;
+
+/**
+ * Compute @f b^k @f, the number of base-`b` states of length `k`.
+ *
+ * @return 0 if the states cannot be encoded in HISTOGRAM_MAX_BITS bits
+ */
+static inline uint64_t histogram_support(int b, size_t k)
+{
+    uint64_t const limit = UINT64_MAX >> (64 - HISTOGRAM_MAX_BITS);
+    uint64_t size = 1;
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (size > limit / (uint64_t) b)
+        {
+            return 0;
+        }
+        size *= b;
+    }
+    return size;
+}
+
+/**
+ * Determine whether a histogram with a given support and number of
+ * observations should be stored sparsely.
+ */
+static inline bool histogram_prefers_sparse(uint64_t size, size_t N)
+{
+    switch (inform_get_engine())
+    {
+        case INFORM_ENGINE_DENSE:
+            return false;
+        case INFORM_ENGINE_SPARSE:
+            return true;
+        default:
+            // a support too large to address can never be stored densely
+            return size > HISTOGRAM_DENSE_LIMIT &&
+                (size / 4 > N || size > SIZE_MAX / sizeof(uint32_t));
+    }
+}
+
+/**
+ * Determine whether an average measure whose largest histogram has a given
+ * support should be computed by sorting the encoded observations rather than
+ * by histogramming them.
+ *
+ * In the regime where a sparse histogram would be chosen, i.e. the support
+ * dwarfs the number of observations, sorting uses less memory than hashing
+ * and streams through memory rather than missing cache on every observation.
+ */
+static inline bool histogram_prefers_sort(uint64_t size, size_t N)
+{
+    switch (inform_get_engine())
+    {
+        case INFORM_ENGINE_SORT:
+            return true;
+        case INFORM_ENGINE_AUTO:
+            return histogram_prefers_sparse(size, N);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Initialize a collection of empty histograms with the given supports,
+ * each of which will receive `N` observations.
+ *
+ * @return true if an allocation failed, in which case nothing is leaked
+ */
+static inline bool histograms_init(histogram *hs, uint64_t const *sizes,
+    size_t count, size_t N)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        histogram *h = hs + i;
+        h->dense = (inform_dist){ NULL, 0, 0 };
+        h->sparse = NULL;
+        if (histogram_prefers_sparse(sizes[i], N))
+        {
+            size_t const hint = (N < HISTOGRAM_SPARSE_HINT) ? N : HISTOGRAM_SPARSE_HINT;
+            h->sparse = inform_sparse_dist_alloc(hint);
+        }
+        else if (sizes[i] <= SIZE_MAX / sizeof(uint32_t))
+        {
+            h->dense.size = (size_t) sizes[i];
+            h->dense.histogram = calloc(h->dense.size, sizeof(uint32_t));
+        }
+        if (h->sparse == NULL && h->dense.histogram == NULL)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                free(hs[j].dense.histogram);
+                inform_sparse_dist_free(hs[j].sparse);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Free the memory associated with a collection of histograms.
+ */
+static inline void histograms_free(histogram *hs, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        free(hs[i].dense.histogram);
+        inform_sparse_dist_free(hs[i].sparse);
+    }
+}
+
+/**
+ * Remove every observation from a histogram, keeping its memory.
+ */
+static inline void histogram_clear(histogram *h)
+{
+    if (h->sparse == NULL)
+    {
+        memset(h->dense.histogram, 0, h->dense.size * sizeof(uint32_t));
+        h->dense.counts = 0;
+    }
+    else
+    {
+        inform_sparse_dist_clear(h->sparse);
+    }
+}
+
+/**
+ * Observe an event.
+ *
+ * @return false if the sparse table could not grow to hold the event
+ */
+static inline bool histogram_tick(histogram *h, uint64_t event)
+{
+    if (h->sparse == NULL)
+    {
+        h->dense.histogram[event]++;
+        h->dense.counts++;
+        return true;
+    }
+    return inform_sparse_dist_tick(h->sparse, event) != 0;
+}
+
+/**
+ * Remove a single observation of an event. An event which has not been
+ * observed is left alone rather than wrapped around to `UINT32_MAX`.
+ */
+static inline void histogram_untick(histogram *h, uint64_t event)
+{
+    if (h->sparse == NULL)
+    {
+        if (h->dense.histogram[event] != 0)
+        {
+            h->dense.histogram[event]--;
+            h->dense.counts--;
+        }
+    }
+    else
+    {
+        uint32_t const count = inform_sparse_dist_get(h->sparse, event);
+        if (count != 0)
+        {
+            inform_sparse_dist_set(h->sparse, event, count - 1);
+        }
+    }
+}
+
+/**
+ * Observe a run of events taken directly from a time series.
+ *
+ * @return false if the sparse table could not grow to hold the events
+ */
+static inline bool histogram_count(histogram *h, int const *events, size_t n)
+{
+    if (h->sparse == NULL)
+    {
+        inform_count(h->dense.histogram, h->dense.size, events, n);
+        h->dense.counts += n;
+        return true;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        ok &= inform_sparse_dist_tick(h->sparse, events[i]) != 0;
+    }
+    return ok;
+}
+
+/**
+ * Get the number of times an event has been observed.
+ */
+static inline uint32_t histogram_get(histogram const *h, uint64_t event)
+{
+    if (h->sparse == NULL)
+    {
+        return h->dense.histogram[event];
+    }
+    return inform_sparse_dist_get(h->sparse, event);
+}
+
+/**
+ * Get the total number of observations made.
+ */
+static inline uint64_t histogram_counts(histogram const *h)
+{
+    return (h->sparse == NULL) ? h->dense.counts : h->sparse->counts;
+}
+
+/**
+ * Determine whether the counts of one histogram can be added to another
+ * without overflowing. The histograms must have the same support, but need
+ * not share a representation.
+ */
+static inline bool histogram_fits(histogram const *dest, histogram const *src)
+{
+    uint32_t const *counts = src->dense.histogram;
+    size_t n = src->dense.size;
+    if (src->sparse != NULL)
+    {
+        counts = src->sparse->histogram;
+        n = src->sparse->capacity;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (counts[i] != 0)
+        {
+            uint64_t const event = (src->sparse == NULL) ? i : src->sparse->events[i];
+            if (histogram_get(dest, event) > UINT32_MAX - counts[i])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Add the counts of one histogram to another with the same support.
+ *
+ * @return false if the histograms do not fit (see histogram_fits), in which
+ *         case neither is changed, or if the sparse table could not grow to
+ *         hold the events, in which case some of the counts may have been
+ *         added
+ */
+static inline bool histogram_add(histogram *dest, histogram const *src)
+{
+    if (dest->sparse == NULL && src->sparse == NULL)
+    {
+        if (inform_add_counts(dest->dense.histogram, src->dense.histogram,
+            dest->dense.size))
+        {
+            return false;
+        }
+        dest->dense.counts += src->dense.counts;
+        return true;
+    }
+    if (!histogram_fits(dest, src))
+    {
+        return false;
+    }
+    uint32_t const *counts = src->dense.histogram;
+    size_t n = src->dense.size;
+    if (src->sparse != NULL)
+    {
+        counts = src->sparse->histogram;
+        n = src->sparse->capacity;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+        uint64_t const event = (src->sparse == NULL) ? i : src->sparse->events[i];
+        if (dest->sparse == NULL)
+        {
+            dest->dense.histogram[event] += counts[i];
+            dest->dense.counts += counts[i];
+        }
+        else if (inform_sparse_dist_set(dest->sparse, event,
+            inform_sparse_dist_get(dest->sparse, event) + counts[i]) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute @f \sum_i c_i \log_2 c_i @f over the counts of a histogram.
+ *
+ * Every average measure is a signed sum of these terms, scaled by the number
+ * of observations @f N @f, plus at most one @f \log_2 N @f; e.g. the entropy
+ * of a histogram is @f \log_2 N - S/N @f.
+ */
+static inline double histogram_nlogn(histogram const *h)
+{
+    uint32_t const *counts = h->dense.histogram;
+    size_t n = h->dense.size;
+    if (h->sparse != NULL)
+    {
+        counts = h->sparse->histogram;
+        n = h->sparse->capacity;
+    }
+    if (n >= INFORM_SIMD_MIN_SIZE)
+    {
+        return inform_weighted_log2(counts, counts, n);
+    }
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s += inform_nlog2n_count(counts[i]);
+    }
+    return s;
+}
+
+/// the fewest updates between recomputations of a running sum
+#define HISTOGRAM_RESYNC_MIN ((size_t) 1 << 16)
+
+/**
+ * A histogram together with the running sum @f \sum_i c_i \log_2 c_i @f
+ * over its counts, so that a measure can be kept current as single
+ * observations are added and removed
+ */
+typedef struct running_histogram
+{
+    histogram h;
+    /// the running sum of c log2 c
+    double nlogn;
+    /// the number of updates to the sum since it was last recomputed
+    size_t updates;
+} running_histogram;
+
+/**
+ * Add (`delta` = 1) or remove (`delta` = -1) a single observation of an
+ * event, keeping the running sum in step.
+ *
+ * Every update adds the difference of two tabulated terms, so the sum
+ * drifts by a few units in the last place per update; as in
+ * inform_window_dist, it is recomputed once the updates outnumber the cost
+ * of doing so, which keeps the drift bounded at amortized constant cost.
+ *
+ * @return false if the sparse table could not grow to hold the event
+ */
+static inline bool running_histogram_update(running_histogram *r,
+    uint64_t event, int delta)
+{
+    histogram *h = &r->h;
+    uint32_t const c = histogram_get(h, event);
+    if (delta > 0)
+    {
+        if (!histogram_tick(h, event)) return false;
+    }
+    else
+    {
+        histogram_untick(h, event);
+    }
+    r->nlogn += inform_nlog2n_count(c + delta) - inform_nlog2n_count(c);
+    size_t const cost = (h->sparse == NULL) ? h->dense.size :
+        h->sparse->capacity;
+    if (++r->updates >= cost && r->updates >= HISTOGRAM_RESYNC_MIN)
+    {
+        r->nlogn = histogram_nlogn(h);
+        r->updates = 0;
+    }
+    return true;
+}
+
+/**
+ * Initialize a collection of empty running histograms; see histograms_init.
+ *
+ * @return true if an allocation failed, in which case nothing is leaked
+ */
+static inline bool running_histograms_init(running_histogram *rs,
+    uint64_t const *sizes, size_t count, size_t N)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        rs[i].nlogn = 0.0;
+        rs[i].updates = 0;
+        if (histograms_init(&rs[i].h, sizes + i, 1, N))
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                histograms_free(&rs[j].h, 1);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Free the memory associated with a collection of running histograms.
+ */
+static inline void running_histograms_free(running_histogram *rs,
+    size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        histograms_free(&rs[i].h, 1);
+    }
+}
@@ -6,6 +6,7 @@
 #include <inform/mutual_info.h>
 #include <inform/utilities/black_boxing.h>
 #include <math.h>
+#include "log_table.h"
 
 static void accumulate_observations(int const *src, int const *dst,
     int const *back, size_t l_src, size_t l_dst, size_t l_back,
@@ -199,7 +200,7 @@ double inform_information_flow(int const *src, int const *dst, int const *back,
 
     double flow = 0.0;
     int bs_state, as_state, joint_state;
-    double ns, nbs, nas, njoint;
+    uint32_t ns, nbs, nas, njoint;
     for (int s_state = 0; s_state < (int) s_size; ++s_state)
     {
         ns = s.histogram[s_state];
@@ -207,6 +208,7 @@ double inform_information_flow(int const *src, int const *dst, int const *back,
         {
             continue;
         }
+        double const log_ns = inform_log2_count(ns);
         for (int b_state = 0; b_state < (int) b_size; ++b_state)
         {
             bs_state = b_state * s_size + s_state;
@@ -215,6 +217,7 @@ double inform_information_flow(int const *src, int const *dst, int const *back,
             {
                 continue;
             }
+            double const log_ratio = log_ns - inform_log2_count(nbs);
             for (int a_state = 0; a_state < (int) a_size; ++a_state)
             {
                 as_state = a_state * s_size + s_state;
@@ -229,7 +232,8 @@ double inform_information_flow(int const *src, int const *dst, int const *back,
                 {
                     continue;
                 }
-                flow += njoint * log2((njoint * ns) / (nas * nbs));
+                flow += inform_nlog2n_count(njoint) +
+                    njoint * (log_ratio - inform_log2_count(nas));
             }
         }
     }
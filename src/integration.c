@@ -5,6 +5,14 @@
 #include <inform/mutual_info.h>
 #include <inform/utilities.h>
 #include <math.h>
+#include "histogram.h"
+
+/// the most time series which can be black-boxed together, each of two states
+#define BLOCK_MAX_VARS 30
+/// the most variables for which the surprisal of every block may be cached
+#define BLOCK_CACHE_MAX_VARS 20
+/// the most memory spent on the surprisals of cached blocks
+#define BLOCK_CACHE_MAX_BYTES ((size_t) 1 << 28)
 
 static bool check_arguments(int const *series, size_t l, inform_error *err)
 {
@@ -21,6 +29,158 @@ static bool check_arguments(int const *series, size_t l, inform_error *err)
     return false;
 }
 
+/**
+ * The local surprisal of the blocks of a collection of time series, keyed
+ * by the mask of their members
+ *
+ * The local mutual information between the blocks of a partitioning is the
+ * sum of the local surprisals of the blocks less that of the whole
+ * collection, and a block belongs to many partitionings, so each block's
+ * surprisal is computed once and shared. Blocks are cached until
+ * BLOCK_CACHE_MAX_BYTES are spent, after which they are recomputed into
+ * `scratch` as they are needed.
+ */
+typedef struct block_cache
+{
+    int const *series;
+    int const *b;
+    size_t l, n;
+    /// the surprisal of each block, or NULL if it has yet to be cached
+    double **surprisal;
+    /// the number of bytes of surprisal cached
+    size_t bytes;
+    /// the encoded states of a block
+    int *states;
+    /// the surprisal of a block which is not cached
+    double *scratch;
+} block_cache;
+
+/**
+ * Compute the local surprisal @f -\log_2 p(x_t) @f of `n` encoded states
+ * drawn from `size` possible states.
+ *
+ * @return true if out of memory
+ */
+static bool surprisal(int const *states, size_t n, uint64_t size,
+    double *local)
+{
+    histogram h;
+    if (histograms_init(&h, &size, 1, n))
+    {
+        return true;
+    }
+    bool const ok = histogram_count(&h, states, n);
+    double const log_n = inform_log2_count(n);
+    for (size_t t = 0; t < n && ok; ++t)
+    {
+        local[t] = log_n - inform_log2_count(histogram_get(&h, states[t]));
+    }
+    histograms_free(&h, 1);
+    return !ok;
+}
+
+/**
+ * Get the local surprisal of the block with the given members, computing it
+ * if it is not cached.
+ *
+ * @return the surprisal, or NULL if out of memory
+ */
+static double const *block_surprisal(block_cache *cache, size_t mask)
+{
+    if (cache->surprisal != NULL && cache->surprisal[mask] != NULL)
+    {
+        return cache->surprisal[mask];
+    }
+
+    size_t const n = cache->n;
+    uint64_t size = 1;
+    memset(cache->states, 0, n * sizeof(int));
+    for (size_t i = 0; i < cache->l; ++i)
+    {
+        if (mask & ((size_t) 1 << i))
+        {
+            int const *x = cache->series + n * i;
+            for (size_t t = 0; t < n; ++t)
+            {
+                cache->states[t] = cache->states[t] * cache->b[i] + x[t];
+            }
+            size *= cache->b[i];
+        }
+    }
+
+    double *local = cache->scratch;
+    if (cache->surprisal != NULL &&
+        cache->bytes + n * sizeof(double) <= BLOCK_CACHE_MAX_BYTES)
+    {
+        double *cached = malloc(n * sizeof(double));
+        if (cached != NULL)
+        {
+            local = cached;
+            cache->surprisal[mask] = cached;
+            cache->bytes += n * sizeof(double);
+        }
+    }
+    if (surprisal(cache->states, n, size, local))
+    {
+        if (local != cache->scratch)
+        {
+            // leave the entry empty rather than cache garbage
+            free(local);
+            cache->surprisal[mask] = NULL;
+            cache->bytes -= n * sizeof(double);
+        }
+        return NULL;
+    }
+    return local;
+}
+
+static void block_cache_free(block_cache *cache)
+{
+    if (cache->surprisal != NULL)
+    {
+        for (size_t mask = 0; mask < ((size_t) 1 << cache->l); ++mask)
+        {
+            free(cache->surprisal[mask]);
+        }
+        free(cache->surprisal);
+    }
+    free(cache->states);
+    free(cache->scratch);
+}
+
+/**
+ * Compute the local mutual information between the blocks of a
+ * partitioning, given the local surprisal of the whole collection.
+ *
+ * @return true if out of memory
+ */
+static bool partition_mutual_info(block_cache *cache, size_t const *parts,
+    size_t nparts, double const *whole, double *lmi)
+{
+    size_t masks[BLOCK_MAX_VARS] = { 0 };
+    for (size_t i = 0; i < cache->l; ++i)
+    {
+        masks[parts[i]] |= (size_t) 1 << i;
+    }
+    for (size_t t = 0; t < cache->n; ++t)
+    {
+        lmi[t] = -whole[t];
+    }
+    for (size_t p = 0; p < nparts; ++p)
+    {
+        double const *local = block_surprisal(cache, masks[p]);
+        if (local == NULL)
+        {
+            return true;
+        }
+        for (size_t t = 0; t < cache->n; ++t)
+        {
+            lmi[t] += local[t];
+        }
+    }
+    return false;
+}
+
 double *inform_integration_evidence(int const *series, size_t l, size_t n,
     int const *b, double *evidence, inform_error *err)
 {
@@ -28,21 +188,47 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
     {
         return NULL;
     }
+    // encoding the whole collection validates it, including that every
+    // block's states can be encoded in an int
+    int *states = inform_black_box(series, l, 1, n, b, NULL, NULL, NULL, err);
+    if (states == NULL)
+    {
+        return NULL;
+    }
     int allocate = (evidence == NULL);
     if (allocate)
     {
         evidence = malloc(2 * n * sizeof(double));
         if (evidence == NULL)
         {
+            free(states);
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
+
+    block_cache cache = { series, b, l, n, NULL, 0, states,
+        malloc(n * sizeof(double)) };
+    if (l <= BLOCK_CACHE_MAX_VARS)
+    {
+        cache.surprisal = calloc((size_t) 1 << l, sizeof(double*));
+    }
     double *lmi = malloc(n * sizeof(double));
-    if (lmi == NULL)
+    double *whole = malloc(n * sizeof(double));
+    uint64_t size = 1;
+    for (size_t i = 0; i < l; ++i)
+    {
+        size *= b[i];
+    }
+    if (cache.scratch == NULL || lmi == NULL || whole == NULL ||
+        surprisal(states, n, size, whole))
     {
+        block_cache_free(&cache);
+        free(whole);
+        free(lmi);
         if (allocate) free(evidence);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+
     double *minimum = evidence;
     double *maximum = minimum + n;
     for (size_t i = 0; i < n; ++i)
@@ -53,11 +239,15 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
 
     size_t *parts = inform_first_partitioning(l);
     size_t nparts = 1;
-    while ((nparts = inform_next_partitioning(parts, l)))
+    if (parts == NULL)
     {
-        inform_integration_evidence_part(series, l, n, b, parts, nparts, lmi, err);
-        if (inform_failed(err))
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    while (parts != NULL && (nparts = inform_next_partitioning(parts, l)))
+    {
+        if (partition_mutual_info(&cache, parts, nparts, whole, lmi))
         {
+            INFORM_ERROR(err, INFORM_ENOMEM);
             break;
         }
         for (size_t i = 0; i < n; ++i)
@@ -67,8 +257,10 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
         }
     }
     free(parts);
+    block_cache_free(&cache);
+    free(whole);
     free(lmi);
-    
+
     if (inform_failed(err))
     {
         if (allocate)
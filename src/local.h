@@ -0,0 +1,93 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/local_summary.h>
+#include <math.h>
+
+/**
+ * The forms in which the local values of a measure can be written
+ */
+typedef enum
+{
+    LOCAL_DOUBLE,
+    LOCAL_FLOAT,
+    LOCAL_SUMMARY,
+} local_format;
+
+/**
+ * The destination of the local values of a measure, written one after
+ * another by local_emit
+ */
+typedef struct local_sink
+{
+    local_format format;
+    union
+    {
+        double *doubles;
+        float *floats;
+        inform_local_summary *summary;
+    };
+} local_sink;
+
+static inline local_sink local_doubles(double *values)
+{
+    return (local_sink){ .format = LOCAL_DOUBLE, .doubles = values };
+}
+
+static inline local_sink local_floats(float *values)
+{
+    return (local_sink){ .format = LOCAL_FLOAT, .floats = values };
+}
+
+static inline local_sink local_summary(inform_local_summary *summary)
+{
+    return (local_sink){ .format = LOCAL_SUMMARY, .summary = summary };
+}
+
+/**
+ * Add a value to a summary, updating its moments with Welford's method.
+ */
+static inline void local_summary_add(inform_local_summary *summary,
+    double value)
+{
+    double const delta = value - summary->mean;
+    summary->count += 1;
+    summary->mean += delta / summary->count;
+    summary->m2 += delta * (value - summary->mean);
+    summary->min = fmin(summary->min, value);
+    summary->max = fmax(summary->max, value);
+    if (summary->bins != 0)
+    {
+        double const x = (value - summary->lo) / (summary->hi - summary->lo);
+        size_t bin = 0;
+        if (x >= 1.0)
+        {
+            bin = summary->bins - 1;
+        }
+        else if (x > 0.0)
+        {
+            bin = (size_t)(x * summary->bins);
+        }
+        summary->histogram[bin] += 1;
+    }
+}
+
+/**
+ * Write the next local value to a sink.
+ */
+static inline void local_emit(local_sink *sink, double value)
+{
+    switch (sink->format)
+    {
+        case LOCAL_DOUBLE:
+            *sink->doubles++ = value;
+            break;
+        case LOCAL_FLOAT:
+            *sink->floats++ = (float) value;
+            break;
+        default:
+            local_summary_add(sink->summary, value);
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/local_summary.h>
+#include "local.h"
+
+inform_local_summary *inform_local_summary_alloc(size_t bins, double lo,
+    double hi, inform_error *err)
+{
+    if (bins != 0 && !(lo < hi))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    inform_local_summary *summary = malloc(sizeof(inform_local_summary));
+    if (summary == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    summary->bins = bins;
+    summary->lo = lo;
+    summary->hi = hi;
+    summary->histogram = NULL;
+    if (bins != 0)
+    {
+        summary->histogram = malloc(bins * sizeof(uint64_t));
+        if (summary->histogram == NULL)
+        {
+            free(summary);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+    inform_local_summary_clear(summary);
+    return summary;
+}
+
+void inform_local_summary_free(inform_local_summary *summary)
+{
+    if (summary != NULL)
+    {
+        free(summary->histogram);
+        free(summary);
+    }
+}
+
+void inform_local_summary_clear(inform_local_summary *summary)
+{
+    if (summary != NULL)
+    {
+        summary->count = 0;
+        summary->mean = 0.0;
+        summary->m2 = 0.0;
+        summary->min = INFINITY;
+        summary->max = -INFINITY;
+        for (size_t i = 0; i < summary->bins; ++i)
+        {
+            summary->histogram[i] = 0;
+        }
+    }
+}
+
+void inform_local_summary_add(inform_local_summary *summary, double value)
+{
+    if (summary != NULL)
+    {
+        local_summary_add(summary, value);
+    }
+}
+
+double inform_local_summary_variance(inform_local_summary const *summary)
+{
+    if (summary == NULL || summary->count == 0)
+    {
+        return NAN;
+    }
+    return summary->m2 / summary->count;
+}
+
+double inform_local_summary_quantile(inform_local_summary const *summary,
+    double p)
+{
+    if (summary == NULL || summary->count == 0 || summary->bins == 0 ||
+        !(0.0 <= p && p <= 1.0))
+    {
+        return NAN;
+    }
+    double const width = (summary->hi - summary->lo) / summary->bins;
+    double const target = p * summary->count;
+    double cumulative = 0.0, quantile = summary->hi;
+    for (size_t i = 0; i < summary->bins; ++i)
+    {
+        double const count = (double) summary->histogram[i];
+        if (count != 0.0 && cumulative + count >= target)
+        {
+            quantile = summary->lo +
+                width * (i + (target - cumulative) / count);
+            break;
+        }
+        cumulative += count;
+    }
+    return fmin(fmax(quantile, summary->min), summary->max);
+}
@@ -0,0 +1,43 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "log_table.h"
+#include <stdbool.h>
+
+double *inform_log_table[LOG_TABLE_BITS];
+
+double const *inform_log_table_segment(unsigned k)
+{
+    size_t const base = (size_t) 1 << k;
+    double *segment = malloc(2 * base * sizeof(double));
+    if (segment == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < base; ++i)
+    {
+        double const c = (double) (base + i);
+        segment[i] = log2(c);
+        segment[base + i] = c * segment[i];
+    }
+
+    // publish the segment unless another thread beat us to it, in which case
+    // theirs is used and ours is discarded
+#if defined(_MSC_VER)
+    double *existing = InterlockedCompareExchangePointer(
+        (PVOID volatile *) &inform_log_table[k], segment, NULL);
+#else
+    double *existing = NULL;
+    if (__atomic_compare_exchange_n(&inform_log_table[k], &existing, segment,
+        false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        existing = NULL;
+    }
+#endif
+    if (existing != NULL)
+    {
+        free(segment);
+        return existing;
+    }
+    return segment;
+}
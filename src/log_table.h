@@ -0,0 +1,105 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <windows.h>
+#endif
+
+/// counts below 2^LOG_TABLE_BITS are looked up, larger counts are computed
+#define LOG_TABLE_BITS 20
+
+/**
+ * The segments of the table of logarithms of integer counts.
+ *
+ * Segment `k` covers the counts @f c \in [2^k, 2^{k+1}) @f and holds
+ * @f 2^{k+1} @f doubles: @f \log_2 c @f at index @f c - 2^k @f followed by
+ * @f c \log_2 c @f at index @f c @f. Segments are allocated the first time
+ * a count in their range is looked up and never move or shrink, so a
+ * published segment can be read without synchronization. The whole table is
+ * capped at @f 2^{LOG\_TABLE\_BITS + 1} @f doubles.
+ */
+extern double *inform_log_table[LOG_TABLE_BITS];
+
+/**
+ * Get segment `k` of the table, building it if no thread has done so yet.
+ *
+ * @return the segment, or NULL if it could not be allocated
+ */
+double const *inform_log_table_segment(unsigned k);
+
+/**
+ * Compute @f \lfloor \log_2 c \rfloor @f for @f c > 0 @f.
+ */
+static inline unsigned inform_floor_log2(uint64_t c)
+{
+#if defined(_MSC_VER)
+    unsigned long k;
+    _BitScanReverse64(&k, c);
+    return (unsigned) k;
+#else
+    return 63u - (unsigned) __builtin_clzll(c);
+#endif
+}
+
+/**
+ * Look up a segment of the table, building it if necessary.
+ */
+static inline double const *inform_log_table_get(unsigned k)
+{
+#if defined(_MSC_VER)
+    double const *segment = InterlockedCompareExchangePointer(
+        (PVOID volatile *) &inform_log_table[k], NULL, NULL);
+#else
+    double const *segment = __atomic_load_n(&inform_log_table[k],
+        __ATOMIC_ACQUIRE);
+#endif
+    return (segment != NULL) ? segment : inform_log_table_segment(k);
+}
+
+/**
+ * Compute @f \log_2 c @f for an integer count, -INFINITY when @f c = 0 @f.
+ */
+static inline double inform_log2_count(uint64_t c)
+{
+    if (c == 0)
+    {
+        return -INFINITY;
+    }
+    else if (c < ((uint64_t) 1 << LOG_TABLE_BITS))
+    {
+        unsigned const k = inform_floor_log2(c);
+        double const *segment = inform_log_table_get(k);
+        if (segment != NULL)
+        {
+            return segment[c - ((uint64_t) 1 << k)];
+        }
+    }
+    return log2((double) c);
+}
+
+/**
+ * Compute @f c \log_2 c @f for an integer count, zero when @f c = 0 @f.
+ */
+static inline double inform_nlog2n_count(uint64_t c)
+{
+    if (c == 0)
+    {
+        return 0.0;
+    }
+    else if (c < ((uint64_t) 1 << LOG_TABLE_BITS))
+    {
+        double const *segment = inform_log_table_get(inform_floor_log2(c));
+        if (segment != NULL)
+        {
+            return segment[c];
+        }
+    }
+    return (double) c * log2((double) c);
+}
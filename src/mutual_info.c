@@ -3,6 +3,9 @@
 // license that can be found in the LICENSE file.
 #include <inform/mutual_info.h>
 #include <inform/shannon.h>
+#include "accumulator.h"
+#include "count.h"
+#include "log_table.h"
 
 static bool check_arguments(int const *series, size_t l, size_t n, int const *b,
     inform_error *err)
@@ -75,6 +78,8 @@ inline static void accumulate(int const *series, size_t l, size_t n,
     for (size_t i = 0; i < l; ++i)
     {
         marginals[i]->counts = n;
+        inform_count(marginals[i]->histogram, marginals[i]->size,
+            series + n * i, n);
     }
 
     for (size_t i = 0; i < n; ++i)
@@ -83,7 +88,6 @@ inline static void accumulate(int const *series, size_t l, size_t n,
         for (size_t j = 0; j < l; ++j)
         {
             joint_event = joint_event * b[j] + series[i + n * j];
-            marginals[j]->histogram[series[i + n * j]]++;
         }
         joint->histogram[joint_event]++;
     }
@@ -126,6 +130,73 @@ double inform_mutual_info(int const *series, size_t l, size_t n, int const *b,
     return mi;
 }
 
+/**
+ * Check that a pair of handles have the same number of observations; their
+ * states were validated when the handles were allocated.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *xs, inform_series const *ys,
+    inform_error *err)
+{
+    if (xs == NULL || ys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (ys->n * ys->m != xs->n * xs->m)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    return false;
+}
+
+/**
+ * Count the joint and marginal observations of a pair of handles into three
+ * histograms.
+ *
+ * @return true if out of memory
+ */
+static bool accumulate_series(inform_series const *xs, inform_series const *ys,
+    histogram *hs)
+{
+    size_t const N = xs->n * xs->m;
+    int const by = ys->b;
+    if (histograms_init(hs, (uint64_t[]){(uint64_t) xs->b * by, xs->b, by}, 3, N))
+    {
+        return true;
+    }
+    bool ok = histogram_count(hs + 1, xs->data, N) &&
+        histogram_count(hs + 2, ys->data, N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        ok &= histogram_tick(hs, (uint64_t) xs->data[i] * by + ys->data[i]);
+    }
+    if (!ok)
+    {
+        histograms_free(hs, 3);
+    }
+    return !ok;
+}
+
+double inform_mutual_info_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err)
+{
+    histogram hs[3];
+    if (check_series(xs, ys, err))
+    {
+        return NAN;
+    }
+    else if (accumulate_series(xs, ys, hs))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    size_t const N = xs->n * xs->m;
+    double const mi = log2((double) N) + (histogram_nlogn(hs) -
+        histogram_nlogn(hs + 1) - histogram_nlogn(hs + 2)) / N;
+    histograms_free(hs, 3);
+    return mi;
+}
+
 double *inform_local_mutual_info(int const *series, size_t l, size_t n,
     int const *b, double *mi, inform_error *err)
 {
@@ -156,26 +227,159 @@ double *inform_local_mutual_info(int const *series, size_t l, size_t n,
 
     accumulate(series, l, n, b, joint, marginals);
 
-    double norm = 1;
-    for (size_t i = 0; i < l; ++i) norm *= marginals[i]->counts;
-    norm /= joint->counts;
+    double log_norm = -inform_log2_count(joint->counts);
+    for (size_t i = 0; i < l; ++i)
+    {
+        log_norm += inform_log2_count(marginals[i]->counts);
+    }
 
-    double j, m;
     for (size_t i = 0; i < n; ++i)
     {
-        m = 1;
+        double log_m = 0.0;
         size_t joint_event = 0;
         for (size_t j = 0; j < l; ++j)
         {
             int marginal_event = series[i + n * j];
-            m *= marginals[j]->histogram[marginal_event];
+            log_m += inform_log2_count(marginals[j]->histogram[marginal_event]);
             joint_event = joint_event * b[j] + marginal_event;
         }
-        j = joint->histogram[joint_event];
-        mi[i] = log2((j * norm) / m);
+        mi[i] = inform_log2_count(joint->histogram[joint_event]) + log_norm - log_m;
     }
 
     free_all(&joint, marginals, l);
 
     return mi;
-}
\ No newline at end of file
+}
+double *inform_local_mutual_info_series(inform_series const *xs,
+    inform_series const *ys, double *mi, inform_error *err)
+{
+    if (check_series(xs, ys, err)) return NULL;
+
+    size_t const N = xs->n * xs->m;
+    bool allocate_mi = (mi == NULL);
+    if (allocate_mi)
+    {
+        mi = malloc(N * sizeof(double));
+        if (mi == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    histogram hs[3];
+    if (accumulate_series(xs, ys, hs))
+    {
+        if (allocate_mi) free(mi);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    int const by = ys->b;
+    double const log_N = log2((double) N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        int const x = xs->data[i], y = ys->data[i];
+        mi[i] = log_N +
+            inform_log2_count(histogram_get(hs, (uint64_t) x * by + y)) -
+            inform_log2_count(histogram_get(hs + 1, x)) -
+            inform_log2_count(histogram_get(hs + 2, y));
+    }
+
+    histograms_free(hs, 3);
+
+    return mi;
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    bool ok = true;
+    for (size_t i = 0; i < acc->l; ++i)
+    {
+        ok &= histogram_count(acc->hs + i + 1, series + m * i, m);
+    }
+    for (size_t i = 0; i < m; ++i)
+    {
+        uint64_t joint_event = 0;
+        for (size_t j = 0; j < acc->l; ++j)
+        {
+            joint_event = joint_event * acc->bases[j] + series[i + m * j];
+        }
+        ok &= histogram_tick(acc->hs, joint_event);
+    }
+    return !ok;
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    double s = histogram_nlogn(acc->hs);
+    for (size_t i = 0; i < acc->l; ++i)
+    {
+        s -= histogram_nlogn(acc->hs + i + 1);
+    }
+    return (acc->l - 1) * log2((double) N) + s / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *mi)
+{
+    double const log_norm = (acc->l - 1) *
+        inform_log2_count(histogram_counts(acc->hs));
+    for (size_t i = 0; i < m; ++i)
+    {
+        double log_m = 0.0;
+        uint64_t joint_event = 0;
+        for (size_t j = 0; j < acc->l; ++j)
+        {
+            int marginal_event = series[i + m * j];
+            log_m += inform_log2_count(histogram_get(acc->hs + j + 1, marginal_event));
+            joint_event = joint_event * acc->bases[j] + marginal_event;
+        }
+        mi[i] = inform_log2_count(histogram_get(acc->hs, joint_event)) +
+            log_norm - log_m;
+    }
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_MUTUAL_INFO
+};
+
+inform_acc *inform_mutual_info_acc(size_t l, int const *b, inform_error *err)
+{
+    if (b == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    else if (l < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    }
+    uint64_t *sizes = malloc((l + 1) * sizeof(uint64_t));
+    if (sizes == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    sizes[0] = 1;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (b[i] < 2)
+        {
+            free(sizes);
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+        }
+        else if (sizes[0] > (UINT64_MAX >> (64 - HISTOGRAM_MAX_BITS)) / b[i])
+        {
+            free(sizes);
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+        }
+        sizes[0] *= b[i];
+        sizes[i + 1] = b[i];
+    }
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, b, l, 1, sizes, l + 1,
+        err);
+    free(sizes);
+    if (acc != NULL)
+    {
+        acc->l = l;
+    }
+    return acc;
+}
@@ -0,0 +1,116 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "partition.h"
+#include "thread.h"
+
+typedef struct partition_job
+{
+    block_accumulator accumulate;
+    void const *arg;
+    size_t n, first, last;
+    /// the histograms, the private histograms of every task but the first
+    /// and the number of each
+    histogram *hs, *partials;
+    size_t count;
+    size_t tasks;
+    bool *failed;
+} partition_job;
+
+static void partition_task(void *arg, size_t index)
+{
+    partition_job const *job = arg;
+    histogram *hs = job->hs;
+    if (index != 0)
+    {
+        hs = job->partials + (index - 1) * job->count;
+    }
+
+    observation_block block = { 0, job->n, job->first, job->last };
+    if (job->n >= job->tasks)
+    {
+        block.begin = job->n * index / job->tasks;
+        block.end = job->n * (index + 1) / job->tasks;
+    }
+    else
+    {
+        size_t const w = job->last - job->first;
+        block.first = job->first + w * index / job->tasks;
+        block.last = job->first + w * (index + 1) / job->tasks;
+    }
+    job->failed[index] = job->accumulate(job->arg, block, hs);
+}
+
+/**
+ * Choose the number of threads among which to divide `N` observations,
+ * each of which costs a private copy of every histogram to sum.
+ */
+static size_t partition_tasks(size_t N, uint64_t const *sizes, size_t count)
+{
+    size_t tasks = inform_get_num_threads();
+    if (tasks > N / PARTITION_THREAD_MIN)
+    {
+        tasks = N / PARTITION_THREAD_MIN;
+    }
+    for (size_t h = 0; h < count && tasks > 1; ++h)
+    {
+        if (sizes[h] > N / tasks &&
+            !histogram_prefers_sparse(sizes[h], N / tasks))
+        {
+            return 1;
+        }
+    }
+    return tasks;
+}
+
+bool inform_accumulate_blocks(block_accumulator accumulate, void const *arg,
+    size_t n, size_t first, size_t last, histogram *hs, uint64_t const *sizes,
+    size_t count, bool *overflow)
+{
+    *overflow = false;
+    size_t const N = n * (last - first);
+    size_t const tasks = partition_tasks(N, sizes, count);
+
+    histogram *partials = NULL;
+    bool *failed = NULL;
+    size_t initialized = 0;
+    if (tasks > 1)
+    {
+        partials = malloc((tasks - 1) * count * sizeof(histogram));
+        failed = calloc(tasks, sizeof(bool));
+        // the histograms are chosen on this thread, where the engine is set
+        while (partials != NULL && failed != NULL && initialized < tasks - 1 &&
+            !histograms_init(partials + initialized * count, sizes, count,
+            N / tasks))
+        {
+            ++initialized;
+        }
+    }
+    if (tasks == 1 || initialized != tasks - 1)
+    {
+        histograms_free(partials, initialized * count);
+        free(partials);
+        free(failed);
+        return accumulate(arg, (observation_block){ 0, n, first, last }, hs);
+    }
+
+    partition_job job = { accumulate, arg, n, first, last, hs, partials,
+        count, tasks, failed };
+    inform_run_tasks(partition_task, &job, tasks);
+
+    bool ok = true;
+    for (size_t i = 0; i < tasks; ++i)
+    {
+        ok &= !failed[i];
+    }
+    for (size_t i = 0; i < (tasks - 1) * count && ok; ++i)
+    {
+        *overflow = !histogram_fits(hs + i % count, partials + i);
+        ok = !*overflow && histogram_add(hs + i % count, partials + i);
+    }
+
+    histograms_free(partials, initialized * count);
+    free(partials);
+    free(failed);
+    return !ok;
+}
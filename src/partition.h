@@ -0,0 +1,64 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdbool.h>
+#include "histogram.h"
+
+/// the fewest observations worth handing to a thread of their own
+#define PARTITION_THREAD_MIN ((size_t) 1 << 15)
+
+/**
+ * The observations made at time steps `[first, last)` of initial conditions
+ * `[begin, end)` of an ensemble
+ *
+ * An observation made at time step `first` may read the time steps which
+ * precede it, e.g. its history, so blocks which split a time series overlap
+ * by a history length.
+ */
+typedef struct observation_block
+{
+    /// the initial conditions
+    size_t begin, end;
+    /// the time steps at which observations are made
+    size_t first, last;
+} observation_block;
+
+/**
+ * Accumulate the observations of a block into a measure's histograms.
+ *
+ * @return true if a state is invalid or if out of memory
+ */
+typedef bool (*block_accumulator)(void const *arg, observation_block block,
+    histogram *hs);
+
+/**
+ * Accumulate the observations made at time steps `[first, last)` of `n`
+ * initial conditions into `count` histograms with the given supports.
+ *
+ * When more than one thread is allowed (see inform_set_num_threads) and
+ * there are enough observations, they are divided among threads, each with
+ * private histograms which are added to `hs` once every thread is done. The
+ * initial conditions are divided among the threads if there are at least as
+ * many of them as threads, otherwise the time series are split into
+ * overlapping blocks. Either way the counts are exactly those of a serial
+ * accumulation. If the private histograms cannot be allocated, the
+ * observations are accumulated serially. If a count would overflow when the
+ * private histograms are added, the accumulation fails and `overflow` is
+ * set; any other failure is left to the caller to diagnose.
+ *
+ * @param[in] accumulate the measure's accumulation
+ * @param[in] arg        the argument shared by every block
+ * @param[in] n          the number of initial conditions
+ * @param[in] first      the first time step at which an observation is made
+ * @param[in] last       one past the last such time step
+ * @param[in,out] hs     the histograms
+ * @param[in] sizes      the support of each histogram
+ * @param[in] count      the number of histograms
+ * @param[out] overflow  whether a count would overflow
+ * @return true if any block failed to accumulate or a count would overflow
+ */
+bool inform_accumulate_blocks(block_accumulator accumulate, void const *arg,
+    size_t n, size_t first, size_t last, histogram *hs, uint64_t const *sizes,
+    size_t count, bool *overflow);
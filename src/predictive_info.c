@@ -3,92 +3,190 @@
 // license that can be found in the LICENSE file.
 #include <inform/predictive_info.h>
 #include <inform/shannon.h>
+#include "accumulator.h"
+#include "histogram.h"
+#include "partition.h"
+#include "radix_sort.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t kpast, size_t kfuture, inform_dist *states,
-    inform_dist *histories, inform_dist *futures)
+/**
+ * Accumulate a block of the observations of a series, each of which is the
+ * `kpast` time steps preceding the `kfuture` time steps which end just before
+ * time step `j`, for `j` within the block.
+ *
+ * @return true if out of memory
+ */
+static bool accumulate_observations(int const* series, size_t m, int b,
+    size_t kpast, size_t kfuture, observation_block block, histogram *states,
+    histogram *histories, histogram *futures)
 {
-    for (size_t i = 0; i < n; ++i, series += m)
+    bool ok = true;
+    size_t const start = block.first - kpast - kfuture;
+    series += block.begin * m;
+    for (size_t i = block.begin; i < block.end; ++i, series += m)
     {
-        int history = 0, q = 1, r = 1, state, future = 0;
-        for (size_t j = 0; j < kpast; ++j)
+        uint64_t history = 0, q = 1, r = 1, state, future = 0;
+        for (size_t j = start; j < start + kpast; ++j)
         {
             q *= b;
             history *= b;
             history += series[j];
         }
 
-        for (size_t j = kpast; j < kpast + kfuture; ++j)
+        for (size_t j = start + kpast; j < block.first; ++j)
         {
             r *= b;
             future *= b;
             future += series[j];
         }
 
-        size_t j = kpast + kfuture;
-        do
+        for (size_t j = block.first; j < block.last; ++j)
         {
             state = history * r + future;
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            futures->histogram[future]++;
+            ok &= histogram_tick(states, state);
+            ok &= histogram_tick(histories, history);
+            ok &= histogram_tick(futures, future);
+
+            if (j + 1 != block.last)
+            {
+                history = history * b - series[j - kpast - kfuture]*q + series[j - kfuture];
+                future = future * b - series[j - kfuture]*r + series[j];
+            }
+        }
+    }
+    return !ok;
+}
+
+/// the arguments shared by every block of a series' observations
+typedef struct observations
+{
+    int const *series;
+    size_t m;
+    int b;
+    size_t kpast, kfuture;
+} observations;
 
+static bool accumulate_block(void const *arg, observation_block block,
+    histogram *hs)
+{
+    observations const *obs = arg;
+    return accumulate_observations(obs->series, obs->m, obs->b, obs->kpast,
+        obs->kfuture, block, hs, hs + 1, hs + 2);
+}
+
+/**
+ * Compute the local predictive information of each observation of a series,
+ * re-encoding the observations rather than storing them as they were
+ * accumulated.
+ */
+static void local_observations(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, histogram const *states,
+    histogram const *histories, histogram const *futures, double *pi)
+{
+    double const log_N = log2((double) histogram_counts(states));
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0, q = 1, r = 1, state, future = 0;
+        for (size_t j = 0; j < kpast; ++j)
+        {
+            q *= b;
+            history *= b;
+            history += series[j];
+        }
+        for (size_t j = kpast; j < kpast + kfuture; ++j)
+        {
+            r *= b;
+            future *= b;
+            future += series[j];
+        }
+        for (size_t j = kpast + kfuture; ; ++j)
+        {
+            state = history * r + future;
+            *pi++ = log_N + inform_log2_count(histogram_get(states, state)) -
+                inform_log2_count(histogram_get(histories, history)) -
+                inform_log2_count(histogram_get(futures, future));
+            if (j == m)
+            {
+                break;
+            }
             history = history * b - series[j - kpast - kfuture]*q + series[j - kfuture];
             future = future * b - series[j - kfuture]*r + series[j];
-        } while (++j <= m);
+        }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t kpast, size_t kfuture, inform_dist *states,
-    inform_dist *histories, inform_dist *futures, int *state, int *history,
-    int *future)
+static void encode_observations(int const* series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, uint64_t *states)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t history = 0, q = 1, r = 1, future = 0;
         for (size_t j = 0; j < kpast; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            history *= b;
+            history += series[j];
         }
-        
-        future[0] = 0;
-        int r = 1;
+
         for (size_t j = kpast; j < kpast + kfuture; ++j)
         {
             r *= b;
-            future[0] *= b;
-            future[0] += series[j];
+            future *= b;
+            future += series[j];
         }
 
         size_t j = kpast + kfuture;
         do
         {
-            size_t l = j - kpast - kfuture;
-            state[l] = history[l] * r + future[l];
-
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
-            futures->histogram[future[l]]++;
+            *states++ = history * r + future;
 
             if (j != m)
             {
-                history[l + 1] = history[l] * b - series[l]*q + series[j - kfuture];
-                future[l + 1] = future[l] * b - series[j - kfuture]*r + series[j];
+                history = history * b - series[j - kpast - kfuture]*q + series[j - kfuture];
+                future = future * b - series[j - kfuture]*r + series[j];
             }
         } while (++j <= m);
-        series += m;
-        state += (m - kpast - kfuture + 1);
-        history += (m - kpast - kfuture + 1);
-        future += (m - kpast - kfuture + 1);
     }
 }
 
-static bool check_arguments(int const *series, size_t n, size_t m, int b,
+static double sorted_predictive_info(int const *series, size_t n, size_t m,
+    int b, size_t kpast, size_t kfuture, uint64_t histories_size,
+    uint64_t futures_size, inform_error *err)
+{
+    size_t const N = n * (m - kpast - kfuture + 1);
+    uint64_t const max = histories_size * futures_size - 1;
+
+    uint64_t *keys = malloc(2 * N * sizeof(uint64_t));
+    if (keys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    encode_observations(series, n, m, b, kpast, kfuture, keys);
+    uint64_t *states = inform_radix_sort(keys, keys + N, N, max);
+
+    double s = inform_sorted_nlogn(states, N, 1) -
+        inform_sorted_nlogn(states, N, futures_size);
+
+    // reorder each state as (future, history) so that the futures are the
+    // most significant terms of the encoding, and sort again
+    uint64_t *scratch = (states == keys) ? keys + N : keys;
+    for (size_t i = 0; i < N; ++i)
+    {
+        uint64_t const history = states[i] / futures_size;
+        uint64_t const future = states[i] % futures_size;
+        states[i] = future * histories_size + history;
+    }
+    states = inform_radix_sort(states, scratch, N, max);
+
+    s -= inform_sorted_nlogn(states, N, histories_size);
+
+    free(keys);
+
+    return log2((double) N) + s / N;
+}
+
+static bool check_shape(int const *series, size_t n, size_t m, int b,
     size_t kpast, size_t kfuture, inform_error *err)
 {
     if (series == NULL)
@@ -115,6 +213,20 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
+    else if (histogram_support(b, kpast + kfuture) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    return false;
+}
+
+static bool check_arguments(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_error *err)
+{
+    if (check_shape(series, n, m, b, kpast, kfuture, err))
+    {
+        return true;
+    }
     for (size_t i = 0; i < n * m; ++i)
     {
         if (series[i] < 0)
@@ -129,43 +241,80 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
-double inform_predictive_info(int const *series, size_t n, size_t m, int b,
-    size_t kpast, size_t kfuture, inform_error *err)
+/**
+ * Check the shape of a handle's series, whose states were validated when the
+ * handle was allocated.
+ */
+static bool check_series(inform_series const *series, size_t kpast,
+    size_t kfuture, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, kpast, kfuture, err)) return NAN;
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    return check_shape(series->data, series->n, series->m, series->b, kpast,
+        kfuture, err);
+}
 
+static double predictive_info(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_error *err)
+{
     size_t const N = n * (m - kpast - kfuture + 1);
 
-    size_t const histories_size = (size_t) pow((double) b, (double) kpast);
-    size_t const futures_size = (size_t) pow((double) b, (double) kfuture);
-    size_t const states_size = histories_size * futures_size;
-    size_t const total_size = states_size + histories_size + futures_size;
+    uint64_t const histories_size = histogram_support(b, kpast);
+    uint64_t const futures_size = histogram_support(b, kfuture);
+    uint64_t const states_size = histories_size * futures_size;
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (histogram_prefers_sort(states_size, N))
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        return sorted_predictive_info(series, n, m, b, kpast, kfuture,
+            histories_size, futures_size, err);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
-    inform_dist futures   = { data + states_size + histories_size, futures_size, N };
+    uint64_t const sizes[3] = {states_size, histories_size, futures_size};
+    histogram hs[3];
+    if (histograms_init(hs, sizes, 3, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    histogram *states = hs, *histories = hs + 1, *futures = hs + 2;
 
-    accumulate_observations(series, n, m, b, kpast, kfuture, &states,
-        &histories, &futures);
+    observations const obs = { series, m, b, kpast, kfuture };
+    bool overflow = false;
+    if (inform_accumulate_blocks(accumulate_block, &obs, n, kpast + kfuture,
+        m + 1, hs, sizes, 3, &overflow))
+    {
+        histograms_free(hs, 3);
+        INFORM_ERROR_RETURN(err,
+            overflow ? INFORM_FAILURE : INFORM_ENOMEM, NAN);
+    }
 
-    double pi = inform_shannon_mi(&states, &histories, &futures, 2.0);
+    double pi = log2((double) N) + (histogram_nlogn(states) -
+        histogram_nlogn(histories) - histogram_nlogn(futures)) / N;
 
-    free(data);
+    histograms_free(hs, 3);
 
     return pi;
 }
 
-double *inform_local_predictive_info(int const *series, size_t n, size_t m,
-    int b, size_t kpast, size_t kfuture, double *pi, inform_error *err)
+double inform_predictive_info(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, kpast, kfuture, err)) return NULL;
+    if (check_arguments(series, n, m, b, kpast, kfuture, err)) return NAN;
+    return predictive_info(series, n, m, b, kpast, kfuture, err);
+}
 
+double inform_predictive_info_series(inform_series const *series,
+    size_t kpast, size_t kfuture, inform_error *err)
+{
+    if (check_series(series, kpast, kfuture, err)) return NAN;
+    return predictive_info(series->data, series->n, series->m, series->b,
+        kpast, kfuture, err);
+}
+
+static double *local_predictive_info(int const *series, size_t n, size_t m,
+    int b, size_t kpast, size_t kfuture, double *pi, inform_error *err)
+{
     size_t const N = n * (m - kpast - kfuture + 1);
 
     bool allocate_pi = (pi == NULL);
@@ -178,47 +327,103 @@ double *inform_local_predictive_info(int const *series, size_t n, size_t m,
         }
     }
 
-    size_t const histories_size = (size_t) pow((double) b, (double) kpast);
-    size_t const futures_size = (size_t) pow((double) b, (double) kfuture);
-    size_t const states_size = histories_size * futures_size;
-    size_t const total_size = states_size + histories_size + futures_size;
+    uint64_t const histories_size = histogram_support(b, kpast);
+    uint64_t const futures_size = histogram_support(b, kfuture);
+    uint64_t const states_size = histories_size * futures_size;
 
-    uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
-    if (histogram_data == NULL)
+    uint64_t const sizes[3] = {states_size, histories_size, futures_size};
+    histogram hs[3];
+    if (histograms_init(hs, sizes, 3, N))
     {
         if (allocate_pi) free(pi);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+    histogram *states = hs, *histories = hs + 1, *futures = hs + 2;
 
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
-    inform_dist futures   = { histogram_data + states_size + histories_size, futures_size, N };
-
-    int *state_data = malloc(3 * N * sizeof(int));
-    if (state_data == NULL)
+    observations const obs = { series, m, b, kpast, kfuture };
+    bool overflow = false;
+    if (inform_accumulate_blocks(accumulate_block, &obs, n, kpast + kfuture,
+        m + 1, hs, sizes, 3, &overflow))
     {
         if (allocate_pi) free(pi);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        histograms_free(hs, 3);
+        INFORM_ERROR_RETURN(err,
+            overflow ? INFORM_FAILURE : INFORM_ENOMEM, NULL);
     }
-    int *state   = state_data;
-    int *history = state + N;
-    int *future  = history + N;
 
-    accumulate_local_observations(series, n, m, b, kpast, kfuture, &states,
-        &histories, &futures, state, history, future);
+    local_observations(series, n, m, b, kpast, kfuture, states, histories,
+        futures, pi);
 
-    double s, h, f;
-    for (size_t i = 0; i < N; ++i)
-    {
-        s = states.histogram[state[i]];
-        h = histories.histogram[history[i]];
-        f = futures.histogram[future[i]];
-        pi[i] = log2((s * N) / (h * f));
-    }
-
-    free(state_data);
-    free(histogram_data);
+    histograms_free(hs, 3);
 
     return pi;
 }
+
+double *inform_local_predictive_info(int const *series, size_t n, size_t m,
+    int b, size_t kpast, size_t kfuture, double *pi, inform_error *err)
+{
+    if (check_arguments(series, n, m, b, kpast, kfuture, err)) return NULL;
+    return local_predictive_info(series, n, m, b, kpast, kfuture, pi, err);
+}
+
+double *inform_local_predictive_info_series(inform_series const *series,
+    size_t kpast, size_t kfuture, double *pi, inform_error *err)
+{
+    if (check_series(series, kpast, kfuture, err)) return NULL;
+    return local_predictive_info(series->data, series->n, series->m,
+        series->b, kpast, kfuture, pi, err);
+}
+
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    return accumulate_observations(series, m, acc->b, acc->k, acc->k2,
+        (observation_block){ 0, 1, acc->k + acc->k2, m + 1 }, acc->hs,
+        acc->hs + 1, acc->hs + 2);
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return log2((double) N) + (histogram_nlogn(acc->hs) -
+        histogram_nlogn(acc->hs + 1) - histogram_nlogn(acc->hs + 2)) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *pi)
+{
+    local_observations(series, 1, m, acc->b, acc->k, acc->k2, acc->hs,
+        acc->hs + 1, acc->hs + 2, pi);
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_PREDICTIVE_INFO
+};
+
+inform_acc *inform_predictive_info_acc(int b, size_t kpast, size_t kfuture,
+    inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (kpast == 0 || kfuture == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    }
+    else if (histogram_support(b, kpast + kfuture) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    uint64_t const histories_size = histogram_support(b, kpast);
+    uint64_t const futures_size = histogram_support(b, kfuture);
+    uint64_t const states_size = histories_size * futures_size;
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, &b, 1, kpast + kfuture,
+        (uint64_t[]){states_size, histories_size, futures_size}, 3, err);
+    if (acc != NULL)
+    {
+        acc->b = b;
+        acc->k = kpast;
+        acc->k2 = kfuture;
+    }
+    return acc;
+}
@@ -0,0 +1,94 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "radix_sort.h"
+#include "log_table.h"
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_SIZE - 1)
+
+static int compare(void const *x, void const *y)
+{
+    uint64_t const a = *(uint64_t const *) x;
+    uint64_t const b = *(uint64_t const *) y;
+    return (a < b) ? -1 : (a > b);
+}
+
+uint64_t *inform_radix_sort(uint64_t *keys, uint64_t *scratch, size_t n,
+    uint64_t max)
+{
+    if (n == 0)
+    {
+        return keys;
+    }
+    size_t passes = 0;
+    for (uint64_t x = max; x != 0; x >>= RADIX_BITS)
+    {
+        ++passes;
+    }
+
+    // build the digit histograms for every pass in a single sweep
+    size_t (*counts)[RADIX_SIZE] = calloc(passes ? passes : 1, sizeof *counts);
+    if (counts == NULL)
+    {
+        // fall back to a comparison sort rather than failing outright
+        qsort(keys, n, sizeof(uint64_t), compare);
+        return keys;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t key = keys[i];
+        for (size_t p = 0; p < passes; ++p, key >>= RADIX_BITS)
+        {
+            counts[p][key & RADIX_MASK]++;
+        }
+    }
+
+    uint64_t *src = keys, *dst = scratch;
+    for (size_t p = 0; p < passes; ++p)
+    {
+        size_t *count = counts[p];
+        // every key shares this digit, so the pass would be the identity
+        if (count[(src[0] >> (p * RADIX_BITS)) & RADIX_MASK] == n)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t d = 0; d < RADIX_SIZE; ++d)
+        {
+            size_t const c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t const d = (src[i] >> (p * RADIX_BITS)) & RADIX_MASK;
+            dst[count[d]++] = src[i];
+        }
+        uint64_t *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    free(counts);
+    return src;
+}
+
+double inform_sorted_nlogn(uint64_t const *keys, size_t n, uint64_t divisor)
+{
+    double s = 0.0;
+    size_t i = 0;
+    while (i < n)
+    {
+        uint64_t const run = keys[i] / divisor;
+        size_t j = i + 1;
+        while (j < n && keys[j] / divisor == run)
+        {
+            ++j;
+        }
+        s += inform_nlog2n_count(j - i);
+        i = j;
+    }
+    return s;
+}
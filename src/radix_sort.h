@@ -0,0 +1,32 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Sort an array of keys with a least-significant-digit radix sort.
+ *
+ * Only the digits needed to represent `max` are sorted, and digits on which
+ * every key agrees are skipped, so the cost is O(n) per significant byte.
+ *
+ * @param[in,out] keys  the keys to sort
+ * @param[in] scratch   a buffer of at least `n` keys
+ * @param[in] n         the number of keys
+ * @param[in] max       an upper bound on the keys
+ * @return a pointer to the sorted keys, either `keys` or `scratch`
+ */
+uint64_t *inform_radix_sort(uint64_t *keys, uint64_t *scratch, size_t n,
+    uint64_t max);
+
+/**
+ * Compute @f \sum_i c_i \log_2 c_i @f where the @f c_i @f are the lengths of
+ * the runs of `keys[j] / divisor` in a sorted array of keys.
+ *
+ * Dividing by `divisor` marginalizes out the least significant terms of the
+ * encoding, so the counts of every prefix of an encoded tuple can be read
+ * off of a single sorted array.
+ */
+double inform_sorted_nlogn(uint64_t const *keys, size_t n, uint64_t divisor);
@@ -3,8 +3,10 @@
 // license that can be found in the LICENSE file.
 #include <inform/relative_entropy.h>
 #include <inform/shannon.h>
+#include "count.h"
+#include "log_table.h"
 
-static bool check_arguments(int const *xs, int const *ys, size_t n, int b,
+static bool check_shape(int const *xs, int const *ys, size_t n, int b,
     inform_error *err)
 {
     if (xs == NULL)
@@ -23,6 +25,16 @@ static bool check_arguments(int const *xs, int const *ys, size_t n, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
     }
+    return false;
+}
+
+static bool check_arguments(int const *xs, int const *ys, size_t n, int b,
+    inform_error *err)
+{
+    if (check_shape(xs, ys, n, b, err))
+    {
+        return true;
+    }
     for (size_t i = 0; i < n; ++i)
     {
         if (xs[i] < 0 || ys[i] < 0)
@@ -37,6 +49,28 @@ static bool check_arguments(int const *xs, int const *ys, size_t n, int b,
     return false;
 }
 
+/**
+ * Check the shapes of a pair of handles, whose states were validated when
+ * the handles were allocated. Each handle is taken as a single series of all
+ * of its time steps, and both are valid in the larger of their bases.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *xs, inform_series const *ys,
+    int *b, inform_error *err)
+{
+    if (xs == NULL || ys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (xs->n * xs->m != ys->n * ys->m)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    *b = (xs->b > ys->b) ? xs->b : ys->b;
+    return check_shape(xs->data, ys->data, xs->n * xs->m, *b, err);
+}
+
 inline static bool allocate(int b, inform_dist **x, inform_dist **y,
     inform_error *err)
 {
@@ -58,11 +92,8 @@ inline static void accumulate(int const *xs, int const *ys, size_t n,
     x->counts = n;
     y->counts = n;
 
-    for (size_t i = 0; i < n; ++i)
-    {
-        x->histogram[xs[i]]++;
-        y->histogram[ys[i]]++;
-    }
+    inform_count(x->histogram, x->size, xs, n);
+    inform_count(y->histogram, y->size, ys, n);
 }
 
 inline static void free_all(inform_dist **x, inform_dist **y)
@@ -71,11 +102,9 @@ inline static void free_all(inform_dist **x, inform_dist **y)
     inform_dist_free(*y);
 }
 
-double inform_relative_entropy(int const *xs, int const *ys, size_t n, int b,
+static double relative_entropy(int const *xs, int const *ys, size_t n, int b,
     inform_error *err)
 {
-    if (check_arguments(xs, ys, n, b, err)) return NAN;
-
     inform_dist *x = NULL, *y = NULL;
     if (allocate(b, &x, &y, err)) return NAN;
 
@@ -88,11 +117,24 @@ double inform_relative_entropy(int const *xs, int const *ys, size_t n, int b,
     return re;
 }
 
-double *inform_local_relative_entropy(int const *xs, int const *ys, size_t n,
-    int b, double *re, inform_error *err)
+double inform_relative_entropy(int const *xs, int const *ys, size_t n, int b,
+    inform_error *err)
 {
-    if (check_arguments(xs, ys, n, b, err)) return NULL;
+    if (check_arguments(xs, ys, n, b, err)) return NAN;
+    return relative_entropy(xs, ys, n, b, err);
+}
 
+double inform_relative_entropy_series(inform_series const *xs,
+    inform_series const *ys, inform_error *err)
+{
+    int b;
+    if (check_series(xs, ys, &b, err)) return NAN;
+    return relative_entropy(xs->data, ys->data, xs->n * xs->m, b, err);
+}
+
+static double *local_relative_entropy(int const *xs, int const *ys, size_t n,
+    int b, double *re, inform_error *err)
+{
     bool allocate_re = (re == NULL);
     if (allocate_re)
     {
@@ -110,15 +152,29 @@ double *inform_local_relative_entropy(int const *xs, int const *ys, size_t n,
 
     accumulate(xs, ys, n, x, y);
 
-    double p, q;
     for (size_t i = 0; i < (size_t) b; ++i)
     {
-        p = x->histogram[i];
-        q = y->histogram[i];
-        re[i] = log2(p / q);
+        re[i] = inform_log2_count(x->histogram[i]) -
+            inform_log2_count(y->histogram[i]);
     }
 
     free_all(&x, &y);
 
     return re;
-}
\ No newline at end of file
+}
+
+double *inform_local_relative_entropy(int const *xs, int const *ys, size_t n,
+    int b, double *re, inform_error *err)
+{
+    if (check_arguments(xs, ys, n, b, err)) return NULL;
+    return local_relative_entropy(xs, ys, n, b, re, err);
+}
+
+double *inform_local_relative_entropy_series(inform_series const *xs,
+    inform_series const *ys, double *re, inform_error *err)
+{
+    int b;
+    if (check_series(xs, ys, &b, err)) return NULL;
+    return local_relative_entropy(xs->data, ys->data, xs->n * xs->m, b, re,
+        err);
+}
@@ -2,9 +2,40 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/active_info.h>
+#include <inform/separable_info.h>
 #include <inform/transfer_entropy.h>
 #include <math.h>
 
+/**
+ * Check that the handle of a set of sources stacks whole ensembles of the
+ * destination's shape.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *srcs, inform_series const *dest,
+    inform_error *err)
+{
+    if (srcs == NULL || dest == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (srcs->m != dest->m || srcs->n % dest->n != 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    return false;
+}
+
+/**
+ * Get the handle of the `i`-th of a stack of sources, each of `n` initial
+ * conditions.
+ */
+static inform_series source(inform_series const *srcs, size_t n, size_t i)
+{
+    return (inform_series){ srcs->data + i * n * srcs->m, n, srcs->m, srcs->b,
+        srcs->max_state, 0, NULL };
+}
+
 double inform_separable_info(int const *srcs, int const *dest, size_t l,
     size_t n, size_t m, int b, size_t k, inform_error *err)
 {
@@ -22,6 +53,24 @@ double inform_separable_info(int const *srcs, int const *dest, size_t l,
     return si;
 }
 
+double inform_separable_info_series(inform_series const *srcs,
+    inform_series const *dest, size_t k, inform_error *err)
+{
+    if (check_series(srcs, dest, err)) return NAN;
+
+    double si = inform_active_info_series(dest, k, err);
+    if (isnan(si)) return NAN;
+
+    for (size_t i = 0; i < srcs->n / dest->n; ++i)
+    {
+        inform_series const src = source(srcs, dest->n, i);
+        si += inform_transfer_entropy_series(&src, dest, NULL, k, err);
+        if (isnan(si)) return NAN;
+    }
+
+    return si;
+}
+
 double *inform_local_separable_info(int const *srcs, int const *dest,
     size_t l, size_t n, size_t m, int b, size_t k, double *si,
     inform_error *err)
@@ -61,3 +110,39 @@ double *inform_local_separable_info(int const *srcs, int const *dest,
 
     return si;
 }
+
+double *inform_local_separable_info_series(inform_series const *srcs,
+    inform_series const *dest, size_t k, double *si, inform_error *err)
+{
+    if (check_series(srcs, dest, err)) return NULL;
+
+    bool allocated_si = (si == NULL);
+
+    si = inform_local_active_info_series(dest, k, si, err);
+    if (si == NULL) return NULL;
+
+    size_t const N = dest->n * (dest->m - k);
+    double *te = malloc(N * sizeof(double));
+    if (te == NULL)
+    {
+        if (allocated_si) free(si);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    for (size_t i = 0; i < srcs->n / dest->n; ++i)
+    {
+        inform_series const src = source(srcs, dest->n, i);
+        if (inform_local_transfer_entropy_series(&src, dest, NULL, k, te,
+            err) == NULL)
+        {
+            free(te);
+            if (allocated_si) free(si);
+            return NULL;
+        }
+        for (size_t j = 0; j < N; ++j) si[j] += te[j];
+    }
+
+    free(te);
+
+    return si;
+}
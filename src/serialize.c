@@ -0,0 +1,314 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "serialize.h"
+#include <stdio.h>
+#include <string.h>
+#include "radix_sort.h"
+
+/// the encodings of a block of counts
+enum { SERIAL_DENSE = 0, SERIAL_SPARSE = 1 };
+
+static size_t varint_size(uint64_t x)
+{
+    size_t n = 1;
+    while (x >= 0x80)
+    {
+        x >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+void serial_put_byte(serial_writer *w, uint8_t x)
+{
+    if (w->buffer != NULL && w->size < w->capacity)
+    {
+        w->buffer[w->size] = x;
+    }
+    w->size++;
+}
+
+void serial_put_varint(serial_writer *w, uint64_t x)
+{
+    while (x >= 0x80)
+    {
+        serial_put_byte(w, (uint8_t) (x | 0x80));
+        x >>= 7;
+    }
+    serial_put_byte(w, (uint8_t) x);
+}
+
+void serial_put_header(serial_writer *w, char const *tag)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        serial_put_byte(w, (uint8_t) tag[i]);
+    }
+    serial_put_byte(w, SERIAL_VERSION);
+    for (size_t i = 5; i < SERIAL_HEADER_SIZE; ++i)
+    {
+        serial_put_byte(w, 0);
+    }
+}
+
+void serial_put_counts(serial_writer *w, uint64_t support,
+    uint64_t const *events, uint32_t const *counts, size_t n)
+{
+    uint64_t total = 0, previous = 0;
+    size_t nonzero = 0, dense_size = 0, sparse_size = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t event = i;
+        if (events == NULL)
+        {
+            dense_size += varint_size(counts[i]);
+            if (counts[i] == 0)
+            {
+                continue;
+            }
+        }
+        else
+        {
+            event = events[i];
+        }
+        total += counts[i];
+        sparse_size += varint_size(event - previous) + varint_size(counts[i]);
+        previous = event;
+        nonzero++;
+    }
+    sparse_size += varint_size(nonzero);
+
+    serial_put_varint(w, support);
+    serial_put_varint(w, total);
+    if (events == NULL && dense_size <= sparse_size)
+    {
+        serial_put_byte(w, SERIAL_DENSE);
+        for (size_t i = 0; i < n; ++i)
+        {
+            serial_put_varint(w, counts[i]);
+        }
+        return;
+    }
+    serial_put_byte(w, SERIAL_SPARSE);
+    serial_put_varint(w, nonzero);
+    previous = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (counts[i] != 0)
+        {
+            uint64_t const event = (events == NULL) ? i : events[i];
+            serial_put_varint(w, event - previous);
+            serial_put_varint(w, counts[i]);
+            previous = event;
+        }
+    }
+}
+
+bool serial_put_histogram(serial_writer *w, histogram const *h,
+    uint64_t support)
+{
+    if (h->sparse == NULL)
+    {
+        serial_put_counts(w, support, NULL, h->dense.histogram, h->dense.size);
+        return false;
+    }
+
+    // the hash table is unordered, so the events are sorted for gap coding
+    size_t const n = h->sparse->size;
+    uint64_t *keys = malloc((2 * n + 1) * sizeof(uint64_t));
+    uint32_t *counts = malloc((n + 1) * sizeof(uint32_t));
+    if (keys == NULL || counts == NULL)
+    {
+        free(keys);
+        free(counts);
+        return true;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < h->sparse->capacity; ++i)
+    {
+        if (h->sparse->histogram[i] != 0)
+        {
+            keys[j++] = h->sparse->events[i];
+        }
+    }
+    uint64_t const *events = inform_radix_sort(keys, keys + n, n, support - 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+        counts[i] = inform_sparse_dist_get(h->sparse, events[i]);
+    }
+    serial_put_counts(w, support, events, counts, n);
+    free(counts);
+    free(keys);
+    return false;
+}
+
+uint8_t serial_get_byte(serial_reader *r)
+{
+    if (r->failed || r->pos >= r->size)
+    {
+        r->failed = true;
+        return 0;
+    }
+    return r->buffer[r->pos++];
+}
+
+uint64_t serial_get_varint(serial_reader *r)
+{
+    uint64_t x = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t const byte = serial_get_byte(r);
+        if (r->failed || (shift == 63 && byte > 1))
+        {
+            r->failed = true;
+            return 0;
+        }
+        x |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return x;
+        }
+    }
+    r->failed = true;
+    return 0;
+}
+
+void serial_get_header(serial_reader *r, char const *tag)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (serial_get_byte(r) != (uint8_t) tag[i])
+        {
+            r->failed = true;
+        }
+    }
+    if (serial_get_byte(r) != SERIAL_VERSION)
+    {
+        r->failed = true;
+    }
+    for (size_t i = 5; i < SERIAL_HEADER_SIZE; ++i)
+    {
+        serial_get_byte(r);
+    }
+}
+
+/**
+ * Store a count read from a block.
+ *
+ * @return false if the sparse table could not grow to hold the event
+ */
+static bool put_count(histogram *h, uint64_t event, uint32_t count)
+{
+    if (h->sparse == NULL)
+    {
+        h->dense.histogram[event] = count;
+        h->dense.counts += count;
+        return true;
+    }
+    return inform_sparse_dist_set(h->sparse, event, count) != 0;
+}
+
+inform_error serial_get_histogram(serial_reader *r, histogram *h,
+    uint64_t support)
+{
+    uint64_t const size = serial_get_varint(r);
+    uint64_t const total = serial_get_varint(r);
+    uint8_t const encoding = serial_get_byte(r);
+    if (r->failed || size != support ||
+        (h->sparse == NULL && h->dense.size != support))
+    {
+        return INFORM_EFORMAT;
+    }
+
+    uint64_t sum = 0;
+    if (encoding == SERIAL_DENSE)
+    {
+        for (uint64_t event = 0; event < support && !r->failed; ++event)
+        {
+            uint64_t const count = serial_get_varint(r);
+            if (count > UINT32_MAX || count > total - sum)
+            {
+                return INFORM_EFORMAT;
+            }
+            if (count != 0 && !put_count(h, event, (uint32_t) count))
+            {
+                return INFORM_ENOMEM;
+            }
+            sum += count;
+        }
+    }
+    else if (encoding == SERIAL_SPARSE)
+    {
+        uint64_t const nonzero = serial_get_varint(r);
+        uint64_t event = 0;
+        for (uint64_t i = 0; i < nonzero && !r->failed; ++i)
+        {
+            uint64_t const gap = serial_get_varint(r);
+            uint64_t const count = serial_get_varint(r);
+            // events are strictly increasing and lie within the support
+            if ((i != 0 && gap == 0) || gap >= support - event ||
+                count == 0 || count > UINT32_MAX || count > total - sum)
+            {
+                return INFORM_EFORMAT;
+            }
+            event += gap;
+            if (!put_count(h, event, (uint32_t) count))
+            {
+                return INFORM_ENOMEM;
+            }
+            sum += count;
+        }
+    }
+    else
+    {
+        return INFORM_EFORMAT;
+    }
+    return (r->failed || sum != total) ? INFORM_EFORMAT : INFORM_SUCCESS;
+}
+
+bool serial_write_file(char const *path, uint8_t const *buffer, size_t n)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return true;
+    }
+    bool const failed = fwrite(buffer, 1, n, file) != n;
+    return (fclose(file) != 0) || failed;
+}
+
+uint8_t *serial_read_file(char const *path, size_t *n, inform_error *err)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EIO, NULL);
+    }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        size = ftell(file);
+        rewind(file);
+    }
+    if (size < 0)
+    {
+        fclose(file);
+        INFORM_ERROR_RETURN(err, INFORM_EIO, NULL);
+    }
+    uint8_t *buffer = malloc((size_t) size + 1);
+    if (buffer == NULL)
+    {
+        fclose(file);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    if (fread(buffer, 1, (size_t) size, file) != (size_t) size)
+    {
+        free(buffer);
+        fclose(file);
+        INFORM_ERROR_RETURN(err, INFORM_EIO, NULL);
+    }
+    fclose(file);
+    *n = (size_t) size;
+    return buffer;
+}
@@ -0,0 +1,128 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "histogram.h"
+
+/// the version of the serialized format written by this library
+#define SERIAL_VERSION 1
+/// the number of bytes in the header of every record
+#define SERIAL_HEADER_SIZE 8
+
+/**
+ * A destination for serialized bytes
+ *
+ * Bytes are only stored while they fit within the buffer, but every byte
+ * is counted, so that a writer with no buffer measures the size of a record.
+ */
+typedef struct serial_writer
+{
+    /// the buffer, or NULL to only count bytes
+    uint8_t *buffer;
+    /// the size of the buffer
+    size_t capacity;
+    /// the number of bytes written so far
+    size_t size;
+} serial_writer;
+
+/**
+ * A source of serialized bytes
+ *
+ * Reading past the end of the buffer, or reading a malformed value, marks
+ * the reader as failed; subsequent reads return zero.
+ */
+typedef struct serial_reader
+{
+    /// the buffer
+    uint8_t const *buffer;
+    /// the size of the buffer
+    size_t size;
+    /// the number of bytes read so far
+    size_t pos;
+    /// whether a read has failed
+    bool failed;
+} serial_reader;
+
+/**
+ * Write a byte.
+ */
+void serial_put_byte(serial_writer *w, uint8_t x);
+
+/**
+ * Write an unsigned integer in LEB128 form, i.e. seven bits per byte, least
+ * significant first, with the high bit set on all but the last byte.
+ */
+void serial_put_varint(serial_writer *w, uint64_t x);
+
+/**
+ * Write a record header: a four-byte tag, the format version and three
+ * bytes reserved for future use.
+ */
+void serial_put_header(serial_writer *w, char const *tag);
+
+/**
+ * Write a block of counts over a support of a given size.
+ *
+ * When `events` is NULL, `counts` is a dense array of `n` counts, one for
+ * every event in the support, and the block is written densely or as a
+ * list of non-zero counts, whichever is smaller. Otherwise `n` non-zero
+ * counts are given for the strictly increasing `events`, and the block is
+ * always written as a list.
+ */
+void serial_put_counts(serial_writer *w, uint64_t support,
+    uint64_t const *events, uint32_t const *counts, size_t n);
+
+/**
+ * Write the counts of a histogram.
+ *
+ * @return true if memory could not be allocated to order a sparse histogram
+ */
+bool serial_put_histogram(serial_writer *w, histogram const *h,
+    uint64_t support);
+
+/**
+ * Read a byte.
+ */
+uint8_t serial_get_byte(serial_reader *r);
+
+/**
+ * Read an unsigned integer written by serial_put_varint.
+ */
+uint64_t serial_get_varint(serial_reader *r);
+
+/**
+ * Read a record header, checking its tag and version.
+ */
+void serial_get_header(serial_reader *r, char const *tag);
+
+/**
+ * Read a block of counts into an empty histogram with the given support.
+ *
+ * @return INFORM_EFORMAT if the block is malformed or has a different
+ *         support, INFORM_ENOMEM if the histogram could not grow, and
+ *         INFORM_SUCCESS otherwise
+ */
+inform_error serial_get_histogram(serial_reader *r, histogram *h,
+    uint64_t support);
+
+/**
+ * Write a buffer to a file, replacing its contents.
+ *
+ * @return true if the file could not be written
+ */
+bool serial_write_file(char const *path, uint8_t const *buffer, size_t n);
+
+/**
+ * Read the entire contents of a file.
+ *
+ * @param[in] path the path of the file
+ * @param[out] n   the number of bytes read
+ * @param[out] err an error structure
+ * @return the contents, or NULL on error
+ */
+uint8_t *serial_read_file(char const *path, size_t *n, inform_error *err);
@@ -0,0 +1,106 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "histogram.h"
+#include "series.h"
+
+inform_series *inform_series_alloc(int const *data, size_t n, size_t m,
+    int b, inform_error *err)
+{
+    if (data == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, NULL);
+    }
+    else if (m < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NULL);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+
+    // compared as unsigned, a negative state exceeds every valid one
+    unsigned max_state = 0;
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        unsigned const state = (unsigned) data[i];
+        max_state = (state > max_state) ? state : max_state;
+    }
+    if (max_state >= (unsigned) b)
+    {
+        size_t const i = inform_valid_prefix(data, n * m, b);
+        INFORM_ERROR_RETURN(err, (data[i] < 0) ? INFORM_ENEGSTATE :
+            INFORM_EBADSTATE, NULL);
+    }
+
+    inform_series *series = malloc(sizeof(inform_series));
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    *series = (inform_series){ data, n, m, b, (int) max_state, 0, NULL };
+    return series;
+}
+
+bool inform_series_encode(inform_series *series, size_t k, inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (series->m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    else if (histogram_support(series->b, k) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+
+    size_t const n = series->n, m = series->m;
+    int const b = series->b;
+    uint64_t *histories = realloc(series->histories,
+        n * (m - k) * sizeof(uint64_t));
+    if (histories == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+
+    uint64_t const q = histogram_support(b, k);
+    int const *data = series->data;
+    uint64_t *history = histories;
+    for (size_t i = 0; i < n; ++i, data += m)
+    {
+        uint64_t h = 0;
+        for (size_t j = 0; j < k; ++j)
+        {
+            h = h * b + data[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            *history++ = h;
+            h = h * b + data[j] - data[j - k] * q;
+        }
+    }
+    series->k = k;
+    series->histories = histories;
+    return false;
+}
+
+void inform_series_free(inform_series *series)
+{
+    if (series != NULL)
+    {
+        free(series->histories);
+        free(series);
+    }
+}
@@ -0,0 +1,19 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/series.h>
+
+/**
+ * Get the encoded length-`k` histories of a handle, if it has them.
+ *
+ * @param[in] series the handle
+ * @param[in] k      the history length
+ * @return the histories, or NULL if none of length `k` have been encoded
+ */
+static inline uint64_t const *inform_series_histories(inform_series const *series,
+    size_t k)
+{
+    return (series->k == k) ? series->histories : NULL;
+}
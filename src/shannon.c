@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include <inform/shannon.h>
 #include <inform/error.h>
+#include "simd.h"
 
 double inform_shannon_si(inform_dist const *dist, size_t event, double base)
 {
@@ -20,6 +21,14 @@ double inform_shannon_entropy(inform_dist const *dist, double base)
     {
         // get the size of the distribution's support
         size_t const n = inform_dist_size(dist);
+        // reduce large histograms as log2(N) - sum(c log2 c)/N, vectorized
+        if (n >= INFORM_SIMD_MIN_SIZE)
+        {
+            double const N = (double) dist->counts;
+            double const s = inform_weighted_log2(dist->histogram,
+                dist->histogram, n);
+            return (log2(N) - s / N) / log2(base);
+        }
         double h = 0.;
         // for each element of the distribution's support
         for (size_t i = 0; i < n; ++i)
@@ -40,6 +49,38 @@ double inform_shannon_entropy(inform_dist const *dist, double base)
     return NAN;
 }
 
+double inform_shannon_sparse_entropy(inform_sparse_dist const *dist,
+    double base)
+{
+    // ensure that the distribution is valid
+    if (inform_sparse_dist_is_valid(dist))
+    {
+        if (dist->capacity >= INFORM_SIMD_MIN_SIZE)
+        {
+            double const N = (double) dist->counts;
+            double const s = inform_weighted_log2(dist->histogram,
+                dist->histogram, dist->capacity);
+            return (log2(N) - s / N) / log2(base);
+        }
+        double h = 0.;
+        // for each occupied slot of the distribution's table
+        for (size_t i = 0; i < dist->capacity; ++i)
+        {
+            if (dist->histogram[i] != 0)
+            {
+                // get the probability
+                double const p = (double) dist->histogram[i] / dist->counts;
+                // accumulate the weighted self-information of the event
+                h -= p * log2(p);
+            }
+        }
+        // return the entropy
+        return h / log2(base);
+    }
+    // return NaN if the distribution is invalid
+    return NAN;
+}
+
 double inform_shannon_pmi(inform_dist const *joint,
     inform_dist const * marginal_x, inform_dist const *marginal_y,
     size_t event_joint, size_t event_x, size_t event_y, double base)
@@ -109,6 +150,20 @@ double inform_shannon_re(inform_dist const *p, inform_dist const *q,
 {
     if (inform_dist_is_valid(p) && inform_dist_is_valid(q) && p->size == q->size)
     {
+        if (p->size >= INFORM_SIMD_MIN_SIZE)
+        {
+            double const cross = inform_weighted_log2(p->histogram,
+                q->histogram, p->size);
+            if (isinf(cross))
+            {
+                return NAN;
+            }
+            double const self = inform_weighted_log2(p->histogram,
+                p->histogram, p->size);
+            double const re = (self - cross) / p->counts +
+                log2((double) q->counts / p->counts);
+            return re / log2(base);
+        }
         double re = 0.;
         for (size_t i = 0; i < p->size; ++i)
         {
@@ -133,6 +188,13 @@ double inform_shannon_cross(inform_dist const *p, inform_dist const *q,
 {
     if (inform_dist_is_valid(p) && inform_dist_is_valid(q) && p->size == q->size)
     {
+        if (p->size >= INFORM_SIMD_MIN_SIZE)
+        {
+            double const cross = inform_weighted_log2(p->histogram,
+                q->histogram, p->size);
+            double const ce = log2((double) q->counts) - cross / p->counts;
+            return ce / log2(base);
+        }
         double ce = 0.;
         for (size_t i = 0; i < p->size; ++i)
         {
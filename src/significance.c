@@ -0,0 +1,604 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/significance.h>
+#include "histogram.h"
+#include "thread.h"
+
+/**
+ * A measure reduced to what varies between its surrogates
+ *
+ * Every observation has a symbol, taken from the series being resampled, and
+ * a code for each of the histograms which depend upon that symbol; the
+ * symbol is added to the code to get the event observed. Everything else
+ * about the measure is fixed, so that the measure of a surrogate is
+ * @f offset + (fixed + S_0 - S_1) / N @f, where @f S_i @f is the sum of
+ * @f c \log_2 c @f over the counts of the i-th histogram.
+ */
+typedef struct significance_problem
+{
+    /// the number of observations
+    size_t N;
+    /// the number of initial conditions, each of N / n observations
+    size_t n;
+    /// the symbol of each observation
+    int *symbols;
+    /// the codes of each histogram
+    uint64_t *codes[2];
+    /// the support of each histogram
+    uint64_t sizes[2];
+    /// the number of histograms, one or two
+    size_t nhs;
+    /// the parts of the measure common to every surrogate
+    double offset, fixed;
+} significance_problem;
+
+typedef struct significance_job
+{
+    significance_problem const *problem;
+    inform_surrogates const *surrogates;
+    size_t tasks;
+    /// two histograms per task
+    histogram *hs;
+    /// room for the resampled symbols and block order of each task
+    int *scratch;
+    size_t *order;
+    double *null;
+    bool *failed;
+} significance_job;
+
+/**
+ * Get the next number from a splitmix64 generator.
+ */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += UINT64_C(0x9e3779b97f4a7c15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+/**
+ * Draw a number uniformly from [0, n) without modulo bias.
+ */
+static size_t random_below(uint64_t *state, size_t n)
+{
+    uint64_t const threshold = (0 - (uint64_t) n) % n;
+    uint64_t r;
+    do
+    {
+        r = next_random(state);
+    } while (r < threshold);
+    return (size_t) (r % n);
+}
+
+/**
+ * Resample the symbols of a problem into `out`.
+ */
+static void resample(significance_problem const *problem,
+    inform_surrogates const *surrogates, uint64_t *state, int *out,
+    size_t *order)
+{
+    size_t const N = problem->N;
+    int const *symbols = problem->symbols;
+    switch (surrogates->method)
+    {
+        case INFORM_SURROGATE_PERMUTE:
+        {
+            memcpy(out, symbols, N * sizeof(int));
+            for (size_t i = N - 1; i > 0; --i)
+            {
+                size_t const j = random_below(state, i + 1);
+                int const x = out[i];
+                out[i] = out[j];
+                out[j] = x;
+            }
+            break;
+        }
+        case INFORM_SURROGATE_BLOCK:
+        {
+            size_t const width = surrogates->block;
+            size_t const blocks = (N + width - 1) / width;
+            for (size_t i = 0; i < blocks; ++i)
+            {
+                order[i] = i;
+            }
+            for (size_t i = blocks - 1; i > 0; --i)
+            {
+                size_t const j = random_below(state, i + 1);
+                size_t const x = order[i];
+                order[i] = order[j];
+                order[j] = x;
+            }
+            for (size_t i = 0; i < blocks; ++i)
+            {
+                size_t const begin = order[i] * width;
+                size_t const len = (N - begin < width) ? N - begin : width;
+                memcpy(out, symbols + begin, len * sizeof(int));
+                out += len;
+            }
+            break;
+        }
+        default:
+        {
+            size_t const w = N / problem->n;
+            for (size_t i = 0; i < problem->n; ++i)
+            {
+                size_t const shift = (w > 1) ? 1 + random_below(state, w - 1) : 0;
+                for (size_t t = 0; t < w; ++t)
+                {
+                    out[i * w + (t + shift) % w] = symbols[i * w + t];
+                }
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Compute the measure for a set of (possibly resampled) symbols.
+ *
+ * @return NAN if out of memory
+ */
+static double measure(significance_problem const *problem, int const *symbols,
+    histogram *hs)
+{
+    bool ok = true;
+    for (size_t h = 0; h < problem->nhs; ++h)
+    {
+        histogram_clear(hs + h);
+        uint64_t const *codes = problem->codes[h];
+        for (size_t t = 0; t < problem->N; ++t)
+        {
+            ok &= histogram_tick(hs + h, codes[t] + symbols[t]);
+        }
+    }
+    if (!ok)
+    {
+        return NAN;
+    }
+    double s = problem->fixed + histogram_nlogn(hs);
+    if (problem->nhs == 2)
+    {
+        s -= histogram_nlogn(hs + 1);
+    }
+    return problem->offset + s / problem->N;
+}
+
+static void significance_task(void *arg, size_t index)
+{
+    significance_job const *job = arg;
+    significance_problem const *problem = job->problem;
+    inform_surrogates const *surrogates = job->surrogates;
+    histogram *hs = job->hs + 2 * index;
+    int *scratch = job->scratch + index * problem->N;
+    size_t *order = job->order + index * problem->N;
+
+    bool ok = true;
+    for (size_t i = index; i < surrogates->count && ok; i += job->tasks)
+    {
+        // each surrogate has its own stream, whichever task draws it
+        uint64_t state = surrogates->seed ^ next_random(&(uint64_t){ i });
+        resample(problem, surrogates, &state, scratch, order);
+        job->null[i] = measure(problem, scratch, hs);
+        ok = !isnan(job->null[i]);
+    }
+    job->failed[index] = !ok;
+}
+
+static bool check_surrogates(inform_surrogates const *surrogates, size_t N,
+    inform_error *err)
+{
+    if (surrogates == NULL || surrogates->count == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    switch (surrogates->method)
+    {
+        case INFORM_SURROGATE_PERMUTE:
+        case INFORM_SURROGATE_SHIFT:
+            return false;
+        case INFORM_SURROGATE_BLOCK:
+            if (surrogates->block != 0 && surrogates->block <= N)
+            {
+                return false;
+            }
+            INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+        default:
+            INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+}
+
+static bool check_states(int const *series, size_t n, int b,
+    inform_error *err)
+{
+    size_t const i = inform_valid_prefix(series, n, b);
+    if (i != n)
+    {
+        INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+            INFORM_EBADSTATE, true);
+    }
+    return false;
+}
+
+/**
+ * Allocate the symbols and codes of a problem with `N` observations.
+ *
+ * Room is made for the codes of two histograms even if only one is used, so
+ * that the second can hold the fixed events while they are counted.
+ */
+static bool problem_alloc(significance_problem *problem, size_t N, size_t n,
+    size_t nhs)
+{
+    problem->N = N;
+    problem->n = n;
+    problem->nhs = nhs;
+    problem->symbols = malloc(N * sizeof(int));
+    problem->codes[0] = malloc(2 * N * sizeof(uint64_t));
+    problem->codes[1] = problem->codes[0] + N;
+    if (problem->symbols == NULL || problem->codes[0] == NULL)
+    {
+        free(problem->symbols);
+        free(problem->codes[0]);
+        return true;
+    }
+    return false;
+}
+
+static void problem_free(significance_problem *problem)
+{
+    free(problem->symbols);
+    free(problem->codes[0]);
+}
+
+/**
+ * Compute @f \sum_i c_i \log_2 c_i @f over the counts of some events which
+ * do not depend upon the resampled symbols.
+ *
+ * @return true if out of memory
+ */
+static bool fixed_nlogn(uint64_t size, uint64_t const *events, size_t N,
+    double *s)
+{
+    histogram h;
+    if (histograms_init(&h, &size, 1, N))
+    {
+        return true;
+    }
+    bool ok = true;
+    for (size_t t = 0; t < N; ++t)
+    {
+        ok &= histogram_tick(&h, events[t]);
+    }
+    *s = histogram_nlogn(&h);
+    histograms_free(&h, 1);
+    return !ok;
+}
+
+/**
+ * Measure the original series and its surrogates.
+ *
+ * @return the p-value
+ */
+static double significance(significance_problem const *problem,
+    inform_surrogates const *surrogates, double *null, double *value,
+    inform_error *err)
+{
+    size_t const N = problem->N, count = surrogates->count;
+    size_t tasks = inform_get_num_threads();
+    if (tasks > count)
+    {
+        tasks = count;
+    }
+
+    bool allocate_null = (null == NULL);
+    if (allocate_null)
+    {
+        null = malloc(count * sizeof(double));
+    }
+    histogram *hs = malloc(2 * tasks * sizeof(histogram));
+    int *scratch = malloc(tasks * N * sizeof(int));
+    size_t *order = NULL;
+    if (surrogates->method == INFORM_SURROGATE_BLOCK)
+    {
+        order = malloc(tasks * N * sizeof(size_t));
+    }
+    bool *failed = calloc(tasks, sizeof(bool));
+    size_t initialized = 0;
+    if (null != NULL && hs != NULL && scratch != NULL && failed != NULL &&
+        (order != NULL || surrogates->method != INFORM_SURROGATE_BLOCK))
+    {
+        // the histograms are chosen on this thread, where the engine is set
+        while (initialized < tasks &&
+            !histograms_init(hs + 2 * initialized, problem->sizes,
+                problem->nhs, N))
+        {
+            ++initialized;
+        }
+    }
+
+    double observed = NAN, p = NAN;
+    if (initialized == tasks)
+    {
+        observed = measure(problem, problem->symbols, hs);
+    }
+    if (!isnan(observed))
+    {
+        significance_job job = { problem, surrogates, tasks, hs, scratch,
+            order, null, failed };
+        inform_run_tasks(significance_task, &job, tasks);
+        bool ok = true;
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            ok &= !failed[i];
+        }
+        if (ok)
+        {
+            size_t extreme = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                extreme += (null[i] >= observed);
+            }
+            p = (double) (extreme + 1) / (double) (count + 1);
+        }
+    }
+
+    for (size_t i = 0; i < initialized; ++i)
+    {
+        histograms_free(hs + 2 * i, problem->nhs);
+    }
+    free(failed);
+    free(order);
+    free(scratch);
+    free(hs);
+    if (allocate_null)
+    {
+        free(null);
+    }
+    if (isnan(p))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    if (value != NULL)
+    {
+        *value = observed;
+    }
+    return p;
+}
+
+/**
+ * Test a problem whose fixed events have been counted.
+ */
+static double finish(significance_problem *problem, bool failed,
+    inform_surrogates const *surrogates, double *null, double *value,
+    inform_error *err)
+{
+    double p = NAN;
+    if (failed)
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else
+    {
+        p = significance(problem, surrogates, null, value, err);
+    }
+    problem_free(problem);
+    return p;
+}
+
+double inform_transfer_entropy_significance(int const *src, int const *dst,
+    size_t n, size_t m, int b, size_t k, inform_surrogates const *surrogates,
+    double *null, double *value, inform_error *err)
+{
+    if (src == NULL || dst == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NAN);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, NAN);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NAN);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, NAN);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NAN);
+    }
+    else if (histogram_support(b, k + 2) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+    else if (check_states(src, n * m, b, err) || check_states(dst, n * m, b, err))
+    {
+        return NAN;
+    }
+
+    size_t const N = n * (m - k);
+    if (check_surrogates(surrogates, N, err)) return NAN;
+
+    significance_problem problem;
+    if (problem_alloc(&problem, N, n, 2))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    // the joint states extend the predicates, and the sources the histories,
+    // by the source's symbol
+    uint64_t *predicates = problem.codes[0], *histories = problem.codes[1];
+    uint64_t const q = histogram_support(b, k);
+    size_t t = 0;
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
+    {
+        uint64_t history = 0;
+        for (size_t j = 0; j < k; ++j)
+        {
+            history = history * b + dst[j];
+        }
+        for (size_t j = k; j < m; ++j, ++t)
+        {
+            predicates[t] = history * b + dst[j];
+            histories[t] = history;
+            problem.symbols[t] = src[j - 1];
+            history = predicates[t] - dst[j - k] * q;
+        }
+    }
+
+    double s_predicates = 0.0, s_histories = 0.0;
+    bool const failed = fixed_nlogn(q * b, predicates, N, &s_predicates) ||
+        fixed_nlogn(q, histories, N, &s_histories);
+    for (t = 0; t < N; ++t)
+    {
+        predicates[t] *= b;
+        histories[t] *= b;
+    }
+    problem.sizes[0] = q * b * b;
+    problem.sizes[1] = q * b;
+    problem.offset = 0.0;
+    problem.fixed = s_histories - s_predicates;
+
+    return finish(&problem, failed, surrogates, null, value, err);
+}
+
+double inform_active_info_significance(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_surrogates const *surrogates, double *null,
+    double *value, inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NAN);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, NAN);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NAN);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NAN);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, NAN);
+    }
+    else if (histogram_support(b, k + 1) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+    else if (check_states(series, n * m, b, err))
+    {
+        return NAN;
+    }
+
+    size_t const N = n * (m - k);
+    if (check_surrogates(surrogates, N, err)) return NAN;
+
+    significance_problem problem;
+    if (problem_alloc(&problem, N, n, 1))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    // the futures are resampled against the fixed histories
+    uint64_t *histories = problem.codes[0], *futures = problem.codes[1];
+    uint64_t const q = histogram_support(b, k);
+    size_t t = 0;
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0;
+        for (size_t j = 0; j < k; ++j)
+        {
+            history = history * b + series[j];
+        }
+        for (size_t j = k; j < m; ++j, ++t)
+        {
+            histories[t] = history;
+            futures[t] = series[j];
+            problem.symbols[t] = series[j];
+            history = history * b + series[j] - series[j - k] * q;
+        }
+    }
+
+    double s_histories = 0.0, s_futures = 0.0;
+    bool const failed = fixed_nlogn(q, histories, N, &s_histories) ||
+        fixed_nlogn(b, futures, N, &s_futures);
+    for (t = 0; t < N; ++t)
+    {
+        histories[t] *= b;
+    }
+    problem.sizes[0] = q * b;
+    problem.offset = log2((double) N);
+    problem.fixed = -s_histories - s_futures;
+
+    return finish(&problem, failed, surrogates, null, value, err);
+}
+
+double inform_mutual_info_significance(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_surrogates const *surrogates, double *null,
+    double *value, inform_error *err)
+{
+    if (xs == NULL || ys == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NAN);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NAN);
+    }
+    else if (bx < 2 || by < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
+    }
+    else if (check_states(xs, n, bx, err) || check_states(ys, n, by, err))
+    {
+        return NAN;
+    }
+    else if (check_surrogates(surrogates, n, err))
+    {
+        return NAN;
+    }
+
+    significance_problem problem;
+    if (problem_alloc(&problem, n, 1, 1))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    // the second series is resampled against the first
+    uint64_t *x = problem.codes[0], *y = problem.codes[1];
+    for (size_t t = 0; t < n; ++t)
+    {
+        x[t] = xs[t];
+        y[t] = ys[t];
+        problem.symbols[t] = ys[t];
+    }
+
+    double s_x = 0.0, s_y = 0.0;
+    bool const failed = fixed_nlogn(bx, x, n, &s_x) ||
+        fixed_nlogn(by, y, n, &s_y);
+    for (size_t t = 0; t < n; ++t)
+    {
+        x[t] *= by;
+    }
+    problem.sizes[0] = (uint64_t) bx * by;
+    problem.offset = log2((double) n);
+    problem.fixed = -s_x - s_y;
+
+    return finish(&problem, failed, surrogates, null, value, err);
+}
@@ -0,0 +1,506 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "simd.h"
+#include <math.h>
+
+#if !defined(INFORM_DISABLE_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define INFORM_SIMD_X86
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#elif !defined(INFORM_DISABLE_SIMD) && defined(__aarch64__)
+#define INFORM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(INFORM_SIMD_X86) || defined(INFORM_SIMD_NEON)
+/// the coefficients of the series
+/// @f \log_2 m = \frac{2}{\ln 2} \sum_k \frac{f^{2k+1}}{2k+1} @f
+/// where @f f = (m - 1)/(m + 1) @f; eleven terms suffice for double precision
+/// when @f |f| \leq 0.2 @f
+#define TWO_LOG2E 2.8853900817779268147198493620037843
+static double const coefficients[11] = {
+    TWO_LOG2E,        TWO_LOG2E / 3.0,  TWO_LOG2E / 5.0,  TWO_LOG2E / 7.0,
+    TWO_LOG2E / 9.0,  TWO_LOG2E / 11.0, TWO_LOG2E / 13.0, TWO_LOG2E / 15.0,
+    TWO_LOG2E / 17.0, TWO_LOG2E / 19.0, TWO_LOG2E / 21.0,
+};
+#define NUM_COEFFICIENTS (sizeof(coefficients) / sizeof(double))
+#endif
+
+static double weighted_log2_scalar(uint32_t const *w, uint32_t const *x,
+    size_t n)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (w[i] != 0)
+        {
+            if (x[i] == 0)
+            {
+                return -INFINITY;
+            }
+            sum += w[i] * log2((double) x[i]);
+        }
+    }
+    return sum;
+}
+
+static size_t valid_prefix_scalar(int const *events, size_t n, uint32_t bound)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if ((uint32_t) events[i] >= bound)
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * Determine whether @f y_i \leq x_i @f, or @f y_i \leq \lnot x_i @f when adding,
+ * for every i; the latter is exactly the condition that @f x_i + y_i @f does
+ * not overflow.
+ */
+static bool counts_fit_scalar(uint32_t const *x, uint32_t const *y, size_t n,
+    bool add)
+{
+    uint32_t const flip = add ? UINT32_MAX : 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (y[i] > (x[i] ^ flip))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void combine_counts_scalar(uint32_t *x, uint32_t const *y, size_t n,
+    bool add)
+{
+    if (add)
+    {
+        for (size_t i = 0; i < n; ++i) x[i] += y[i];
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i) x[i] -= y[i];
+    }
+}
+
+#if defined(INFORM_SIMD_X86)
+
+TARGET_AVX2 static inline __m256d load_avx2(uint32_t const *p)
+{
+    // AVX2 can only convert signed integers, so shift the counts into the
+    // signed range and back again
+    __m128i const v = _mm_xor_si128(_mm_loadu_si128((__m128i const *) p),
+        _mm_set1_epi32(INT32_MIN));
+    return _mm256_add_pd(_mm256_cvtepi32_pd(v), _mm256_set1_pd(2147483648.0));
+}
+
+TARGET_AVX2 static inline __m256d log2_avx2(__m256d x)
+{
+    __m256d const one = _mm256_set1_pd(1.0);
+    __m256i const bits = _mm256_castpd_si256(x);
+
+    // the exponent, converted to a double by way of the 2^52 trick
+    __m256i const biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+        _mm256_set1_epi64x(0x4330000000000000));
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(biased),
+        _mm256_set1_pd(4503599627370496.0 + 1023.0));
+
+    // the mantissa in [1, 2), folded into [sqrt(2)/2, sqrt(2)]
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFF)),
+        _mm256_set1_epi64x(0x3FF0000000000000)));
+    __m256d const big = _mm256_cmp_pd(m, _mm256_set1_pd(1.4142135623730951),
+        _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, one));
+
+    __m256d const f = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    __m256d const s = _mm256_mul_pd(f, f);
+    __m256d p = _mm256_set1_pd(coefficients[NUM_COEFFICIENTS - 1]);
+    for (size_t k = NUM_COEFFICIENTS - 1; k-- > 0;)
+    {
+        p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(coefficients[k]));
+    }
+    return _mm256_fmadd_pd(f, p, e);
+}
+
+TARGET_AVX2 static double weighted_log2_avx2(uint32_t const *w,
+    uint32_t const *x, size_t n)
+{
+    __m256d const zero = _mm256_setzero_pd();
+    __m256d const one = _mm256_set1_pd(1.0);
+    __m256d sum = zero, undefined = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d const wd = load_avx2(w + i);
+        __m256d const weighted = _mm256_cmp_pd(wd, zero, _CMP_GT_OQ);
+        if (_mm256_movemask_pd(weighted) == 0)
+        {
+            continue;
+        }
+        __m256d xd = load_avx2(x + i);
+        __m256d const empty = _mm256_cmp_pd(xd, zero, _CMP_EQ_OQ);
+        undefined = _mm256_or_pd(undefined, _mm256_and_pd(weighted, empty));
+        xd = _mm256_blendv_pd(xd, one, empty);
+        __m256d const terms = _mm256_mul_pd(wd, log2_avx2(xd));
+        sum = _mm256_add_pd(sum, _mm256_and_pd(weighted, terms));
+    }
+    if (_mm256_movemask_pd(undefined) != 0)
+    {
+        return -INFINITY;
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+        weighted_log2_scalar(w + i, x + i, n - i);
+}
+
+TARGET_AVX2 static size_t valid_prefix_avx2(int const *events, size_t n,
+    uint32_t bound)
+{
+    __m256i const limit = _mm256_set1_epi32((int) (bound - 1));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i const *p = (__m256i const *) (events + i);
+        __m256i const hi = _mm256_max_epu32(
+            _mm256_max_epu32(_mm256_loadu_si256(p), _mm256_loadu_si256(p + 1)),
+            _mm256_max_epu32(_mm256_loadu_si256(p + 2), _mm256_loadu_si256(p + 3)));
+        __m256i const within = _mm256_cmpeq_epi32(_mm256_max_epu32(hi, limit), limit);
+        if (_mm256_movemask_epi8(within) != -1)
+        {
+            break;
+        }
+    }
+    return i + valid_prefix_scalar(events + i, n - i, bound);
+}
+
+TARGET_AVX2 static bool counts_fit_avx2(uint32_t const *x, uint32_t const *y,
+    size_t n, bool add)
+{
+    __m256i const flip = _mm256_set1_epi32(add ? -1 : 0);
+    __m256i excess = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i const xs = _mm256_xor_si256(
+            _mm256_loadu_si256((__m256i const *) (x + i)), flip);
+        __m256i const ys = _mm256_loadu_si256((__m256i const *) (y + i));
+        // y <= x exactly when max(x, y) == x
+        excess = _mm256_or_si256(excess,
+            _mm256_xor_si256(_mm256_max_epu32(xs, ys), xs));
+    }
+    return _mm256_testz_si256(excess, excess) &&
+        counts_fit_scalar(x + i, y + i, n - i, add);
+}
+
+TARGET_AVX2 static void combine_counts_avx2(uint32_t *x, uint32_t const *y,
+    size_t n, bool add)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i const xs = _mm256_loadu_si256((__m256i const *) (x + i));
+        __m256i const ys = _mm256_loadu_si256((__m256i const *) (y + i));
+        __m256i const zs = add ? _mm256_add_epi32(xs, ys) : _mm256_sub_epi32(xs, ys);
+        _mm256_storeu_si256((__m256i *) (x + i), zs);
+    }
+    combine_counts_scalar(x + i, y + i, n - i, add);
+}
+
+TARGET_AVX512 static inline __m512d load_avx512(uint32_t const *p)
+{
+    return _mm512_cvtepu32_pd(_mm256_loadu_si256((__m256i const *) p));
+}
+
+TARGET_AVX512 static inline __m512d log2_avx512(__m512d x)
+{
+    __m512d const one = _mm512_set1_pd(1.0);
+
+    // x = m 2^e with m in [3/4, 3/2)
+    __m512d const m = _mm512_getmant_pd(x, _MM_MANT_NORM_p75_1p5,
+        _MM_MANT_SIGN_src);
+    __m512d e = _mm512_getexp_pd(x);
+    __mmask8 const low = _mm512_cmp_pd_mask(m, one, _CMP_LT_OQ);
+    e = _mm512_mask_add_pd(e, low, e, one);
+
+    __m512d const f = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+    __m512d const s = _mm512_mul_pd(f, f);
+    __m512d p = _mm512_set1_pd(coefficients[NUM_COEFFICIENTS - 1]);
+    for (size_t k = NUM_COEFFICIENTS - 1; k-- > 0;)
+    {
+        p = _mm512_fmadd_pd(p, s, _mm512_set1_pd(coefficients[k]));
+    }
+    return _mm512_fmadd_pd(f, p, e);
+}
+
+TARGET_AVX512 static double weighted_log2_avx512(uint32_t const *w,
+    uint32_t const *x, size_t n)
+{
+    __m512d const zero = _mm512_setzero_pd();
+    __m512d const one = _mm512_set1_pd(1.0);
+    __m512d sum = zero;
+    __mmask8 undefined = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d const wd = load_avx512(w + i);
+        __mmask8 const weighted = _mm512_cmp_pd_mask(wd, zero, _CMP_GT_OQ);
+        if (weighted == 0)
+        {
+            continue;
+        }
+        __m512d xd = load_avx512(x + i);
+        __mmask8 const empty = _mm512_cmp_pd_mask(xd, zero, _CMP_EQ_OQ);
+        undefined |= weighted & empty;
+        xd = _mm512_mask_blend_pd(empty, xd, one);
+        __m512d const terms = _mm512_mul_pd(wd, log2_avx512(xd));
+        sum = _mm512_mask_add_pd(sum, weighted, sum, terms);
+    }
+    if (undefined != 0)
+    {
+        return -INFINITY;
+    }
+    return _mm512_reduce_add_pd(sum) + weighted_log2_scalar(w + i, x + i, n - i);
+}
+
+TARGET_AVX512 static size_t valid_prefix_avx512(int const *events, size_t n,
+    uint32_t bound)
+{
+    __m512i const limit = _mm512_set1_epi32((int) (bound - 1));
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        __m512i const *p = (__m512i const *) (events + i);
+        __m512i const hi = _mm512_max_epu32(
+            _mm512_max_epu32(_mm512_loadu_si512(p), _mm512_loadu_si512(p + 1)),
+            _mm512_max_epu32(_mm512_loadu_si512(p + 2), _mm512_loadu_si512(p + 3)));
+        if (_mm512_cmpgt_epu32_mask(hi, limit) != 0)
+        {
+            break;
+        }
+    }
+    return i + valid_prefix_scalar(events + i, n - i, bound);
+}
+
+TARGET_AVX512 static bool counts_fit_avx512(uint32_t const *x,
+    uint32_t const *y, size_t n, bool add)
+{
+    __m512i const flip = _mm512_set1_epi32(add ? -1 : 0);
+    __mmask16 excess = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i const xs = _mm512_xor_si512(_mm512_loadu_si512(x + i), flip);
+        __m512i const ys = _mm512_loadu_si512(y + i);
+        excess |= _mm512_cmpgt_epu32_mask(ys, xs);
+    }
+    return excess == 0 && counts_fit_scalar(x + i, y + i, n - i, add);
+}
+
+TARGET_AVX512 static void combine_counts_avx512(uint32_t *x, uint32_t const *y,
+    size_t n, bool add)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i const xs = _mm512_loadu_si512(x + i);
+        __m512i const ys = _mm512_loadu_si512(y + i);
+        _mm512_storeu_si512(x + i,
+            add ? _mm512_add_epi32(xs, ys) : _mm512_sub_epi32(xs, ys));
+    }
+    combine_counts_scalar(x + i, y + i, n - i, add);
+}
+
+#elif defined(INFORM_SIMD_NEON)
+
+static inline float64x2_t load_neon(uint32_t const *p)
+{
+    return vcvtq_f64_u64(vmovl_u32(vld1_u32(p)));
+}
+
+static inline float64x2_t log2_neon(float64x2_t x)
+{
+    float64x2_t const one = vdupq_n_f64(1.0);
+    uint64x2_t const bits = vreinterpretq_u64_f64(x);
+
+    int64x2_t const biased = vreinterpretq_s64_u64(vshrq_n_u64(bits, 52));
+    float64x2_t e = vcvtq_f64_s64(vsubq_s64(biased, vdupq_n_s64(1023)));
+
+    // the mantissa in [1, 2), folded into [sqrt(2)/2, sqrt(2)]
+    float64x2_t m = vreinterpretq_f64_u64(vorrq_u64(
+        vandq_u64(bits, vdupq_n_u64(0x000FFFFFFFFFFFFF)),
+        vdupq_n_u64(0x3FF0000000000000)));
+    uint64x2_t const big = vcgtq_f64(m, vdupq_n_f64(1.4142135623730951));
+    m = vbslq_f64(big, vmulq_f64(m, vdupq_n_f64(0.5)), m);
+    e = vaddq_f64(e, vreinterpretq_f64_u64(vandq_u64(big,
+        vreinterpretq_u64_f64(one))));
+
+    float64x2_t const f = vdivq_f64(vsubq_f64(m, one), vaddq_f64(m, one));
+    float64x2_t const s = vmulq_f64(f, f);
+    float64x2_t p = vdupq_n_f64(coefficients[NUM_COEFFICIENTS - 1]);
+    for (size_t k = NUM_COEFFICIENTS - 1; k-- > 0;)
+    {
+        p = vfmaq_f64(vdupq_n_f64(coefficients[k]), p, s);
+    }
+    return vfmaq_f64(e, f, p);
+}
+
+static double weighted_log2_neon(uint32_t const *w, uint32_t const *x,
+    size_t n)
+{
+    float64x2_t const zero = vdupq_n_f64(0.0);
+    float64x2_t const one = vdupq_n_f64(1.0);
+    float64x2_t sum = zero;
+    uint64x2_t undefined = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        float64x2_t const wd = load_neon(w + i);
+        float64x2_t xd = load_neon(x + i);
+        uint64x2_t const weighted = vcgtq_f64(wd, zero);
+        uint64x2_t const empty = vceqq_f64(xd, zero);
+        undefined = vorrq_u64(undefined, vandq_u64(weighted, empty));
+        xd = vbslq_f64(empty, one, xd);
+        float64x2_t const terms = vmulq_f64(wd, log2_neon(xd));
+        sum = vaddq_f64(sum, vreinterpretq_f64_u64(vandq_u64(weighted,
+            vreinterpretq_u64_f64(terms))));
+    }
+    if (vmaxvq_u32(vreinterpretq_u32_u64(undefined)) != 0)
+    {
+        return -INFINITY;
+    }
+    return vaddvq_f64(sum) + weighted_log2_scalar(w + i, x + i, n - i);
+}
+
+static size_t valid_prefix_neon(int const *events, size_t n, uint32_t bound)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint32_t const *p = (uint32_t const *) (events + i);
+        uint32x4_t const hi = vmaxq_u32(vmaxq_u32(vld1q_u32(p), vld1q_u32(p + 4)),
+            vmaxq_u32(vld1q_u32(p + 8), vld1q_u32(p + 12)));
+        if (vmaxvq_u32(hi) >= bound)
+        {
+            break;
+        }
+    }
+    return i + valid_prefix_scalar(events + i, n - i, bound);
+}
+
+static bool counts_fit_neon(uint32_t const *x, uint32_t const *y, size_t n,
+    bool add)
+{
+    uint32x4_t const flip = vdupq_n_u32(add ? UINT32_MAX : 0);
+    uint32x4_t excess = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32x4_t const xs = veorq_u32(vld1q_u32(x + i), flip);
+        excess = vorrq_u32(excess, vcgtq_u32(vld1q_u32(y + i), xs));
+    }
+    return vmaxvq_u32(excess) == 0 && counts_fit_scalar(x + i, y + i, n - i, add);
+}
+
+static void combine_counts_neon(uint32_t *x, uint32_t const *y, size_t n,
+    bool add)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32x4_t const xs = vld1q_u32(x + i);
+        uint32x4_t const ys = vld1q_u32(y + i);
+        vst1q_u32(x + i, add ? vaddq_u32(xs, ys) : vsubq_u32(xs, ys));
+    }
+    combine_counts_scalar(x + i, y + i, n - i, add);
+}
+
+#endif
+
+double inform_weighted_log2(uint32_t const *w, uint32_t const *x, size_t n)
+{
+#if defined(INFORM_SIMD_X86)
+    // the features are probed on every call, rather than cached, so that the
+    // dispatch is free of data races; the probe is a couple of loads
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return weighted_log2_avx512(w, x, n);
+    }
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return weighted_log2_avx2(w, x, n);
+    }
+#elif defined(INFORM_SIMD_NEON)
+    return weighted_log2_neon(w, x, n);
+#endif
+    return weighted_log2_scalar(w, x, n);
+}
+
+size_t inform_valid_prefix(int const *events, size_t n, uint32_t bound)
+{
+    if (bound == 0)
+    {
+        return 0;
+    }
+#if defined(INFORM_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return valid_prefix_avx512(events, n, bound);
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        return valid_prefix_avx2(events, n, bound);
+    }
+#elif defined(INFORM_SIMD_NEON)
+    return valid_prefix_neon(events, n, bound);
+#endif
+    return valid_prefix_scalar(events, n, bound);
+}
+
+static bool combine_counts(uint32_t *x, uint32_t const *y, size_t n, bool add)
+{
+#if defined(INFORM_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        if (!counts_fit_avx512(x, y, n, add)) return true;
+        combine_counts_avx512(x, y, n, add);
+        return false;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        if (!counts_fit_avx2(x, y, n, add)) return true;
+        combine_counts_avx2(x, y, n, add);
+        return false;
+    }
+#elif defined(INFORM_SIMD_NEON)
+    if (!counts_fit_neon(x, y, n, add)) return true;
+    combine_counts_neon(x, y, n, add);
+    return false;
+#endif
+    if (!counts_fit_scalar(x, y, n, add)) return true;
+    combine_counts_scalar(x, y, n, add);
+    return false;
+}
+
+bool inform_add_counts(uint32_t *x, uint32_t const *y, size_t n)
+{
+    return combine_counts(x, y, n, true);
+}
+
+bool inform_subtract_counts(uint32_t *x, uint32_t const *y, size_t n)
+{
+    return combine_counts(x, y, n, false);
+}
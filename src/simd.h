@@ -0,0 +1,88 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// histograms with fewer bins than this are reduced by the exact scalar loops
+#define INFORM_SIMD_MIN_SIZE 256
+
+/**
+ * Compute @f \sum_{w_i > 0} w_i \log_2 x_i @f over a pair of histograms.
+ *
+ * This is the core of the entropy, cross entropy and relative entropy
+ * reductions: with `w == x` it computes @f \sum_i c_i \log_2 c_i @f, from
+ * which the entropy follows as @f \log_2 N - S/N @f.
+ *
+ * The reduction is dispatched at runtime to an AVX-512, AVX2 or NEON kernel
+ * when the CPU supports one, and to a scalar loop otherwise. The vector
+ * kernels evaluate the logarithm with a polynomial whose truncation error is
+ * below double-precision rounding, so each term agrees with `log2` to within
+ * a few units in the last place; only the order of summation differs.
+ *
+ * @param[in] w the weights, i.e. the counts of the first histogram
+ * @param[in] x the arguments of the logarithm, i.e. the counts of the second
+ * @param[in] n the number of bins in each histogram
+ * @return the sum, or -INFINITY if @f w_i > 0 @f and @f x_i = 0 @f for some i
+ */
+double inform_weighted_log2(uint32_t const *w, uint32_t const *x, size_t n);
+
+/**
+ * Find the length of the longest prefix of `events` that lies within
+ * @f [0, bound) @f.
+ *
+ * This is the bounds check performed before events are counted, hoisted out
+ * of the counting loop. The events are compared as unsigned integers, so
+ * that a single running maximum catches both negative and oversized events;
+ * the vector kernels scan blocks of events at a time and only fall back to an
+ * element-by-element scan in the block containing the first invalid event.
+ *
+ * @param[in] events the events to check
+ * @param[in] n      the number of events
+ * @param[in] bound  the exclusive upper bound, at most 2^31
+ * @return the index of the first invalid event, or `n` if there is none
+ */
+size_t inform_valid_prefix(int const *events, size_t n, uint32_t bound);
+
+/**
+ * Check whether a single event lies outside of @f [0, bound) @f.
+ *
+ * This is the check of inform_valid_prefix for kernels which validate their
+ * events as they stream through them, rather than in a separate pass.
+ *
+ * @param[in] event the event to check
+ * @param[in] bound the exclusive upper bound
+ * @return true if the event is invalid
+ */
+static inline bool inform_invalid_event(int event, int bound)
+{
+    return (unsigned) event >= (unsigned) bound;
+}
+
+/**
+ * Add one array of counts to another, elementwise, unless a sum would
+ * overflow.
+ *
+ * The arrays are first scanned for a pair whose sum exceeds `UINT32_MAX`,
+ * and only summed if there is none, so that `x` is never left half-updated.
+ *
+ * @param[in,out] x the counts to add to
+ * @param[in] y     the counts to add
+ * @param[in] n     the length of the arrays
+ * @return true if a sum would overflow, in which case `x` is unchanged
+ */
+bool inform_add_counts(uint32_t *x, uint32_t const *y, size_t n);
+
+/**
+ * Subtract one array of counts from another, elementwise, unless a
+ * difference would be negative.
+ *
+ * @param[in,out] x the counts to subtract from
+ * @param[in] y     the counts to subtract
+ * @param[in] n     the length of the arrays
+ * @return true if @f y_i > x_i @f for some i, in which case `x` is unchanged
+ */
+bool inform_subtract_counts(uint32_t *x, uint32_t const *y, size_t n);
@@ -0,0 +1,343 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/sparse_dist.h>
+#include <string.h>
+
+#define SPARSE_MIN_CAPACITY 16
+
+static inline size_t hash(uint64_t x)
+{
+    // the 64-bit finalizer from MurmurHash3
+    x ^= x >> 33;
+    x *= UINT64_C(0xff51afd7ed558ccd);
+    x ^= x >> 33;
+    x *= UINT64_C(0xc4ceb9fe1a85ec53);
+    x ^= x >> 33;
+    return (size_t) x;
+}
+
+static size_t capacity_for(size_t n)
+{
+    // keep the load factor at or below one half
+    size_t capacity = SPARSE_MIN_CAPACITY;
+    while (capacity / 2 < n && capacity < SIZE_MAX / 2)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static bool allocate_table(inform_sparse_dist *dist, size_t capacity)
+{
+    dist->events = malloc(capacity * sizeof(uint64_t));
+    dist->histogram = calloc(capacity, sizeof(uint32_t));
+    if (dist->events == NULL || dist->histogram == NULL)
+    {
+        free(dist->events);
+        free(dist->histogram);
+        return true;
+    }
+    dist->capacity = capacity;
+    return false;
+}
+
+static inline size_t find_slot(inform_sparse_dist const *dist, uint64_t event)
+{
+    // linear probing: stop at the event or at the first empty slot
+    size_t const mask = dist->capacity - 1;
+    size_t i = hash(event) & mask;
+    while (dist->histogram[i] != 0 && dist->events[i] != event)
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static bool rehash(inform_sparse_dist *dist, size_t capacity)
+{
+    inform_sparse_dist grown = { NULL, NULL, 0, dist->size, dist->counts };
+    if (allocate_table(&grown, capacity))
+    {
+        return true;
+    }
+    for (size_t i = 0; i < dist->capacity; ++i)
+    {
+        if (dist->histogram[i] != 0)
+        {
+            size_t const j = find_slot(&grown, dist->events[i]);
+            grown.events[j] = dist->events[i];
+            grown.histogram[j] = dist->histogram[i];
+        }
+    }
+    free(dist->events);
+    free(dist->histogram);
+    *dist = grown;
+    return false;
+}
+
+static void remove_slot(inform_sparse_dist *dist, size_t i)
+{
+    // backward-shift deletion keeps every probe sequence unbroken without
+    // resorting to tombstones
+    size_t const mask = dist->capacity - 1;
+    size_t j = i;
+    while (true)
+    {
+        j = (j + 1) & mask;
+        if (dist->histogram[j] == 0)
+        {
+            break;
+        }
+        size_t const home = hash(dist->events[j]) & mask;
+        bool const stays = (i <= j) ? (i < home && home <= j)
+                                    : (i < home || home <= j);
+        if (!stays)
+        {
+            dist->events[i] = dist->events[j];
+            dist->histogram[i] = dist->histogram[j];
+            i = j;
+        }
+    }
+    dist->histogram[i] = 0;
+}
+
+static inline size_t insert_slot(inform_sparse_dist *dist, uint64_t event)
+{
+    // find the slot for the event, growing the table if a new slot is needed;
+    // returns the capacity if the table could not grow
+    size_t i = find_slot(dist, event);
+    if (dist->histogram[i] == 0 && (dist->size + 1) * 2 > dist->capacity)
+    {
+        if (rehash(dist, 2 * dist->capacity))
+        {
+            return dist->capacity;
+        }
+        i = find_slot(dist, event);
+    }
+    return i;
+}
+
+inform_sparse_dist *inform_sparse_dist_alloc(size_t n)
+{
+    inform_sparse_dist *dist = malloc(sizeof(inform_sparse_dist));
+    if (dist != NULL)
+    {
+        if (allocate_table(dist, capacity_for(n)))
+        {
+            free(dist);
+            return NULL;
+        }
+        dist->size = 0;
+        dist->counts = 0;
+    }
+    return dist;
+}
+
+inform_sparse_dist *inform_sparse_dist_dup(inform_sparse_dist const *dist)
+{
+    if (dist == NULL)
+    {
+        return NULL;
+    }
+    inform_sparse_dist *dup = malloc(sizeof(inform_sparse_dist));
+    if (dup != NULL)
+    {
+        if (allocate_table(dup, dist->capacity))
+        {
+            free(dup);
+            return NULL;
+        }
+        memcpy(dup->events, dist->events, dist->capacity * sizeof(uint64_t));
+        memcpy(dup->histogram, dist->histogram, dist->capacity * sizeof(uint32_t));
+        dup->size = dist->size;
+        dup->counts = dist->counts;
+    }
+    return dup;
+}
+
+inform_sparse_dist *inform_sparse_dist_from_dist(inform_dist const *dist)
+{
+    if (dist == NULL)
+    {
+        return NULL;
+    }
+    size_t observed = 0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        observed += (dist->histogram[i] != 0);
+    }
+    inform_sparse_dist *sparse = inform_sparse_dist_alloc(observed);
+    if (sparse != NULL)
+    {
+        for (size_t i = 0; i < dist->size; ++i)
+        {
+            if (dist->histogram[i] != 0)
+            {
+                size_t const j = find_slot(sparse, i);
+                sparse->events[j] = i;
+                sparse->histogram[j] = dist->histogram[i];
+            }
+        }
+        sparse->size = observed;
+        sparse->counts = dist->counts;
+    }
+    return sparse;
+}
+
+inform_dist *inform_sparse_dist_to_dist(inform_sparse_dist const *dist, size_t n)
+{
+    if (dist == NULL)
+    {
+        return NULL;
+    }
+    inform_dist *dense = inform_dist_alloc(n);
+    if (dense != NULL)
+    {
+        for (size_t i = 0; i < dist->capacity; ++i)
+        {
+            if (dist->histogram[i] != 0)
+            {
+                if (dist->events[i] >= n)
+                {
+                    inform_dist_free(dense);
+                    return NULL;
+                }
+                dense->histogram[dist->events[i]] = dist->histogram[i];
+            }
+        }
+        dense->counts = dist->counts;
+    }
+    return dense;
+}
+
+void inform_sparse_dist_clear(inform_sparse_dist *dist)
+{
+    if (dist != NULL)
+    {
+        memset(dist->histogram, 0, dist->capacity * sizeof(uint32_t));
+        dist->size = 0;
+        dist->counts = 0;
+    }
+}
+
+void inform_sparse_dist_free(inform_sparse_dist *dist)
+{
+    if (dist != NULL)
+    {
+        free(dist->events);
+        free(dist->histogram);
+        free(dist);
+    }
+}
+
+size_t inform_sparse_dist_size(inform_sparse_dist const *dist)
+{
+    return (dist == NULL) ? 0 : dist->size;
+}
+
+uint64_t inform_sparse_dist_counts(inform_sparse_dist const *dist)
+{
+    return (dist == NULL) ? 0 : dist->counts;
+}
+
+bool inform_sparse_dist_is_valid(inform_sparse_dist const *dist)
+{
+    return dist != NULL && dist->counts != 0;
+}
+
+uint32_t inform_sparse_dist_get(inform_sparse_dist const *dist, uint64_t event)
+{
+    if (dist == NULL)
+    {
+        return 0;
+    }
+    return dist->histogram[find_slot(dist, event)];
+}
+
+uint32_t inform_sparse_dist_set(inform_sparse_dist *dist, uint64_t event,
+    uint32_t x)
+{
+    if (dist == NULL)
+    {
+        return 0;
+    }
+    if (x == 0)
+    {
+        // setting an event's frequency to zero removes it from the table
+        size_t const i = find_slot(dist, event);
+        if (dist->histogram[i] != 0)
+        {
+            dist->counts -= dist->histogram[i];
+            dist->size -= 1;
+            remove_slot(dist, i);
+        }
+        return 0;
+    }
+    size_t const i = insert_slot(dist, event);
+    if (i == dist->capacity)
+    {
+        return 0;
+    }
+    if (dist->histogram[i] == 0)
+    {
+        dist->events[i] = event;
+        dist->size += 1;
+    }
+    dist->counts -= dist->histogram[i];
+    dist->counts += x;
+    return (dist->histogram[i] = x);
+}
+
+uint32_t inform_sparse_dist_tick(inform_sparse_dist *dist, uint64_t event)
+{
+    if (dist == NULL)
+    {
+        return 0;
+    }
+    // a saturated count is refused before the table is touched
+    if (dist->histogram[find_slot(dist, event)] == UINT32_MAX)
+    {
+        return 0;
+    }
+    size_t const i = insert_slot(dist, event);
+    if (i == dist->capacity)
+    {
+        return 0;
+    }
+    if (dist->histogram[i] == 0)
+    {
+        dist->events[i] = event;
+        dist->size += 1;
+    }
+    dist->counts += 1;
+    return (dist->histogram[i] += 1);
+}
+
+double inform_sparse_dist_prob(inform_sparse_dist const *dist, uint64_t event)
+{
+    if (dist == NULL || dist->counts == 0)
+    {
+        return 0;
+    }
+    return (double) inform_sparse_dist_get(dist, event) / dist->counts;
+}
+
+size_t inform_sparse_dist_accumulate(inform_sparse_dist *dist,
+    int const *events, size_t n)
+{
+    if (dist == NULL || events == NULL)
+    {
+        return 0;
+    }
+    size_t i = 0;
+    while (i < n)
+    {
+        if (events[i] < 0 || inform_sparse_dist_tick(dist, events[i]) == 0)
+        {
+            break;
+        }
+        ++i;
+    }
+    return i;
+}
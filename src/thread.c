@@ -0,0 +1,100 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "thread.h"
+#include <stdbool.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef HANDLE thread_handle;
+#else
+#include <pthread.h>
+typedef pthread_t thread_handle;
+#endif
+
+typedef struct task_context
+{
+    inform_task task;
+    void *arg;
+    size_t index;
+    thread_handle handle;
+    bool started;
+} task_context;
+
+#if defined(_WIN32)
+static DWORD WINAPI run_task(LPVOID arg)
+{
+    task_context *context = arg;
+    context->task(context->arg, context->index);
+    return 0;
+}
+
+static bool start_thread(task_context *context)
+{
+    context->handle = CreateThread(NULL, 0, run_task, context, 0, NULL);
+    return context->handle != NULL;
+}
+
+static void join_thread(task_context *context)
+{
+    WaitForSingleObject(context->handle, INFINITE);
+    CloseHandle(context->handle);
+}
+#else
+static void *run_task(void *arg)
+{
+    task_context *context = arg;
+    context->task(context->arg, context->index);
+    return NULL;
+}
+
+static bool start_thread(task_context *context)
+{
+    return pthread_create(&context->handle, NULL, run_task, context) == 0;
+}
+
+static void join_thread(task_context *context)
+{
+    pthread_join(context->handle, NULL);
+}
+#endif
+
+void inform_run_tasks(inform_task task, void *arg, size_t count)
+{
+    task_context *contexts = NULL;
+    if (count > 1)
+    {
+        contexts = malloc((count - 1) * sizeof(task_context));
+    }
+    if (contexts == NULL)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            task(arg, i);
+        }
+        return;
+    }
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        task_context *context = contexts + (i - 1);
+        *context = (task_context){ task, arg, i, 0, false };
+        context->started = start_thread(context);
+    }
+
+    task(arg, 0);
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        task_context *context = contexts + (i - 1);
+        if (context->started)
+        {
+            join_thread(context);
+        }
+        else
+        {
+            task(arg, i);
+        }
+    }
+    free(contexts);
+}
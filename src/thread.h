@@ -0,0 +1,25 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdlib.h>
+
+/**
+ * A unit of work run by inform_run_tasks, identified by its index.
+ */
+typedef void (*inform_task)(void *arg, size_t index);
+
+/**
+ * Run `count` tasks concurrently, each on its own thread, and wait for all of
+ * them to finish.
+ *
+ * The first task runs on the calling thread. If a thread cannot be started,
+ * its task is run on the calling thread instead, so every task is run
+ * exactly once regardless.
+ *
+ * @param[in] task  the work to run
+ * @param[in] arg   the argument shared by every task
+ * @param[in] count the number of tasks
+ */
+void inform_run_tasks(inform_task task, void *arg, size_t count);
@@ -4,30 +4,57 @@
 #include <inform/shannon.h>
 #include <inform/transfer_entropy.h>
 #include <string.h>
+#include "accumulator.h"
+#include "failure.h"
+#include "histogram.h"
+#include "local.h"
+#include "partition.h"
+#include "radix_sort.h"
+#include "series.h"
+#include "thread.h"
+#include "windowed.h"
 
-static void accumulate_observations(int const *src, int const *dst,
+/**
+ * Accumulate a block of the observations of a destination, validating each
+ * state as it is read; see check_unread_states for those which are not.
+ *
+ * @return true if a state is invalid, in which case the accumulation stops,
+ *         or if out of memory
+ */
+static bool accumulate_observations(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates)
+    observation_block block, histogram *states, histogram *histories,
+    histogram *sources, histogram *predicates)
 {
-    for (size_t i = 0; i < n; ++i, src += m, dst += m)
+    bool ok = true;
+    src += block.begin * m;
+    dst += block.begin * m;
+    for (size_t i = block.begin; i < block.end; ++i, src += m, dst += m)
     {
-        int src_state, future, state, source, predicate, back_state;
-        int history = 0, q = 1;
-        for (size_t j = 0; j < k; ++j)
+        uint64_t src_state, future, state, source, predicate, back_state;
+        uint64_t history = 0, q = 1;
+        for (size_t j = block.first - k; j < block.first; ++j)
         {
+            if (inform_invalid_event(dst[j], b)) return true;
             q *= b;
             history *= b;
             history += dst[j];
         }
-        for (size_t j = k; j < m; ++j)
+        for (size_t j = block.first; j < block.last; ++j)
         {
             back_state = 0;
             for (size_t u = 0; u < l; ++u)
             {
-                back_state = b * back_state + back[j+m*(i+n*u)-1];
+                int const x = back[j+m*(i+n*u)-1];
+                if (inform_invalid_event(x, b)) return true;
+                back_state = b * back_state + x;
             }
             history += back_state * q;
+            if (inform_invalid_event(src[j-1], b) ||
+                inform_invalid_event(dst[j], b))
+            {
+                return true;
+            }
 
             src_state = src[j-1];
             future    = dst[j];
@@ -35,67 +62,162 @@ static void accumulate_observations(int const *src, int const *dst,
             predicate = history * b + future;
             state     = predicate * b + src_state;
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            sources->histogram[source]++;
-            predicates->histogram[predicate]++;
+            ok &= histogram_tick(states, state);
+            ok &= histogram_tick(histories, history);
+            ok &= histogram_tick(sources, source);
+            ok &= histogram_tick(predicates, predicate);
 
             history = predicate - (dst[j - k] + back_state * b) * q;
         }
     }
+    return !ok;
+}
+
+/// the arguments shared by every block of a destination's observations
+typedef struct observations
+{
+    int const *src, *dst, *back;
+    size_t l, n, m;
+    int b;
+    size_t k;
+} observations;
+
+static bool accumulate_block(void const *arg, observation_block block,
+    histogram *hs)
+{
+    observations const *obs = arg;
+    return accumulate_observations(obs->src, obs->dst, obs->back, obs->l,
+        obs->n, obs->m, obs->b, obs->k, block, hs, hs + 1, hs + 2, hs + 3);
+}
+
+/**
+ * Accumulate the observations of a destination, without background, whose
+ * histories have already been encoded, e.g. by inform_series_encode.
+ */
+static bool accumulate_encoded_observations(int const *src, int const *dst,
+    uint64_t const *encoded, size_t n, size_t m, int b, size_t k,
+    histogram *states, histogram *histories, histogram *sources,
+    histogram *predicates)
+{
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
+    {
+        for (size_t j = k; j < m; ++j)
+        {
+            uint64_t const history   = *encoded++;
+            uint64_t const predicate = history * b + dst[j];
+
+            ok &= histogram_tick(states, predicate * b + src[j-1]);
+            ok &= histogram_tick(histories, history);
+            ok &= histogram_tick(sources, history * b + src[j-1]);
+            ok &= histogram_tick(predicates, predicate);
+        }
+    }
+    return !ok;
 }
 
-static void accumulate_local_observations(int const *src, int const *dst,
+/**
+ * Compute the local transfer entropy of each observation of a destination,
+ * re-encoding the observations rather than storing them as they were
+ * accumulated.
+ */
+static void local_observations(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates, int *state, int *history, int *source,
-    int *predicate)
+    histogram const *states, histogram const *histories,
+    histogram const *sources, histogram const *predicates, local_sink *sink)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t source, predicate, state, back_state;
+        uint64_t history = 0, q = 1;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += dst[j];
+            history *= b;
+            history += dst[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t z = j - k;
-            int back_state = 0;
+            back_state = 0;
             for (size_t u = 0; u < l; ++u)
             {
-                back_state = b * back_state + back[j+n*(i+m*u)-1];
+                back_state = b * back_state + back[j+m*(i+n*u)-1];
             }
-            history[z] += back_state * q;
-            int src_state = src[j-1];
-            int future    = dst[j];
-            predicate[z]  = history[z] * b + future;
-            state[z]      = predicate[z] * b + src_state;
-            source[z]     = history[z] * b + src_state;
-
-            states->histogram[state[z]]++;
-            histories->histogram[history[z]]++;
-            sources->histogram[source[z]]++;
-            predicates->histogram[predicate[z]]++;
-
-            if (j + 1 != m)
+            history += back_state * q;
+
+            source    = history * b + src[j-1];
+            predicate = history * b + dst[j];
+            state     = predicate * b + src[j-1];
+
+            local_emit(sink,
+                inform_log2_count(histogram_get(states, state)) +
+                inform_log2_count(histogram_get(histories, history)) -
+                inform_log2_count(histogram_get(sources, source)) -
+                inform_log2_count(histogram_get(predicates, predicate)));
+
+            history = predicate - (dst[j - k] + back_state * b) * q;
+        }
+    }
+}
+
+/**
+ * Encode the observations of a destination, validating each state as it is
+ * read unless the histories have already been encoded.
+ *
+ * @return true if a state is invalid
+ */
+static bool encode_observations(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, uint64_t *states)
+{
+    if (encoded != NULL)
+    {
+        for (size_t i = 0; i < n; ++i, src += m, dst += m)
+        {
+            for (size_t j = k; j < m; ++j)
             {
-                history[z + 1] = predicate[z] - (dst[z] + back_state * b) * q;
+                *states++ = (*encoded++ * b + dst[j]) * b + src[j-1];
             }
         }
-        src += m;
-        dst += m;
-        state += (m - k);
-        history += (m - k);
-        source += (m - k);
-        predicate += (m - k);
+        return false;
     }
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
+    {
+        uint64_t predicate, back_state;
+        uint64_t history = 0, q = 1;
+        for (size_t j = 0; j < k; ++j)
+        {
+            if (inform_invalid_event(dst[j], b)) return true;
+            q *= b;
+            history *= b;
+            history += dst[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            back_state = 0;
+            for (size_t u = 0; u < l; ++u)
+            {
+                int const x = back[j+m*(i+n*u)-1];
+                if (inform_invalid_event(x, b)) return true;
+                back_state = b * back_state + x;
+            }
+            history += back_state * q;
+            if (inform_invalid_event(src[j-1], b) ||
+                inform_invalid_event(dst[j], b))
+            {
+                return true;
+            }
+
+            predicate = history * b + dst[j];
+            *states++ = predicate * b + src[j-1];
+
+            history = predicate - (dst[j - k] + back_state * b) * q;
+        }
+    }
+    return false;
 }
 
-static bool check_arguments(int const *src, int const *dst, int const *back,
+static bool check_shape(int const *src, int const *dst, int const *back,
     size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
 {
     if (src == NULL)
@@ -130,6 +252,16 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     {
         INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
     }
+    else if (histogram_support(b, k + l + 2) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    return false;
+}
+
+static bool check_states(int const *src, int const *dst, int const *back,
+    size_t l, size_t n, size_t m, int b, inform_error *err)
+{
     for (size_t i = 0; i < n * m; ++i)
     {
         if (b <= src[i] || b <= dst[i])
@@ -161,142 +293,1156 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     return false;
 }
 
+/**
+ * Check the states which accumulate_observations does not read: it reads
+ * the source and background nodes only at time steps `k - 1` through
+ * `m - 2`.
+ *
+ * @return true if any of them is invalid
+ */
+static bool check_unread_states(int const *src, int const *back, size_t l,
+    size_t n, size_t m, int b, size_t k)
+{
+    bool invalid = false;
+    for (size_t i = 0; i < l + 1; ++i)
+    {
+        int const *series = (i == 0) ? src : back + (i - 1) * n * m;
+        for (size_t j = 0; j < n; ++j, series += m)
+        {
+            for (size_t t = 0; t + 1 < k; ++t)
+            {
+                invalid |= inform_invalid_event(series[t], b);
+            }
+            invalid |= inform_invalid_event(series[m - 1], b);
+        }
+    }
+    return invalid;
+}
+
+/**
+ * Report why the observations of a destination could not be accumulated,
+ * as report_failure does, but rescanning the sources and background along
+ * with the destination.
+ */
+static void report_states_failure(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, bool overflow,
+    inform_error *err)
+{
+    if (overflow || !check_states(src, dst, back, l, n, m, b, err))
+    {
+        // with nothing left to scan, only the overflow or ENOMEM is reported
+        report_failure(dst, 0, m, b, overflow, err);
+    }
+}
+
+/**
+ * Check the shape of the arguments and those states which the accumulation
+ * does not read; it validates the rest as it reads them.
+ */
+static bool check_arguments(int const *src, int const *dst, int const *back,
+    size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
+{
+    return check_shape(src, dst, back, l, n, m, b, k, err) ||
+        (check_unread_states(src, back, l, n, m, b, k) &&
+        check_states(src, dst, back, l, n, m, b, err));
+}
+
+static double sorted_sources_nlogn(uint64_t const *states, size_t N, int b,
+    uint64_t *counts)
+{
+    uint64_t const bb = (uint64_t) b * b;
+    double s = 0.0;
+    size_t i = 0;
+    while (i < N)
+    {
+        // the sources sharing a history are contiguous, but their source
+        // states are interleaved with the futures
+        uint64_t const history = states[i] / bb;
+        size_t j = i;
+        for (; j < N && states[j] / bb == history; ++j)
+        {
+            counts[states[j] % b]++;
+        }
+        for (; i < j; ++i)
+        {
+            uint64_t const src_state = states[i] % b;
+            s += inform_nlog2n_count(counts[src_state]);
+            counts[src_state] = 0;
+        }
+    }
+    return s;
+}
+
+static double sorted_transfer_entropy(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, uint64_t states_size, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t *keys = malloc(2 * N * sizeof(uint64_t));
+    uint64_t *counts = calloc(b, sizeof(uint64_t));
+    if (keys == NULL || counts == NULL)
+    {
+        free(keys);
+        free(counts);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    if (encode_observations(src, dst, back, encoded, l, n, m, b, k, keys))
+    {
+        free(keys);
+        free(counts);
+        report_states_failure(src, dst, back, l, n, m, b, false, err);
+        return NAN;
+    }
+    uint64_t const *states = inform_radix_sort(keys, keys + N, N, states_size - 1);
+
+    double te = inform_sorted_nlogn(states, N, 1) +
+        inform_sorted_nlogn(states, N, (uint64_t) b * b) -
+        inform_sorted_nlogn(states, N, b) -
+        sorted_sources_nlogn(states, N, b, counts);
+
+    free(counts);
+    free(keys);
+
+    return te / N;
+}
+
+static double transfer_entropy(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t const histories_size  = histogram_support(b, k + l);
+    uint64_t const states_size     = histories_size*b*b;
+    uint64_t const sources_size    = histories_size*b;
+    uint64_t const predicates_size = histories_size*b;
+
+    if (histogram_prefers_sort(states_size, N))
+    {
+        return sorted_transfer_entropy(src, dst, back, encoded, l, n, m, b, k,
+            states_size, err);
+    }
+
+    uint64_t const sizes[4] = {states_size, histories_size, sources_size,
+        predicates_size};
+    histogram hs[4];
+    if (histograms_init(hs, sizes, 4, N))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+    histogram *states = hs, *histories = hs + 1, *sources = hs + 2,
+        *predicates = hs + 3;
+
+    observations const obs = { src, dst, back, l, n, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            4, &overflow) :
+        accumulate_encoded_observations(src, dst, encoded, n, m, b, k, states,
+            histories, sources, predicates);
+    if (failed)
+    {
+        histograms_free(hs, 4);
+        report_states_failure(src, dst, back, l, n, m, b, overflow, err);
+        return NAN;
+    }
+
+    double te = (histogram_nlogn(states) + histogram_nlogn(histories) -
+        histogram_nlogn(sources) - histogram_nlogn(predicates)) / N;
+
+    histograms_free(hs, 4);
+
+    return te;
+}
+
 double inform_transfer_entropy(int const *src, int const *dst, int const *back,
     size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
 {
     if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NAN;
+    return transfer_entropy(src, dst, back, NULL, l, n, m, b, k, err);
+}
+
+/// the arguments of a transfer entropy taken from handles
+typedef struct series_arguments
+{
+    int const *back;
+    size_t l;
+    int b;
+    uint64_t const *encoded;
+} series_arguments;
+
+/**
+ * Check the shapes of the handles of a transfer entropy, whose states were
+ * validated when the handles were allocated, and resolve its arguments.
+ *
+ * @return true if the handles are invalid
+ */
+static bool check_series(inform_series const *src, inform_series const *dst,
+    inform_series const *back, size_t k, series_arguments *args,
+    inform_error *err)
+{
+    if (src == NULL || dst == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (src->n != dst->n || src->m != dst->m)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (back != NULL && (back->m != src->m || back->n == 0 ||
+        back->n % src->n != 0))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    // the background nodes are stacked as the initial conditions of a
+    // single handle, and every series is valid in the largest of the bases
+    args->back = (back == NULL) ? NULL : back->data;
+    args->l = (back == NULL) ? 0 : back->n / src->n;
+    args->b = (src->b > dst->b) ? src->b : dst->b;
+    if (back != NULL && back->b > args->b)
+    {
+        args->b = back->b;
+    }
+    // the destination's histories omit the background, so they are only of
+    // use without one
+    args->encoded = (args->l == 0 && dst->b == args->b) ?
+        inform_series_histories(dst, k) : NULL;
+    return check_shape(src->data, dst->data, args->back, args->l, src->n,
+        src->m, args->b, k, err);
+}
+
+double inform_transfer_entropy_series(inform_series const *src,
+    inform_series const *dst, inform_series const *back, size_t k,
+    inform_error *err)
+{
+    series_arguments args;
+    if (check_series(src, dst, back, k, &args, err)) return NAN;
+    return transfer_entropy(src->data, dst->data, args.back, args.encoded,
+        args.l, src->n, src->m, args.b, k, err);
+}
 
+/**
+ * Compute the local transfer entropy of a destination whose arguments have
+ * been checked, writing it to a sink. The destination's histories are
+ * encoded as they are accumulated unless `encoded` holds them already.
+ *
+ * @return true on error
+ */
+static bool local_transfer_entropy(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, local_sink sink, inform_error *err)
+{
     size_t const N = n * (m - k);
 
-    size_t const q = (size_t) pow((double) b, (double) k);
-    size_t const r = (size_t) pow((double) b, (double) l);
-    size_t const states_size     = b*b*q*r;
-    size_t const histories_size  = q*r;
-    size_t const sources_size    = b*q*r;
-    size_t const predicates_size = b*q*r;
-    size_t const total_size = states_size + histories_size + sources_size + predicates_size;
+    uint64_t const histories_size  = histogram_support(b, k + l);
+    uint64_t const states_size     = histories_size*b*b;
+    uint64_t const sources_size    = histories_size*b;
+    uint64_t const predicates_size = histories_size*b;
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
-    if (data == NULL)
+    uint64_t const sizes[4] = {states_size, histories_size, sources_size,
+        predicates_size};
+    histogram hs[4];
+    if (histograms_init(hs, sizes, 4, N))
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    histogram *states = hs, *histories = hs + 1, *sources = hs + 2,
+        *predicates = hs + 3;
+
+    observations const obs = { src, dst, back, l, n, m, b, k };
+    bool overflow = false;
+    bool const failed = (encoded == NULL) ?
+        inform_accumulate_blocks(accumulate_block, &obs, n, k, m, hs, sizes,
+            4, &overflow) :
+        accumulate_encoded_observations(src, dst, encoded, n, m, b, k, states,
+            histories, sources, predicates);
+    if (failed)
+    {
+        histograms_free(hs, 4);
+        report_states_failure(src, dst, back, l, n, m, b, overflow, err);
+        return true;
     }
 
-    inform_dist states     = { data, states_size, N };
-    inform_dist histories  = { data + states_size, histories_size, N };
-    inform_dist sources    = { data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { data + states_size + histories_size + sources_size, predicates_size, N };
+    local_observations(src, dst, back, l, n, m, b, k, states, histories,
+        sources, predicates, &sink);
 
-    accumulate_observations(src, dst, back, l, n, m, b, k, &states, &histories,
-        &sources, &predicates);
+    histograms_free(hs, 4);
 
+    return false;
+}
 
-    double te = 0.0;
-    int predicate, source, state;
-    double n_state, n_source, n_predicate, n_history;
-    for (int history = 0; history < (int) histories_size; ++history)
+static double *local_transfer_entropy_doubles(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, double *te, inform_error *err)
+{
+    bool allocate = (te == NULL);
+    if (allocate)
     {
-        n_history = histories.histogram[history];
-        if (n_history == 0)
+        te = malloc(n * (m - k) * sizeof(double));
+        if (te == NULL)
         {
-            continue;
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
-        for (int future = 0; future < b; ++future)
+    }
+
+    if (local_transfer_entropy(src, dst, back, encoded, l, n, m, b, k,
+        local_doubles(te), err))
+    {
+        if (allocate) free(te);
+        return NULL;
+    }
+    return te;
+}
+
+static float *local_transfer_entropy_floats(int const *src, int const *dst,
+    int const *back, uint64_t const *encoded, size_t l, size_t n, size_t m,
+    int b, size_t k, float *te, inform_error *err)
+{
+    bool allocate = (te == NULL);
+    if (allocate)
+    {
+        te = malloc(n * (m - k) * sizeof(float));
+        if (te == NULL)
         {
-            predicate = history * b + future;
-            n_predicate = predicates.histogram[predicate];
-            if (n_predicate == 0)
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    if (local_transfer_entropy(src, dst, back, encoded, l, n, m, b, k,
+        local_floats(te), err))
+    {
+        if (allocate) free(te);
+        return NULL;
+    }
+    return te;
+}
+
+static inform_local_summary *local_transfer_entropy_summary(int const *src,
+    int const *dst, int const *back, uint64_t const *encoded, size_t l,
+    size_t n, size_t m, int b, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    if (summary == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    if (local_transfer_entropy(src, dst, back, encoded, l, n, m, b, k,
+        local_summary(summary), err))
+    {
+        return NULL;
+    }
+    return summary;
+}
+
+double *inform_local_transfer_entropy(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
+    inform_error *err)
+{
+    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NULL;
+    return local_transfer_entropy_doubles(src, dst, back, NULL, l, n, m, b, k,
+        te, err);
+}
+
+double *inform_local_transfer_entropy_series(inform_series const *src,
+    inform_series const *dst, inform_series const *back, size_t k, double *te,
+    inform_error *err)
+{
+    series_arguments args;
+    if (check_series(src, dst, back, k, &args, err)) return NULL;
+    return local_transfer_entropy_doubles(src->data, dst->data, args.back,
+        args.encoded, args.l, src->n, src->m, args.b, k, te, err);
+}
+
+float *inform_local_transfer_entropy_float(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k, float *te,
+    inform_error *err)
+{
+    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NULL;
+    return local_transfer_entropy_floats(src, dst, back, NULL, l, n, m, b, k,
+        te, err);
+}
+
+float *inform_local_transfer_entropy_float_series(inform_series const *src,
+    inform_series const *dst, inform_series const *back, size_t k, float *te,
+    inform_error *err)
+{
+    series_arguments args;
+    if (check_series(src, dst, back, k, &args, err)) return NULL;
+    return local_transfer_entropy_floats(src->data, dst->data, args.back,
+        args.encoded, args.l, src->n, src->m, args.b, k, te, err);
+}
+
+inform_local_summary *inform_local_transfer_entropy_summary(int const *src,
+    int const *dst, int const *back, size_t l, size_t n, size_t m, int b,
+    size_t k, inform_local_summary *summary, inform_error *err)
+{
+    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NULL;
+    return local_transfer_entropy_summary(src, dst, back, NULL, l, n, m, b, k,
+        summary, err);
+}
+
+inform_local_summary *inform_local_transfer_entropy_summary_series(
+    inform_series const *src, inform_series const *dst,
+    inform_series const *back, size_t k, inform_local_summary *summary,
+    inform_error *err)
+{
+    series_arguments args;
+    if (check_series(src, dst, back, k, &args, err)) return NULL;
+    return local_transfer_entropy_summary(src->data, dst->data, args.back,
+        args.encoded, args.l, src->n, src->m, args.b, k, summary, err);
+}
+
+/// the number of sources whose histograms are filled together
+#define TE_MATRIX_SOURCES 8
+/// the number of a destination's encoded observations shared by a block
+#define TE_MATRIX_TILE 4096
+/// the histograms of each task: the destination's histories and predicates,
+/// then the states and sources of each source in a block
+#define TE_MATRIX_HISTOGRAMS(block) (2 + 2 * (block))
+
+typedef struct te_matrix_job
+{
+    int const *series;
+    size_t l, n, m, k;
+    int b;
+    /// the number of tasks and the number of sources in a block
+    size_t tasks, block;
+    histogram *hs;
+    /// each task's encoded histories (times b) and predicates
+    uint64_t *codes;
+    double *te;
+    bool *failed;
+} te_matrix_job;
+
+static bool check_matrix_arguments(int const *series, size_t l, size_t n,
+    size_t m, int b, size_t k, inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (l < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, true);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, true);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (histogram_support(b, k + 2) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    size_t const i = inform_valid_prefix(series, l * n * m, b);
+    if (i != l * n * m)
+    {
+        INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+            INFORM_EBADSTATE, true);
+    }
+    return false;
+}
+
+/**
+ * Encode the history, times `scale`, and predicate of every observation of a
+ * destination from time step `start >= k` on, counting them as they are
+ * encoded.
+ *
+ * @return false if out of memory
+ */
+static bool encode_destination(int const *dst, size_t n, size_t m, int b,
+    size_t k, size_t start, uint64_t scale, uint64_t *bases, uint64_t *codes,
+    histogram *histories, histogram *predicates)
+{
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i, dst += m)
+    {
+        uint64_t history = 0, q = 1;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            history *= b;
+            history += dst[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            uint64_t const predicate = history * b + dst[j];
+            if (j >= start)
             {
-                continue;
+                *bases++ = history * scale;
+                *codes++ = predicate;
+
+                ok &= histogram_tick(histories, history);
+                ok &= histogram_tick(predicates, predicate);
             }
-            for (int src_state = 0; src_state < b; ++src_state)
+
+            history = predicate - dst[j - k] * q;
+        }
+    }
+    return ok;
+}
+
+/**
+ * Compute the transfer entropy from each of a block of sources to a
+ * destination whose observations have been encoded.
+ *
+ * The observations are visited a tile at a time, and each tile is shared by
+ * every source of the block while it is still in cache.
+ *
+ * @return false if out of memory
+ */
+static bool te_matrix_block(te_matrix_job const *job, size_t dst,
+    size_t const *srcs, size_t count, uint64_t const *bases,
+    uint64_t const *predicates, histogram *hs, double shared)
+{
+    size_t const n = job->n, m = job->m, k = job->k, w = m - k, N = n * w;
+    for (size_t s = 0; s < 2 * count; ++s)
+    {
+        histogram_clear(hs + s);
+    }
+
+    bool ok = true;
+    for (size_t t0 = 0; t0 < N; t0 += TE_MATRIX_TILE)
+    {
+        size_t const t1 = (N - t0 < TE_MATRIX_TILE) ? N : t0 + TE_MATRIX_TILE;
+        for (size_t s = 0; s < count; ++s)
+        {
+            int const *src = job->series + srcs[s] * n * m;
+            histogram *states = hs + 2 * s, *sources = states + 1;
+            size_t i = t0 / w, j = k + t0 % w;
+            for (size_t t = t0; t < t1; ++t)
             {
-                source = history * b + src_state;
-                n_source = sources.histogram[source];
-                if (n_source == 0)
-                {
-                    continue;
-                }
-                state = predicate * b + src_state;
-                n_state = states.histogram[state];
-                if (n_state == 0)
+                uint64_t const src_state = src[i * m + j - 1];
+                ok &= histogram_tick(states, predicates[t] * job->b + src_state);
+                ok &= histogram_tick(sources, bases[t] + src_state);
+                if (++j == m)
                 {
-                    continue;
+                    j = k;
+                    ++i;
                 }
-                te += n_state * log2((n_state * n_history) / (n_source * n_predicate));
             }
         }
     }
 
-    free(data);
+    for (size_t s = 0; s < count && ok; ++s)
+    {
+        job->te[srcs[s] * job->l + dst] = (histogram_nlogn(hs + 2 * s) +
+            shared - histogram_nlogn(hs + 2 * s + 1)) / N;
+    }
+    return ok;
+}
 
-    return te / N;
+static void te_matrix_task(void *arg, size_t index)
+{
+    te_matrix_job const *job = arg;
+    size_t const l = job->l, n = job->n, m = job->m, N = n * (m - job->k);
+    histogram *hs = job->hs + index * TE_MATRIX_HISTOGRAMS(job->block);
+    histogram *histories = hs, *predicates = hs + 1;
+    uint64_t *bases = job->codes + 2 * N * index, *codes = bases + N;
+
+    bool ok = true;
+    for (size_t d = index; d < l && ok; d += job->tasks)
+    {
+        // the destination's histories are encoded and counted only once
+        histogram_clear(histories);
+        histogram_clear(predicates);
+        ok = encode_destination(job->series + d * n * m, n, m, job->b,
+            job->k, job->k, job->b, bases, codes, histories, predicates);
+        double const shared = histogram_nlogn(histories) -
+            histogram_nlogn(predicates);
+
+        job->te[d * l + d] = 0.0;
+        size_t srcs[TE_MATRIX_SOURCES], count = 0;
+        for (size_t s = 0; s < l && ok; ++s)
+        {
+            if (s != d)
+            {
+                srcs[count++] = s;
+            }
+            if (count == job->block || (s + 1 == l && count != 0))
+            {
+                ok = te_matrix_block(job, d, srcs, count, bases, codes,
+                    hs + 2, shared);
+                count = 0;
+            }
+        }
+    }
+    job->failed[index] = !ok;
 }
 
-double *inform_local_transfer_entropy(int const *src, int const *dst,
-    int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
-    inform_error *err)
+double *inform_transfer_entropy_matrix(int const *series, size_t l, size_t n,
+    size_t m, int b, size_t k, double *te, inform_error *err)
 {
-    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NULL;
+    if (check_matrix_arguments(series, l, n, m, b, k, err)) return NULL;
 
     size_t const N = n * (m - k);
+    size_t tasks = inform_get_num_threads();
+    if (tasks > l)
+    {
+        tasks = l;
+    }
+    size_t const block = (l - 1 < TE_MATRIX_SOURCES) ? l - 1 : TE_MATRIX_SOURCES;
+    size_t const per_task = TE_MATRIX_HISTOGRAMS(block);
+
+    uint64_t sizes[TE_MATRIX_HISTOGRAMS(TE_MATRIX_SOURCES)];
+    sizes[0] = histogram_support(b, k);
+    sizes[1] = sizes[0] * b;
+    for (size_t s = 0; s < block; ++s)
+    {
+        sizes[2 + 2 * s] = sizes[1] * b;
+        sizes[3 + 2 * s] = sizes[1];
+    }
 
     bool allocate = (te == NULL);
     if (allocate)
     {
-        te = malloc(N * sizeof(double));
-        if (te == NULL)
+        te = malloc(l * l * sizeof(double));
+    }
+    histogram *hs = malloc(tasks * per_task * sizeof(histogram));
+    uint64_t *codes = malloc(2 * N * tasks * sizeof(uint64_t));
+    bool *failed = calloc(tasks, sizeof(bool));
+    size_t initialized = 0;
+    if (te != NULL && hs != NULL && codes != NULL && failed != NULL)
+    {
+        // the histograms are chosen on this thread, where the engine is set
+        while (initialized < tasks &&
+            !histograms_init(hs + initialized * per_task, sizes, per_task, N))
         {
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+            ++initialized;
         }
     }
 
-    size_t const q = (size_t) pow((double) b, (double) k);
-    size_t const r = (size_t) pow((double) b, (double) l);
-    size_t const states_size     = b*b*q*r;
-    size_t const histories_size  = q*r;
-    size_t const sources_size    = b*q*r;
-    size_t const predicates_size = b*q*r;
-    size_t const total_size = states_size + histories_size + sources_size + predicates_size;
+    bool ok = initialized == tasks;
+    if (ok)
+    {
+        te_matrix_job job = { series, l, n, m, k, b, tasks, block, hs, codes,
+            te, failed };
+        inform_run_tasks(te_matrix_task, &job, tasks);
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            ok &= !failed[i];
+        }
+    }
 
-    uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
-    if (histogram_data == NULL)
+    histograms_free(hs, initialized * per_task);
+    free(failed);
+    free(codes);
+    free(hs);
+    if (!ok)
     {
+        if (allocate) free(te);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+    return te;
+}
+
+/// the number of lags whose histograms are filled together
+#define TE_LAGS_BLOCK 8
+
+typedef struct te_lags_job
+{
+    size_t n, m, start;
+    /// the smallest lag, the number of lags, the number of tasks and the
+    /// number of lags in a block
+    size_t min_lag, lags, tasks, block;
+    /// the number of source states, `b^ks`
+    uint64_t scale;
+    histogram *hs;
+    /// the encoded histories (times `scale`) and predicates of the
+    /// destination, and the encoded embedding of the source ending at each
+    /// time step
+    uint64_t const *bases, *predicates, *sources;
+    /// the part of the transfer entropy shared by every lag
+    double shared;
+    double *te;
+    bool *failed;
+} te_lags_job;
+
+static bool check_lags_arguments(int const *src, int const *dst, size_t n,
+    size_t m, int b, size_t k, size_t ks, size_t min_lag, size_t max_lag,
+    inform_error *err)
+{
+    if (check_shape(src, dst, NULL, 0, n, m, b, k, err))
+    {
+        return true;
+    }
+    else if (ks == 0 || min_lag == 0 || max_lag < min_lag)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (m <= max_lag + ks - 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    else if (histogram_support(b, k + ks + 1) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    for (size_t s = 0; s < 2; ++s)
+    {
+        int const *series = (s == 0) ? src : dst;
+        size_t const i = inform_valid_prefix(series, n * m, b);
+        if (i != n * m)
+        {
+            INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+                INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
+
+/**
+ * Encode the embedding of `ks` time steps of the source ending at each time
+ * step from `ks - 1` on.
+ */
+static void encode_source(int const *src, size_t n, size_t m, int b,
+    size_t ks, uint64_t scale, uint64_t *sources)
+{
+    for (size_t i = 0; i < n; ++i, src += m, sources += m)
+    {
+        uint64_t embedding = 0;
+        for (size_t j = 0; j < m; ++j)
+        {
+            embedding = (embedding * b + src[j]) % scale;
+            sources[j] = embedding;
+        }
+    }
+}
+
+/**
+ * Compute the transfer entropy at each of a block of lags, ticking the
+ * histograms of every lag of the block in a single sweep over the
+ * destination's observations.
+ *
+ * @return false if out of memory
+ */
+static bool te_lags_block(te_lags_job const *job, size_t const *lags,
+    size_t count, histogram *hs)
+{
+    for (size_t s = 0; s < 2 * count; ++s)
+    {
+        histogram_clear(hs + s);
+    }
+
+    bool ok = true;
+    size_t t = 0;
+    for (size_t i = 0; i < job->n; ++i)
+    {
+        uint64_t const *sources = job->sources + i * job->m;
+        for (size_t j = job->start; j < job->m; ++j, ++t)
+        {
+            uint64_t const state = job->predicates[t] * job->scale;
+            for (size_t s = 0; s < count; ++s)
+            {
+                uint64_t const src_state = sources[j - lags[s]];
+                ok &= histogram_tick(hs + 2 * s, state + src_state);
+                ok &= histogram_tick(hs + 2 * s + 1, job->bases[t] + src_state);
+            }
+        }
+    }
+
+    for (size_t s = 0; s < count && ok; ++s)
+    {
+        job->te[lags[s] - job->min_lag] = (histogram_nlogn(hs + 2 * s) +
+            job->shared - histogram_nlogn(hs + 2 * s + 1)) / t;
+    }
+    return ok;
+}
+
+static void te_lags_task(void *arg, size_t index)
+{
+    te_lags_job const *job = arg;
+    histogram *hs = job->hs + 2 * job->block * index;
+
+    bool ok = true;
+    size_t lags[TE_LAGS_BLOCK], count = 0;
+    for (size_t i = index; i < job->lags && ok; i += job->tasks)
+    {
+        lags[count++] = job->min_lag + i;
+        if (count == job->block || i + job->tasks >= job->lags)
+        {
+            ok = te_lags_block(job, lags, count, hs);
+            count = 0;
+        }
+    }
+    job->failed[index] = !ok;
+}
+
+double *inform_transfer_entropy_lag_scan(int const *src, int const *dst,
+    size_t n, size_t m, int b, size_t k, size_t ks, size_t min_lag,
+    size_t max_lag, double *te, inform_error *err)
+{
+    if (check_lags_arguments(src, dst, n, m, b, k, ks, min_lag, max_lag, err))
+    {
+        return NULL;
+    }
+
+    // every lag is estimated from the same observations, those for which the
+    // longest lag's source embedding has been seen
+    size_t const start = (k < max_lag + ks - 1) ? max_lag + ks - 1 : k;
+    size_t const N = n * (m - start), lags = max_lag - min_lag + 1;
+    size_t tasks = inform_get_num_threads();
+    if (tasks > lags)
+    {
+        tasks = lags;
+    }
+    size_t block = (lags + tasks - 1) / tasks;
+    if (block > TE_LAGS_BLOCK)
+    {
+        block = TE_LAGS_BLOCK;
+    }
+
+    uint64_t const scale = histogram_support(b, ks);
+    uint64_t const histories_size = histogram_support(b, k);
+    uint64_t sizes[2 * TE_LAGS_BLOCK];
+    for (size_t s = 0; s < block; ++s)
+    {
+        sizes[2 * s] = histories_size * b * scale;
+        sizes[2 * s + 1] = histories_size * scale;
+    }
+
+    bool allocate = (te == NULL);
+    if (allocate)
+    {
+        te = malloc(lags * sizeof(double));
+    }
+    histogram *hs = malloc(2 * block * tasks * sizeof(histogram));
+    uint64_t *codes = malloc((2 * N + n * m) * sizeof(uint64_t));
+    bool *failed = calloc(tasks, sizeof(bool));
+    histogram shared[2];
+    bool ok = te != NULL && hs != NULL && codes != NULL && failed != NULL &&
+        !histograms_init(shared, (uint64_t[]){ histories_size,
+        histories_size * b }, 2, N);
+    bool const counted = ok;
+
+    size_t initialized = 0;
+    if (ok)
+    {
+        // the destination's histories are encoded and counted only once
+        ok = encode_destination(dst, n, m, b, k, start, scale, codes,
+            codes + N, shared, shared + 1);
+        encode_source(src, n, m, b, ks, scale, codes + 2 * N);
+
+        // the histograms are chosen on this thread, where the engine is set
+        while (ok && initialized < tasks &&
+            !histograms_init(hs + initialized * 2 * block, sizes, 2 * block, N))
+        {
+            ++initialized;
+        }
+        ok = ok && initialized == tasks;
+    }
 
-    inform_dist states     = { histogram_data, states_size, N };
-    inform_dist histories  = { histogram_data + states_size, histories_size, N };
-    inform_dist sources    = { histogram_data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { histogram_data + states_size + histories_size + sources_size, predicates_size, N };
+    if (ok)
+    {
+        te_lags_job job = { n, m, start, min_lag, lags, tasks, block, scale,
+            hs, codes, codes + N, codes + 2 * N,
+            histogram_nlogn(shared) - histogram_nlogn(shared + 1), te,
+            failed };
+        inform_run_tasks(te_lags_task, &job, tasks);
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            ok &= !failed[i];
+        }
+    }
 
-    int *state_data = malloc(4 * N * sizeof(int));
-    if (state_data == NULL)
+    if (counted) histograms_free(shared, 2);
+    histograms_free(hs, initialized * 2 * block);
+    free(failed);
+    free(codes);
+    free(hs);
+    if (!ok)
     {
         if (allocate) free(te);
-        free(histogram_data);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    int *state     = state_data;
-    int *history   = state + N;
-    int *source    = history + N;
-    int *predicate = source + N;
+    return te;
+}
+
+static void windowed_encode(windowed_measure const *measure, size_t i,
+    size_t j, uint64_t *events)
+{
+    int const *src = measure->series[0] + i * measure->m;
+    int const *dst = measure->series[1] + i * measure->m;
+    int const b = measure->b;
+    uint64_t history = 0;
+    for (size_t t = j - measure->k; t < j; ++t)
+    {
+        history = history * b + dst[t];
+    }
+    uint64_t const predicate = history * b + dst[j];
+    events[0] = predicate * b + src[j-1];
+    events[1] = history;
+    events[2] = history * b + src[j-1];
+    events[3] = predicate;
+}
+
+static double windowed_value(double const *nlogn, uint64_t N)
+{
+    return (nlogn[0] + nlogn[1] - nlogn[2] - nlogn[3]) / N;
+}
+
+double *inform_transfer_entropy_windowed(int const *src, int const *dst,
+    size_t n, size_t m, int b, size_t k, size_t window, size_t stride,
+    double *te, inform_error *err)
+{
+    if (check_shape(src, dst, NULL, 0, n, m, b, k, err)) return NULL;
 
-    accumulate_local_observations(src, dst, back, l, n, m, b, k, &states,
-        &histories, &sources, &predicates, state, history, source, predicate);
+    uint64_t const histories_size = histogram_support(b, k);
+    windowed_measure const measure = {
+        .series = { src, dst }, .streams = 2, .n = n, .m = m, .k = k, .b = b,
+        .nhs = 4, .sizes = { histories_size*b*b, histories_size,
+        histories_size*b, histories_size*b },
+        .encode = windowed_encode, .value = windowed_value
+    };
+    return inform_windowed(&measure, window, stride, te, err);
+}
 
-    double s, t, u, v;
-    for (size_t i = 0; i < N; ++i)
+static bool acc_accumulate(inform_acc *acc, int const *series, size_t m)
+{
+    return accumulate_observations(series, series + m, series + 2 * m,
+        acc->l, 1, m, acc->b, acc->k, (observation_block){ 0, 1, acc->k, m },
+        acc->hs, acc->hs + 1, acc->hs + 2, acc->hs + 3);
+}
+
+static double acc_finalize(inform_acc const *acc, uint64_t N)
+{
+    return (histogram_nlogn(acc->hs) + histogram_nlogn(acc->hs + 1) -
+        histogram_nlogn(acc->hs + 2) - histogram_nlogn(acc->hs + 3)) / N;
+}
+
+static void acc_local(inform_acc const *acc, int const *series, size_t m,
+    double *te)
+{
+    local_sink sink = local_doubles(te);
+    local_observations(series, series + m, series + 2 * m, acc->l, 1, m,
+        acc->b, acc->k, acc->hs, acc->hs + 1, acc->hs + 2, acc->hs + 3, &sink);
+}
+
+static inform_acc_vtable const acc_vtable =
+{
+    acc_accumulate, acc_finalize, acc_local, INFORM_ACC_TRANSFER_ENTROPY
+};
+
+inform_acc *inform_transfer_entropy_acc(size_t l, int b, size_t k,
+    inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (k == 0)
     {
-        s = states.histogram[state[i]];
-        t = sources.histogram[source[i]];
-        u = predicates.histogram[predicate[i]];
-        v = histories.histogram[history[i]];
-        te[i] = log2((s*v)/(t*u));
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
     }
+    else if (histogram_support(b, k + l + 2) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    int *bases = malloc((l + 2) * sizeof(int));
+    if (bases == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    for (size_t i = 0; i < l + 2; ++i)
+    {
+        bases[i] = b;
+    }
+    uint64_t const histories_size = histogram_support(b, k + l);
+    inform_acc *acc = inform_acc_alloc(&acc_vtable, bases, l + 2, k + 1,
+        (uint64_t[]){histories_size*b*b, histories_size, histories_size*b,
+        histories_size*b}, 4, err);
+    free(bases);
+    if (acc != NULL)
+    {
+        acc->b = b;
+        acc->k = k;
+        acc->l = l;
+    }
+    return acc;
+}
+
+struct inform_online_te
+{
+    int b;
+    size_t k;
+    /// b^k, the number of histories
+    uint64_t q;
+    /// the histograms of the states, histories, sources and predicates
+    running_histogram hs[4];
+    /// the history of the target and the last state of the source
+    uint64_t history;
+    int src;
+    /// the number of time steps pushed since the last restart
+    size_t seen;
+    /// the states observed, as a ring buffer, if there is a window
+    uint64_t *states;
+    size_t window, head, count;
+};
 
-    free(state_data);
-    free(histogram_data);
+/**
+ * Add `delta` observations of a state, and of the history, source and
+ * predicate it is made of, to the histograms.
+ *
+ * @return false if a histogram could not grow, in which case none changed
+ */
+static bool online_observe(inform_online_te *te, uint64_t state, int delta)
+{
+    int const b = te->b;
+    uint64_t const predicate = state / b;
+    uint64_t const history = predicate / b;
+    uint64_t const events[4] = {
+        state, history, history * b + state % b, predicate
+    };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (!running_histogram_update(te->hs + i, events[i], delta))
+        {
+            while (i-- > 0)
+            {
+                running_histogram_update(te->hs + i, events[i], -delta);
+            }
+            return false;
+        }
+    }
+    return true;
+}
 
+inform_online_te *inform_transfer_entropy_online(int b, size_t k,
+    size_t window, inform_error *err)
+{
+    if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NULL);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    }
+    else if (histogram_support(b, k + 2) == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+    inform_online_te *te = calloc(1, sizeof(inform_online_te));
+    if (te == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    uint64_t const histories_size = histogram_support(b, k);
+    size_t const N = (window != 0) ? window : HISTOGRAM_SPARSE_HINT;
+    if (running_histograms_init(te->hs, (uint64_t[]){histories_size*b*b,
+        histories_size, histories_size*b, histories_size*b}, 4, N))
+    {
+        free(te);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    if (window != 0)
+    {
+        te->states = malloc(window * sizeof(uint64_t));
+        if (te->states == NULL)
+        {
+            running_histograms_free(te->hs, 4);
+            free(te);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+    te->b = b;
+    te->k = k;
+    te->q = histories_size;
+    te->window = window;
     return te;
 }
+
+double inform_online_te_push(inform_online_te *te, int src, int dst,
+    inform_error *err)
+{
+    if (te == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
+    else if (src < 0 || dst < 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, NAN);
+    }
+    else if (te->b <= src || te->b <= dst)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, NAN);
+    }
+
+    if (te->seen >= te->k)
+    {
+        uint64_t const state = (te->history * te->b + dst) * te->b + te->src;
+        if (!online_observe(te, state, 1))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        }
+        if (te->window != 0)
+        {
+            if (te->count == te->window)
+            {
+                online_observe(te, te->states[te->head], -1);
+                te->states[te->head] = state;
+                te->head = (te->head + 1) % te->window;
+            }
+            else
+            {
+                te->states[(te->head + te->count++) % te->window] = state;
+            }
+        }
+    }
+    te->history = (te->history * te->b + dst) % te->q;
+    te->src = src;
+    te->seen += 1;
+    return inform_online_te_value(te);
+}
+
+double inform_online_te_value(inform_online_te const *te)
+{
+    uint64_t const N = inform_online_te_observations(te);
+    if (N == 0)
+    {
+        return NAN;
+    }
+    return (te->hs[0].nlogn + te->hs[1].nlogn - te->hs[2].nlogn -
+        te->hs[3].nlogn) / N;
+}
+
+uint64_t inform_online_te_observations(inform_online_te const *te)
+{
+    return (te == NULL) ? 0 : histogram_counts(&te->hs[0].h);
+}
+
+void inform_online_te_restart(inform_online_te *te)
+{
+    if (te != NULL)
+    {
+        te->history = 0;
+        te->seen = 0;
+    }
+}
+
+void inform_online_te_free(inform_online_te *te)
+{
+    if (te != NULL)
+    {
+        running_histograms_free(te->hs, 4);
+        free(te->states);
+        free(te);
+    }
+}
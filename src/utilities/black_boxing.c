@@ -2,13 +2,15 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/error.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 
 #include <stdio.h>
 
 static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, inform_error *err)
+    int const *b, size_t const *r, size_t const *s, double max_bits,
+    inform_error *err)
 {
 
     if (series == NULL)
@@ -84,7 +86,7 @@ static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
             bits += s[i] * log2(b[i]);
         }
     }
-    if (bits > 30.0)
+    if (bits > max_bits)
     {
         INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
@@ -133,17 +135,17 @@ static void compute_lengths(size_t const *r, size_t const *s, size_t l,
     }
 }
 
-static void accumulate(int const *series, size_t l, size_t n, size_t m,
+static bool accumulate(int const *series, size_t l, size_t n, size_t m,
     int const *b, size_t const *r, size_t const *s, size_t max_r, size_t max_s,
-    int *box, inform_error *err)
+    uint64_t *box)
 {
-    int *data = malloc(2 * l * sizeof(int));
-    if (data == NULL) INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    uint64_t *data = malloc(2 * l * sizeof(uint64_t));
+    if (data == NULL) return true;
 
-    int *qs = data, *states = qs + l;
+    uint64_t *qs = data, *states = qs + l;
     size_t const w = m - max_r - max_s + 1;
     for (size_t i = 0; i < n * w; ++i) box[i] = 0;
-    
+
     for (size_t i = 0; i < l; ++i)
     {
         for (size_t j = 0; j < n; ++j)
@@ -169,14 +171,40 @@ static void accumulate(int const *series, size_t l, size_t n, size_t m,
             }
         }
     }
-        
+
     free(data);
+    return false;
 }
 
-int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
+static size_t *window_lengths(size_t const *r, size_t const *s, size_t l)
 {
-    if (check_arguments(series, l, n, m, b, r, s, err))
+    size_t *data = calloc(2 * l, sizeof(size_t));
+    if (data != NULL)
+    {
+        size_t *history = data;
+        if (r == NULL)
+        {
+            for (size_t i = 0; i < l; ++i) history[i] = 1;
+        }
+        else
+        {
+            memcpy(history, r, l * sizeof(size_t));
+        }
+
+        size_t *future = data + l;
+        if (s != NULL)
+        {
+            memcpy(future, s, l * sizeof(size_t));
+        }
+    }
+    return data;
+}
+
+static uint64_t *black_box(int const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, double max_bits,
+    uint64_t *box, inform_error *err)
+{
+    if (check_arguments(series, l, n, m, b, r, s, max_bits, err))
     {
         return NULL;
     }
@@ -186,47 +214,62 @@ int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
     bool allocate = (box == NULL);
     if (allocate)
     {
-        box = calloc(n * (m - max_r - max_s + 1), sizeof(int));
+        box = calloc(n * (m - max_r - max_s + 1), sizeof(uint64_t));
         if (box == NULL)
         {
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
 
-    size_t *data = calloc(2 * l, sizeof(size_t));
-    if (data == NULL)
+    size_t *data = window_lengths(r, s, l);
+    if (data == NULL ||
+        accumulate(series, l, n, m, b, data, data + l, max_r, max_s, box))
     {
         if (allocate) free(box);
+        free(data);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+    free(data);
+    return box;
+}
 
-    size_t *history = data;
-    if (r == NULL)
-    {
-        for (size_t i = 0; i < l; ++i) history[i] = 1;
-    }
-    else
+int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
+{
+    uint64_t *wide = black_box(series, l, n, m, b, r, s, 30.0, NULL, err);
+    if (wide == NULL)
     {
-        memcpy(history, r, l * sizeof(size_t));
+        return NULL;
     }
+    size_t max_r, max_s;
+    compute_lengths(r, s, l, &max_r, &max_s);
+    size_t const N = n * (m - max_r - max_s + 1);
 
-    size_t *future = data + l;
-    if (s != NULL)
+    if (box == NULL)
     {
-        memcpy(future, s, l * sizeof(size_t));
+        box = malloc(N * sizeof(int));
+        if (box == NULL)
+        {
+            free(wide);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
     }
-
-    accumulate(series, l, n, m, b, history, future, max_r, max_s, box, err);
-
-    if (inform_failed(err))
+    // the states fit within 30 bits, so each narrows without loss
+    for (size_t i = 0; i < N; ++i)
     {
-        if (allocate) free(box);
-        box = NULL;
+        box[i] = (int) wide[i];
     }
-    free(data);
+    free(wide);
     return box;
 }
 
+uint64_t *inform_black_box64(int const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, uint64_t *box,
+    inform_error *err)
+{
+    return black_box(series, l, n, m, b, r, s, 63.0, box, err);
+}
+
 static int compare_ints(void const *x, void const *y)
 {
     int a = *(int const *)x;
@@ -237,7 +280,7 @@ static int compare_ints(void const *x, void const *y)
 int *inform_black_box_parts(int const *series, size_t l, size_t n, int const *b,
     size_t const *parts, size_t nparts, int *box, inform_error *err)
 {
-    if (check_arguments(series, l, 1, n, b, NULL, NULL, err))
+    if (check_arguments(series, l, 1, n, b, NULL, NULL, 30.0, err))
     {
         return NULL;
     }
@@ -39,3 +39,38 @@ void inform_decode(int32_t encoding, int b, int *state, size_t n, inform_error *
     if (encoding != 0)
         INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
 }
+
+uint64_t inform_encode64(int const *state, size_t n, int b, inform_error *err)
+{
+    if (state == NULL || n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_EARG, UINT64_MAX);
+    else if (b < 2)
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, UINT64_MAX);
+    else if (n * log2(b) > 63)
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, UINT64_MAX);
+
+    uint64_t encoding = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (state[i] < 0 || b <= state[i])
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, UINT64_MAX);
+        encoding *= b;
+        encoding += state[i];
+    }
+    return encoding;
+}
+
+void inform_decode64(uint64_t encoding, int b, int *state, size_t n,
+    inform_error *err)
+{
+    if (b < 2)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EBASE);
+    else if (state == NULL || n == 0)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EARG);
+
+    for (size_t i = 0; i < n; ++i, encoding /= b)
+        state[n - i - 1] = encoding % b;
+
+    if (encoding != 0)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
+}
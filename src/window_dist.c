@@ -0,0 +1,174 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/window_dist.h>
+#include <math.h>
+#include <string.h>
+#include "log_table.h"
+#include "simd.h"
+
+/// the fewest updates between recomputations of the running sum
+#define WINDOW_RESYNC_MIN ((size_t) 1 << 16)
+
+/**
+ * Bound the rounding error which builds up in the running sum.
+ *
+ * Every update adds the difference of two tabulated terms, so the sum drifts
+ * by a few units in the last place per update. Recomputing it from the
+ * histogram once every max(size, WINDOW_RESYNC_MIN) updates keeps the drift
+ * bounded while costing amortized constant time per update.
+ */
+static void resync(inform_window_dist *wd)
+{
+    size_t const n = wd->dist->size;
+    if (++wd->updates >= n && wd->updates >= WINDOW_RESYNC_MIN)
+    {
+        wd->nlogn = inform_weighted_log2(wd->dist->histogram,
+            wd->dist->histogram, n);
+        wd->updates = 0;
+    }
+}
+
+inform_window_dist *inform_window_dist_alloc(size_t size, size_t width)
+{
+    if (size == 0 || width == 0)
+    {
+        return NULL;
+    }
+    inform_window_dist *wd = malloc(sizeof(inform_window_dist));
+    if (wd == NULL)
+    {
+        return NULL;
+    }
+    wd->dist = inform_dist_alloc(size);
+    wd->events = malloc(width * sizeof(size_t));
+    if (wd->dist == NULL || wd->events == NULL)
+    {
+        inform_dist_free(wd->dist);
+        free(wd->events);
+        free(wd);
+        return NULL;
+    }
+    wd->width = width;
+    wd->head = 0;
+    wd->nlogn = 0.0;
+    wd->updates = 0;
+    return wd;
+}
+
+void inform_window_dist_clear(inform_window_dist *wd)
+{
+    if (wd != NULL)
+    {
+        memset(wd->dist->histogram, 0, wd->dist->size * sizeof(uint32_t));
+        wd->dist->counts = 0;
+        wd->head = 0;
+        wd->nlogn = 0.0;
+        wd->updates = 0;
+    }
+}
+
+void inform_window_dist_free(inform_window_dist *wd)
+{
+    if (wd != NULL)
+    {
+        inform_dist_free(wd->dist);
+        free(wd->events);
+        free(wd);
+    }
+}
+
+size_t inform_window_dist_counts(inform_window_dist const *wd)
+{
+    return (wd == NULL) ? 0 : (size_t) wd->dist->counts;
+}
+
+uint32_t inform_window_dist_tick(inform_window_dist *wd, size_t event)
+{
+    if (wd == NULL || event >= wd->dist->size)
+    {
+        return 0;
+    }
+    if (wd->dist->counts == wd->width)
+    {
+        inform_window_dist_untick(wd);
+    }
+    size_t const tail = (wd->head + wd->dist->counts) % wd->width;
+    wd->events[tail] = event;
+    // c log c grows by (c+1) log (c+1) - c log c
+    uint32_t const c = wd->dist->histogram[event];
+    wd->nlogn += inform_nlog2n_count(c + 1) - inform_nlog2n_count(c);
+    wd->dist->histogram[event] = c + 1;
+    wd->dist->counts += 1;
+    resync(wd);
+    return c + 1;
+}
+
+size_t inform_window_dist_untick(inform_window_dist *wd)
+{
+    if (wd == NULL || wd->dist->counts == 0)
+    {
+        return 0;
+    }
+    size_t const event = wd->events[wd->head];
+    wd->head = (wd->head + 1) % wd->width;
+    uint32_t const c = wd->dist->histogram[event];
+    wd->nlogn += inform_nlog2n_count(c - 1) - inform_nlog2n_count(c);
+    wd->dist->histogram[event] = c - 1;
+    wd->dist->counts -= 1;
+    if (wd->dist->counts == 0)
+    {
+        // an empty window has an exact running sum
+        wd->head = 0;
+        wd->nlogn = 0.0;
+        wd->updates = 0;
+    }
+    else
+    {
+        resync(wd);
+    }
+    return (size_t) wd->dist->counts;
+}
+
+double inform_window_dist_entropy(inform_window_dist const *wd, double base)
+{
+    if (wd == NULL || wd->dist->counts == 0)
+    {
+        return NAN;
+    }
+    double const N = (double) wd->dist->counts;
+    return (inform_log2_count(wd->dist->counts) - wd->nlogn / N) / log2(base);
+}
+
+double inform_window_dist_mi(inform_window_dist const *joint,
+    inform_window_dist const *marginal_x, inform_window_dist const *marginal_y,
+    double base)
+{
+    if (joint == NULL || marginal_x == NULL || marginal_y == NULL)
+    {
+        return NAN;
+    }
+    uint64_t const n = joint->dist->counts;
+    if (n == 0 || marginal_x->dist->counts != n ||
+        marginal_y->dist->counts != n)
+    {
+        return NAN;
+    }
+    double const s = joint->nlogn - marginal_x->nlogn - marginal_y->nlogn;
+    return (inform_log2_count(n) + s / (double) n) / log2(base);
+}
+
+double inform_window_dist_ce(inform_window_dist const *joint,
+    inform_window_dist const *marginal, double base)
+{
+    if (joint == NULL || marginal == NULL)
+    {
+        return NAN;
+    }
+    uint64_t const n = joint->dist->counts;
+    if (n == 0 || marginal->dist->counts != n)
+    {
+        return NAN;
+    }
+    return ((marginal->nlogn - joint->nlogn) / (double) n) / log2(base);
+}
@@ -0,0 +1,112 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "histogram.h"
+#include "windowed.h"
+
+/**
+ * Add (`delta` = 1) or remove (`delta` = -1) the observations made at time
+ * steps `[begin, end)` of every initial condition.
+ *
+ * @return false if out of memory
+ */
+static bool update(windowed_measure const *measure, running_histogram *hs,
+    size_t begin, size_t end, int delta)
+{
+    uint64_t events[WINDOWED_MAX_HISTOGRAMS];
+    for (size_t i = 0; i < measure->n; ++i)
+    {
+        for (size_t j = begin; j < end; ++j)
+        {
+            measure->encode(measure, i, j, events);
+            for (size_t h = 0; h < measure->nhs; ++h)
+            {
+                if (!running_histogram_update(hs + h, events[h], delta))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_states(windowed_measure const *measure, inform_error *err)
+{
+    size_t const N = measure->n * measure->m;
+    for (size_t s = 0; s < measure->streams; ++s)
+    {
+        int const *series = measure->series[s];
+        size_t const i = inform_valid_prefix(series, N, measure->b);
+        if (i != N)
+        {
+            INFORM_ERROR_RETURN(err, (series[i] < 0) ? INFORM_ENEGSTATE :
+                INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
+
+double *inform_windowed(windowed_measure const *measure, size_t window,
+    size_t stride, double *values, inform_error *err)
+{
+    size_t const k = measure->k;
+    if (window <= k || measure->m < window || stride == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    else if (check_states(measure, err))
+    {
+        return NULL;
+    }
+
+    size_t const count = (measure->m - window) / stride + 1;
+    bool allocate = (values == NULL);
+    if (allocate)
+    {
+        values = malloc(count * sizeof(double));
+        if (values == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    running_histogram hs[WINDOWED_MAX_HISTOGRAMS];
+    size_t const N = measure->n * (window - k);
+    if (running_histograms_init(hs, measure->sizes, measure->nhs, N))
+    {
+        if (allocate) free(values);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    // the window starting at time step s holds the observations made at
+    // time steps [s + k, s + window)
+    bool ok = update(measure, hs, k, window, 1);
+    double nlogn[WINDOWED_MAX_HISTOGRAMS];
+    for (size_t w = 0; ok && w < count; ++w)
+    {
+        if (w != 0)
+        {
+            size_t const prev = (w - 1) * stride, next = w * stride;
+            size_t const leaving = (prev + window < next + k) ?
+                prev + window : next + k;
+            size_t const entering = (prev + window > next + k) ?
+                prev + window : next + k;
+            ok = update(measure, hs, prev + k, leaving, -1) &&
+                update(measure, hs, entering, next + window, 1);
+        }
+        for (size_t h = 0; h < measure->nhs; ++h)
+        {
+            nlogn[h] = hs[h].nlogn;
+        }
+        values[w] = measure->value(nlogn, N);
+    }
+    running_histograms_free(hs, measure->nhs);
+
+    if (!ok)
+    {
+        if (allocate) free(values);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return values;
+}
@@ -0,0 +1,57 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// the most histograms a windowed measure may use
+#define WINDOWED_MAX_HISTOGRAMS 4
+
+/**
+ * A time series measure, split into the events each observation adds to its
+ * histograms and the value it takes given their running sums, so that it
+ * can be computed over a sliding window
+ */
+typedef struct windowed_measure
+{
+    /// the time series of each stream, e.g. the source and the target
+    int const *series[2];
+    /// the number of streams
+    size_t streams;
+    /// the shape of the time series, the base and the history length
+    size_t n, m, k;
+    int b;
+    /// the number of histograms and the support of each
+    size_t nhs;
+    uint64_t sizes[WINDOWED_MAX_HISTOGRAMS];
+    /// encode the observation made at time step `j >= k` of initial condition
+    /// `i`, as one event for each histogram
+    void (*encode)(struct windowed_measure const *measure, size_t i, size_t j,
+        uint64_t *events);
+    /// compute the measure from the running sum of c log2 c over each
+    /// histogram, given `N > 0` observations
+    double (*value)(double const *nlogn, uint64_t N);
+} windowed_measure;
+
+/**
+ * Compute a measure over windows of `window` time steps, advanced `stride`
+ * time steps at a time, of every initial condition at once.
+ *
+ * Each window after the first removes the observations which fell off its
+ * trailing edge and adds those which came in at its leading edge, so the
+ * cost of a window is proportional to the stride rather than the window.
+ * The time series are validated before any window is computed. The measure's
+ * shape must already have been checked.
+ *
+ * @param[in] measure the measure
+ * @param[in] window  the number of time steps in each window
+ * @param[in] stride  the number of time steps between windows
+ * @param[out] values the value of each window, or NULL to allocate them
+ * @param[out] err    an error structure
+ * @return a pointer to the values
+ */
+double *inform_windowed(windowed_measure const *measure, size_t window,
+    size_t stride, double *values, inform_error *err);
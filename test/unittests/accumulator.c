@@ -0,0 +1,866 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/accumulator.h>
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/conditional_entropy.h>
+#include <inform/engine.h>
+#include <inform/entropy_rate.h>
+#include <inform/excess_entropy.h>
+#include <inform/mutual_info.h>
+#include <inform/predictive_info.h>
+#include <inform/transfer_entropy.h>
+#include <stdio.h>
+#include "util.h"
+
+#define ACC_TOL 1e-10
+#define ACC_N 3
+#define ACC_M 300
+
+/*
+ * Feed `streams` time series of length `m` to an accumulator in chunks of
+ * irregular size, then restart it.
+ */
+static void feed(inform_acc *acc, int const **streams, size_t S, size_t m)
+{
+    int *chunk = malloc(S * m * sizeof(int));
+    size_t sizes[] = { 1, 2, 5, 3, 1, 13, 40, 4 };
+    size_t start = 0;
+    for (size_t c = 0; start < m; ++c)
+    {
+        size_t len = sizes[c % (sizeof(sizes) / sizeof(size_t))];
+        if (start + len > m)
+        {
+            len = m - start;
+        }
+        for (size_t s = 0; s < S; ++s)
+        {
+            for (size_t j = 0; j < len; ++j)
+            {
+                chunk[j + len * s] = streams[s][start + j];
+            }
+        }
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_FALSE(inform_acc_accumulate(acc, chunk, len, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        start += len;
+    }
+    inform_acc_restart(acc);
+    free(chunk);
+}
+
+static void feed_series(inform_acc *acc, int const *series, size_t n, size_t m)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        int const *stream = series + m * i;
+        feed(acc, &stream, 1, m);
+    }
+}
+
+UNIT(ActiveInfoChunked)
+{
+    int series[ACC_N * ACC_M];
+    random_binary_series(series, ACC_N * ACC_M, 2018);
+    for (size_t k = 1; k <= 4; ++k)
+    {
+        inform_error err = INFORM_SUCCESS;
+        inform_acc *acc = inform_active_info_acc(2, k, &err);
+        ASSERT_NOT_NULL(acc);
+        feed_series(acc, series, ACC_N, ACC_M);
+        ASSERT_EQUAL_U(ACC_N * (ACC_M - k), inform_acc_observations(acc));
+        ASSERT_DBL_NEAR_TOL(inform_active_info(series, ACC_N, ACC_M, 2, k, &err),
+            inform_acc_finalize(acc, &err), ACC_TOL);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_acc_free(acc);
+    }
+}
+
+UNIT(EntropyRateChunked)
+{
+    int series[ACC_N * ACC_M];
+    random_binary_series(series, ACC_N * ACC_M, 2019);
+    for (size_t k = 1; k <= 4; ++k)
+    {
+        inform_error err = INFORM_SUCCESS;
+        inform_acc *acc = inform_entropy_rate_acc(2, k, &err);
+        ASSERT_NOT_NULL(acc);
+        feed_series(acc, series, ACC_N, ACC_M);
+        ASSERT_DBL_NEAR_TOL(inform_entropy_rate(series, ACC_N, ACC_M, 2, k, &err),
+            inform_acc_finalize(acc, &err), ACC_TOL);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_acc_free(acc);
+    }
+}
+
+UNIT(BlockEntropyChunked)
+{
+    int series[ACC_N * ACC_M];
+    random_binary_series(series, ACC_N * ACC_M, 2020);
+    for (size_t k = 1; k <= 4; ++k)
+    {
+        inform_error err = INFORM_SUCCESS;
+        inform_acc *acc = inform_block_entropy_acc(2, k, &err);
+        ASSERT_NOT_NULL(acc);
+        feed_series(acc, series, ACC_N, ACC_M);
+        ASSERT_DBL_NEAR_TOL(inform_block_entropy(series, ACC_N, ACC_M, 2, k, &err),
+            inform_acc_finalize(acc, &err), ACC_TOL);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_acc_free(acc);
+    }
+}
+
+UNIT(PredictiveInfoChunked)
+{
+    int series[ACC_N * ACC_M];
+    random_binary_series(series, ACC_N * ACC_M, 2021);
+    for (size_t kpast = 1; kpast <= 3; ++kpast)
+    {
+        for (size_t kfuture = 1; kfuture <= 3; ++kfuture)
+        {
+            inform_error err = INFORM_SUCCESS;
+            inform_acc *acc = inform_predictive_info_acc(2, kpast, kfuture, &err);
+            ASSERT_NOT_NULL(acc);
+            feed_series(acc, series, ACC_N, ACC_M);
+            ASSERT_DBL_NEAR_TOL(inform_predictive_info(series, ACC_N, ACC_M, 2,
+                kpast, kfuture, &err), inform_acc_finalize(acc, &err), ACC_TOL);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            inform_acc_free(acc);
+        }
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_excess_entropy_acc(2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+    feed_series(acc, series, ACC_N, ACC_M);
+    ASSERT_DBL_NEAR_TOL(inform_excess_entropy(series, ACC_N, ACC_M, 2, 2, &err),
+        inform_acc_finalize(acc, &err), ACC_TOL);
+    inform_acc_free(acc);
+}
+
+UNIT(TransferEntropyChunked)
+{
+    int src[ACC_N * ACC_M], dst[ACC_N * ACC_M], back[2 * ACC_N * ACC_M];
+    random_binary_series(src, ACC_N * ACC_M, 2022);
+    random_binary_series(back, 2 * ACC_N * ACC_M, 2023);
+    dst[0] = 0;
+    for (size_t i = 1; i < ACC_N * ACC_M; ++i)
+    {
+        dst[i] = src[i - 1] ^ (back[i] & back[i - 1]);
+    }
+    for (size_t l = 0; l <= 2; ++l)
+    {
+        for (size_t k = 1; k <= 3; ++k)
+        {
+            inform_error err = INFORM_SUCCESS;
+            inform_acc *acc = inform_transfer_entropy_acc(l, 2, k, &err);
+            ASSERT_NOT_NULL(acc);
+            for (size_t i = 0; i < ACC_N; ++i)
+            {
+                int const *streams[] = {
+                    src + ACC_M * i, dst + ACC_M * i,
+                    back + ACC_M * i, back + ACC_M * (ACC_N + i)
+                };
+                feed(acc, streams, l + 2, ACC_M);
+            }
+            ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst,
+                (l == 0) ? NULL : back, l, ACC_N, ACC_M, 2, k, &err),
+                inform_acc_finalize(acc, &err), ACC_TOL);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            inform_acc_free(acc);
+        }
+    }
+}
+
+UNIT(MutualInfoChunked)
+{
+    int series[3 * ACC_M];
+    random_binary_series(series, 2 * ACC_M, 2024);
+    for (size_t i = 0; i < ACC_M; ++i)
+    {
+        series[2 * ACC_M + i] = series[i] + series[ACC_M + i];
+    }
+    int const *streams[] = { series, series + ACC_M, series + 2 * ACC_M };
+    int const b[] = { 2, 2, 3 };
+
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_mutual_info_acc(3, b, &err);
+    ASSERT_NOT_NULL(acc);
+    feed(acc, streams, 3, ACC_M);
+    ASSERT_DBL_NEAR_TOL(inform_mutual_info(series, 3, ACC_M, b, &err),
+        inform_acc_finalize(acc, &err), ACC_TOL);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    inform_acc_free(acc);
+
+    acc = inform_conditional_entropy_acc(3, 2, &err);
+    ASSERT_NOT_NULL(acc);
+    int const *pair[] = { streams[2], streams[0] };
+    feed(acc, pair, 2, ACC_M);
+    ASSERT_DBL_NEAR_TOL(inform_conditional_entropy(streams[2], streams[0],
+        ACC_M, 3, 2, &err), inform_acc_finalize(acc, &err), ACC_TOL);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    inform_acc_free(acc);
+}
+
+UNIT(Merge)
+{
+    int series[4 * ACC_M];
+    random_binary_series(series, 4 * ACC_M, 2025);
+    for (size_t e = 0; e < 2; ++e)
+    {
+        inform_error err = INFORM_SUCCESS;
+        inform_acc *left = inform_active_info_acc(2, 3, &err);
+        // the other half is histogrammed sparsely, on the second pass
+        inform_set_engine(e ? INFORM_ENGINE_SPARSE : INFORM_ENGINE_AUTO);
+        inform_acc *right = inform_active_info_acc(2, 3, &err);
+        inform_set_engine(INFORM_ENGINE_AUTO);
+        ASSERT_NOT_NULL(left);
+        ASSERT_NOT_NULL(right);
+
+        feed_series(left, series, 1, ACC_M);
+        feed_series(right, series + ACC_M, 3, ACC_M);
+
+        ASSERT_FALSE(inform_acc_merge(right, left, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL_U(4 * (ACC_M - 3), inform_acc_observations(left));
+        ASSERT_DBL_NEAR_TOL(inform_active_info(series, 4, ACC_M, 2, 3, &err),
+            inform_acc_finalize(left, &err), ACC_TOL);
+
+        ASSERT_FALSE(inform_acc_merge(left, right, &err));
+        ASSERT_EQUAL_U(7 * (ACC_M - 3), inform_acc_observations(right));
+
+        inform_acc_free(left);
+        inform_acc_free(right);
+    }
+}
+
+UNIT(MergeIncompatible)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *ai = inform_active_info_acc(2, 2, &err);
+    inform_acc *ai3 = inform_active_info_acc(2, 3, &err);
+    inform_acc *er = inform_entropy_rate_acc(2, 2, &err);
+    ASSERT_NOT_NULL(ai);
+    ASSERT_NOT_NULL(ai3);
+    ASSERT_NOT_NULL(er);
+
+    ASSERT_TRUE(inform_acc_merge(ai3, ai, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_merge(er, ai, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_merge(NULL, ai, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    inform_acc_free(ai);
+    inform_acc_free(ai3);
+    inform_acc_free(er);
+}
+
+UNIT(Local)
+{
+    int series[ACC_M];
+    random_binary_series(series, ACC_M, 2026);
+
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_active_info_acc(2, 2, &err);
+    feed_series(acc, series, 1, ACC_M);
+    double *expect = inform_local_active_info(series, 1, ACC_M, 2, 2, NULL, &err);
+    double *got = inform_acc_local(acc, series, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M - 2, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+
+    acc = inform_predictive_info_acc(2, 2, 3, &err);
+    feed_series(acc, series, 1, ACC_M);
+    expect = inform_local_predictive_info(series, 1, ACC_M, 2, 2, 3, NULL, &err);
+    got = inform_acc_local(acc, series, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M - 4, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+
+    acc = inform_block_entropy_acc(2, 3, &err);
+    feed_series(acc, series, 1, ACC_M);
+    expect = inform_local_block_entropy(series, 1, ACC_M, 2, 3, NULL, &err);
+    got = inform_acc_local(acc, series, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M - 2, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+
+    acc = inform_entropy_rate_acc(2, 2, &err);
+    feed_series(acc, series, 1, ACC_M);
+    expect = inform_local_entropy_rate(series, 1, ACC_M, 2, 2, NULL, &err);
+    got = inform_acc_local(acc, series, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M - 2, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+
+    int pair[2 * ACC_M];
+    random_binary_series(pair, ACC_M, 2027);
+    for (size_t i = 0; i < ACC_M; ++i)
+    {
+        pair[ACC_M + i] = (i == 0) ? 0 : pair[i - 1];
+    }
+    int const *streams[] = { pair, pair + ACC_M, series };
+
+    acc = inform_transfer_entropy_acc(1, 2, 2, &err);
+    feed(acc, streams, 3, ACC_M);
+    expect = inform_local_transfer_entropy(pair, pair + ACC_M, series, 1, 1,
+        ACC_M, 2, 2, NULL, &err);
+    int te_series[3 * ACC_M];
+    for (size_t i = 0; i < ACC_M; ++i)
+    {
+        te_series[i] = pair[i];
+        te_series[ACC_M + i] = pair[ACC_M + i];
+        te_series[2 * ACC_M + i] = series[i];
+    }
+    got = inform_acc_local(acc, te_series, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M - 2, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+
+    acc = inform_mutual_info_acc(2, (int[]){2, 2}, &err);
+    feed(acc, streams, 2, ACC_M);
+    expect = inform_local_mutual_info(pair, 2, ACC_M, (int[]){2, 2}, NULL, &err);
+    got = inform_acc_local(acc, pair, ACC_M, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, ACC_M, ACC_TOL);
+    free(expect);
+    free(got);
+    inform_acc_free(acc);
+}
+
+UNIT(Errors)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_active_info_acc(1, 2, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_entropy_rate_acc(2, 0, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_block_entropy_acc(2, 64, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_acc(1, (int[]){2}, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    inform_acc *acc = inform_active_info_acc(2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+
+    ASSERT_NAN(inform_acc_finalize(acc, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_FALSE(inform_acc_accumulate(acc, (int[]){0, 1, 1, 0}, 4, &err));
+    ASSERT_EQUAL_U(2, inform_acc_observations(acc));
+
+    ASSERT_TRUE(inform_acc_accumulate(acc, (int[]){0, 2, 1}, 3, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    ASSERT_EQUAL_U(2, inform_acc_observations(acc));
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_accumulate(acc, (int[]){0, -1, 1}, 3, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    ASSERT_EQUAL_U(2, inform_acc_observations(acc));
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_accumulate(acc, NULL, 3, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_acc_local(acc, (int[]){0, 1}, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    // the rejected chunks leave the history unbroken
+    err = INFORM_SUCCESS;
+    ASSERT_FALSE(inform_acc_accumulate(acc, (int[]){1}, 1, &err));
+    ASSERT_EQUAL_U(3, inform_acc_observations(acc));
+
+    inform_acc_free(acc);
+}
+
+static inform_acc *round_trip(inform_acc const *acc)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const n = inform_acc_serialize(acc, NULL, 0, &err);
+    uint8_t *buffer = malloc(n);
+    inform_acc_serialize(acc, buffer, n, &err);
+    size_t used = 0;
+    inform_acc *copy = inform_acc_deserialize(buffer, n, &used, &err);
+    free(buffer);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_EQUAL_U(n, used);
+    return copy;
+}
+
+UNIT(SerializeResume)
+{
+    int src[ACC_M], dst[ACC_M];
+    random_binary_series(src, ACC_M, 2028);
+    dst[0] = 0;
+    for (size_t i = 1; i < ACC_M; ++i)
+    {
+        dst[i] = src[i - 1];
+    }
+    int series[2 * ACC_M];
+    for (size_t i = 0; i < ACC_M; ++i)
+    {
+        series[i] = src[i];
+        series[ACC_M + i] = dst[i];
+    }
+    double const expect = inform_transfer_entropy(src, dst, NULL, 0, 1,
+        ACC_M, 2, 3, NULL);
+
+    // checkpoint part way through the series, with the histograms stored
+    // densely and then sparsely
+    for (size_t e = 0; e < 2; ++e)
+    {
+        inform_set_engine(e ? INFORM_ENGINE_SPARSE : INFORM_ENGINE_AUTO);
+        inform_error err = INFORM_SUCCESS;
+        inform_acc *acc = inform_transfer_entropy_acc(0, 2, 3, &err);
+        ASSERT_NOT_NULL(acc);
+
+        size_t const split = 101;
+        int chunk[2 * ACC_M];
+        for (size_t i = 0; i < split; ++i)
+        {
+            chunk[i] = src[i];
+            chunk[split + i] = dst[i];
+        }
+        ASSERT_FALSE(inform_acc_accumulate(acc, chunk, split, &err));
+
+        inform_acc *copy = round_trip(acc);
+        ASSERT_NOT_NULL(copy);
+        inform_acc_free(acc);
+
+        for (size_t i = split; i < ACC_M; ++i)
+        {
+            chunk[i - split] = src[i];
+            chunk[ACC_M - split + i - split] = dst[i];
+        }
+        ASSERT_FALSE(inform_acc_accumulate(copy, chunk, ACC_M - split, &err));
+        ASSERT_EQUAL_U(ACC_M - 3, inform_acc_observations(copy));
+        ASSERT_DBL_NEAR_TOL(expect, inform_acc_finalize(copy, &err), ACC_TOL);
+
+        double *local = inform_acc_local(copy, series, ACC_M, NULL, &err);
+        double *expect_local = inform_local_transfer_entropy(src, dst, NULL, 0,
+            1, ACC_M, 2, 3, NULL, &err);
+        ASSERT_DBL_ARRAY_NEAR_TOL(expect_local, local, ACC_M - 3, ACC_TOL);
+        free(local);
+        free(expect_local);
+        inform_acc_free(copy);
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(SerializeMalformed)
+{
+    int series[ACC_M];
+    random_binary_series(series, ACC_M, 2029);
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_mutual_info_acc(2, (int[]){2, 2}, &err);
+    ASSERT_NOT_NULL(acc);
+    ASSERT_FALSE(inform_acc_accumulate(acc, series, ACC_M / 2, &err));
+
+    size_t const n = inform_acc_serialize(acc, NULL, 0, &err);
+    uint8_t *buffer = malloc(n);
+    ASSERT_EQUAL_U(n, inform_acc_serialize(acc, buffer, n, &err));
+    for (size_t i = 0; i < n; ++i)
+    {
+        err = INFORM_SUCCESS;
+        ASSERT_NULL(inform_acc_deserialize(buffer, i, NULL, &err));
+        ASSERT_EQUAL(INFORM_EFORMAT, err);
+    }
+    // an unknown measure
+    buffer[8] = 100;
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_acc_deserialize(buffer, n, NULL, &err));
+    ASSERT_EQUAL(INFORM_EFORMAT, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL_U(0, inform_acc_serialize(NULL, buffer, n, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    free(buffer);
+    inform_acc_free(acc);
+}
+
+UNIT(SaveLoad)
+{
+    char const *path = "inform_acc_save_load.bin";
+    int series[ACC_M];
+    random_binary_series(series, ACC_M, 2030);
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_active_info_acc(2, 2, &err);
+    ASSERT_FALSE(inform_acc_accumulate(acc, series, ACC_M, &err));
+    ASSERT_FALSE(inform_acc_save(acc, path, &err));
+
+    inform_acc *copy = inform_acc_load(path, &err);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_DBL_NEAR_TOL(inform_acc_finalize(acc, &err),
+        inform_acc_finalize(copy, &err), ACC_TOL);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    // a loaded accumulator can be merged with the original
+    ASSERT_FALSE(inform_acc_merge(copy, acc, &err));
+    ASSERT_EQUAL_U(2 * (ACC_M - 2), inform_acc_observations(acc));
+
+    remove(path);
+    ASSERT_NULL(inform_acc_load(path, &err));
+    ASSERT_EQUAL(INFORM_EIO, err);
+
+    inform_acc_free(copy);
+    inform_acc_free(acc);
+}
+
+/*
+ * A reader over time series held in memory, which writes fewer time steps
+ * than it is asked for whenever its irregular chunk sizes say so
+ */
+typedef struct memory_reader
+{
+    int const **streams;
+    size_t S, m, start, calls;
+} memory_reader;
+
+static size_t read_memory(void *arg, int *series, size_t m, inform_error *err)
+{
+    memory_reader *reader = arg;
+    size_t const sizes[] = { 7, 3, 100, 1 };
+    size_t len = sizes[reader->calls++ % (sizeof(sizes) / sizeof(size_t))];
+    if (len > m)
+    {
+        len = m;
+    }
+    if (len > reader->m - reader->start)
+    {
+        len = reader->m - reader->start;
+    }
+    for (size_t s = 0; s < reader->S; ++s)
+    {
+        for (size_t j = 0; j < len; ++j)
+        {
+            series[j + m * s] = reader->streams[s][reader->start + j];
+        }
+    }
+    reader->start += len;
+    return len;
+}
+
+static size_t read_file(void *arg, int *series, size_t m, inform_error *err)
+{
+    size_t const len = fread(series, sizeof(int), m, arg);
+    if (len == 0 && ferror((FILE *) arg))
+    {
+        INFORM_ERROR(err, INFORM_EIO);
+    }
+    return len;
+}
+
+static size_t read_failure(void *arg, int *series, size_t m, inform_error *err)
+{
+    size_t *calls = arg;
+    if ((*calls)++ == 0)
+    {
+        series[0] = 0;
+        series[1] = 1;
+        series[2] = 1;
+        return 3;
+    }
+    INFORM_ERROR(err, INFORM_EIO);
+    return 0;
+}
+
+static size_t read_too_much(void *arg, int *series, size_t m, inform_error *err)
+{
+    return m + 1;
+}
+
+/*
+ * A writer which appends the local values to an array of `capacity` values
+ */
+typedef struct memory_writer
+{
+    double *local;
+    size_t n, capacity, calls;
+} memory_writer;
+
+static void write_memory(void *arg, double const *local, size_t n,
+    inform_error *err)
+{
+    memory_writer *writer = arg;
+    writer->calls++;
+    if (writer->n + n > writer->capacity)
+    {
+        INFORM_ERROR(err, INFORM_ESIZE);
+        return;
+    }
+    memcpy(writer->local + writer->n, local, n * sizeof(double));
+    writer->n += n;
+}
+
+static void write_failure(void *arg, double const *local, size_t n,
+    inform_error *err)
+{
+    ++*(size_t *) arg;
+    INFORM_ERROR(err, INFORM_EIO);
+}
+
+UNIT(ReadChunks)
+{
+    int src[ACC_N * ACC_M], dst[ACC_N * ACC_M], back[ACC_N * ACC_M];
+    random_binary_series(src, ACC_N * ACC_M, 2030);
+    random_binary_series(back, ACC_N * ACC_M, 2031);
+    dst[0] = 0;
+    for (size_t i = 1; i < ACC_N * ACC_M; ++i)
+    {
+        dst[i] = src[i - 1] ^ back[i - 1];
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_transfer_entropy_acc(1, 2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+    for (size_t i = 0; i < ACC_N; ++i)
+    {
+        int const *streams[] = {
+            src + ACC_M * i, dst + ACC_M * i, back + ACC_M * i
+        };
+        memory_reader reader = { streams, 3, ACC_M, 0, 0 };
+        ASSERT_FALSE(inform_acc_read(acc, read_memory, &reader, 16, &err));
+        ASSERT_EQUAL_U(ACC_M, reader.start);
+        inform_acc_restart(acc);
+    }
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, back, 1, ACC_N,
+        ACC_M, 2, 2, &err), inform_acc_finalize(acc, &err), ACC_TOL);
+    inform_acc_free(acc);
+
+    // a series on disk is only ever read a chunk at a time
+    FILE *file = tmpfile();
+    ASSERT_NOT_NULL(file);
+    ASSERT_EQUAL_U(ACC_M, fwrite(src, sizeof(int), ACC_M, file));
+    rewind(file);
+    acc = inform_active_info_acc(2, 3, &err);
+    ASSERT_FALSE(inform_acc_read(acc, read_file, file, 10, &err));
+    ASSERT_DBL_NEAR_TOL(inform_active_info(src, 1, ACC_M, 2, 3, &err),
+        inform_acc_finalize(acc, &err), ACC_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    inform_acc_free(acc);
+    fclose(file);
+}
+
+UNIT(ReadErrors)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_active_info_acc(2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+
+    size_t calls = 0;
+    ASSERT_TRUE(inform_acc_read(NULL, read_failure, &calls, 4, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_TRUE(inform_acc_read(acc, NULL, &calls, 4, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_TRUE(inform_acc_read(acc, read_failure, &calls, 0, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // the chunks read before the reader fails remain accumulated
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_read(acc, read_failure, &calls, 4, &err));
+    ASSERT_EQUAL(INFORM_EIO, err);
+    ASSERT_EQUAL_U(2, calls);
+    ASSERT_EQUAL_U(1, inform_acc_observations(acc));
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_read(acc, read_too_much, NULL, 4, &err));
+    ASSERT_EQUAL(INFORM_ESIZE, err);
+
+    int const bad[] = { 0, 1, 2, 1 };
+    int const *streams[] = { bad };
+    memory_reader reader = { streams, 1, 4, 0, 0 };
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_read(acc, read_memory, &reader, 4, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    ASSERT_EQUAL_U(1, inform_acc_observations(acc));
+
+    inform_acc_free(acc);
+}
+
+UNIT(ReadLocal)
+{
+    int src[ACC_N * ACC_M], dst[ACC_N * ACC_M], back[ACC_N * ACC_M];
+    random_binary_series(src, ACC_N * ACC_M, 2040);
+    random_binary_series(back, ACC_N * ACC_M, 2041);
+    dst[0] = 0;
+    for (size_t i = 1; i < ACC_N * ACC_M; ++i)
+    {
+        dst[i] = src[i - 1] & back[i - 1];
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_transfer_entropy_acc(1, 2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+    for (size_t i = 0; i < ACC_N; ++i)
+    {
+        int const *streams[] = {
+            src + ACC_M * i, dst + ACC_M * i, back + ACC_M * i
+        };
+        memory_reader reader = { streams, 3, ACC_M, 0, 0 };
+        ASSERT_FALSE(inform_acc_read(acc, read_memory, &reader, 16, &err));
+        inform_acc_restart(acc);
+    }
+
+    // the second pass matches the local values of each whole series
+    int series[3 * ACC_M];
+    double expect[ACC_M], local[ACC_M];
+    for (size_t i = 0; i < ACC_N; ++i)
+    {
+        int const *streams[] = {
+            src + ACC_M * i, dst + ACC_M * i, back + ACC_M * i
+        };
+        for (size_t s = 0; s < 3; ++s)
+        {
+            memcpy(series + ACC_M * s, streams[s], ACC_M * sizeof(int));
+        }
+        ASSERT_NOT_NULL(inform_acc_local(acc, series, ACC_M, expect, &err));
+
+        size_t const chunks[] = { 16, 2, 1 };
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(size_t); ++c)
+        {
+            memory_reader reader = { streams, 3, ACC_M, 0, 0 };
+            memory_writer writer = { local, 0, ACC_M, 0 };
+            ASSERT_FALSE(inform_acc_read_local(acc, read_memory, &reader,
+                chunks[c], write_memory, &writer, &err));
+            ASSERT_EQUAL_U(ACC_M - 2, writer.n);
+            ASSERT_DBL_ARRAY_NEAR_TOL(expect, local, ACC_M - 2, ACC_TOL);
+        }
+    }
+    ASSERT_TRUE(inform_succeeded(&err));
+    inform_acc_free(acc);
+
+    // a series on disk is read once to count and once to emit local values
+    FILE *file = tmpfile();
+    ASSERT_NOT_NULL(file);
+    ASSERT_EQUAL_U(ACC_M, fwrite(src, sizeof(int), ACC_M, file));
+    rewind(file);
+    acc = inform_active_info_acc(2, 3, &err);
+    ASSERT_FALSE(inform_acc_read(acc, read_file, file, 10, &err));
+    rewind(file);
+    memory_writer writer = { local, 0, ACC_M, 0 };
+    ASSERT_FALSE(inform_acc_read_local(acc, read_file, file, 10, write_memory,
+        &writer, &err));
+    ASSERT_EQUAL_U(ACC_M - 3, writer.n);
+    ASSERT_NOT_NULL(inform_local_active_info(src, 1, ACC_M, 2, 3, expect,
+        &err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, local, ACC_M - 3, ACC_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    inform_acc_free(acc);
+    fclose(file);
+}
+
+UNIT(ReadLocalErrors)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_acc *acc = inform_active_info_acc(2, 2, &err);
+    ASSERT_NOT_NULL(acc);
+
+    int const series[] = { 0, 1, 1, 0, 1, 0, 0, 1 };
+    int const *streams[] = { series };
+    memory_reader reader = { streams, 1, 8, 0, 0 };
+    size_t calls = 0;
+
+    // the local values are relative to the observations accumulated
+    ASSERT_TRUE(inform_acc_read_local(acc, read_memory, &reader, 4,
+        write_failure, &calls, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+    ASSERT_FALSE(inform_acc_read(acc, read_memory, &reader, 4, &err));
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_read_local(NULL, read_memory, &reader, 4,
+        write_failure, &calls, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_TRUE(inform_acc_read_local(acc, NULL, &reader, 4, write_failure,
+        &calls, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_TRUE(inform_acc_read_local(acc, read_memory, &reader, 4, NULL,
+        &calls, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_TRUE(inform_acc_read_local(acc, read_memory, &reader, 0,
+        write_failure, &calls, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_EQUAL_U(0, calls);
+
+    // reading stops as soon as the writer fails
+    err = INFORM_SUCCESS;
+    reader = (memory_reader){ streams, 1, 8, 0, 0 };
+    ASSERT_TRUE(inform_acc_read_local(acc, read_memory, &reader, 4,
+        write_failure, &calls, &err));
+    ASSERT_EQUAL(INFORM_EIO, err);
+    ASSERT_EQUAL_U(1, calls);
+    ASSERT_EQUAL_U(1, reader.calls);
+
+    err = INFORM_SUCCESS;
+    calls = 0;
+    double local[8];
+    memory_writer writer = { local, 0, 8, 0 };
+    ASSERT_TRUE(inform_acc_read_local(acc, read_failure, &calls, 4,
+        write_memory, &writer, &err));
+    ASSERT_EQUAL(INFORM_EIO, err);
+    ASSERT_EQUAL_U(1, writer.n);
+
+    err = INFORM_SUCCESS;
+    ASSERT_TRUE(inform_acc_read_local(acc, read_too_much, NULL, 4,
+        write_memory, &writer, &err));
+    ASSERT_EQUAL(INFORM_ESIZE, err);
+
+    int const bad[] = { 0, 1, 2, 1 };
+    int const *bad_streams[] = { bad };
+    reader = (memory_reader){ bad_streams, 1, 4, 0, 0 };
+    err = INFORM_SUCCESS;
+    writer.n = 0;
+    ASSERT_TRUE(inform_acc_read_local(acc, read_memory, &reader, 4,
+        write_memory, &writer, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    ASSERT_EQUAL_U(0, writer.n);
+
+    inform_acc_free(acc);
+}
+
+BEGIN_SUITE(Accumulator)
+    ADD_UNIT(ActiveInfoChunked)
+    ADD_UNIT(EntropyRateChunked)
+    ADD_UNIT(BlockEntropyChunked)
+    ADD_UNIT(PredictiveInfoChunked)
+    ADD_UNIT(TransferEntropyChunked)
+    ADD_UNIT(MutualInfoChunked)
+    ADD_UNIT(Merge)
+    ADD_UNIT(MergeIncompatible)
+    ADD_UNIT(Local)
+    ADD_UNIT(Errors)
+    ADD_UNIT(SerializeResume)
+    ADD_UNIT(SerializeMalformed)
+    ADD_UNIT(SaveLoad)
+    ADD_UNIT(ReadChunks)
+    ADD_UNIT(ReadErrors)
+    ADD_UNIT(ReadLocal)
+    ADD_UNIT(ReadLocalErrors)
+END_SUITE
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/engine.h>
 #include <inform/active_info.h>
 #include <math.h>
 #include <ginger/unit.h>
@@ -385,6 +386,150 @@ UNIT(LocalActiveInfoEnsemble_Base4)
     }
 }
 
+UNIT(ActiveInfoSparseSupport)
+{
+    // a binary series analyzed as if it were base-4 has a support far too
+    // large to store densely, but the same statistics as in base-2
+    int series[600];
+    random_binary_series(series, 600, 17);
+
+    double dense[576], sparse[576];
+    inform_error err = INFORM_SUCCESS;
+    double expect = inform_active_info(series, 2, 300, 2, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    double got = inform_active_info(series, 2, 300, 4, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 1e-10);
+
+    ASSERT_NOT_NULL(inform_local_active_info(series, 2, 300, 2, 12, dense, &err));
+    ASSERT_NOT_NULL(inform_local_active_info(series, 2, 300, 4, 12, sparse, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(dense, sparse, 576, 1e-10);
+}
+
+UNIT(ActiveInfoLongHistory)
+{
+    int series[300];
+    for (size_t i = 0; i < 300; ++i) series[i] = (int[]){0,1,1,0,1}[i % 5];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.970951, inform_active_info(series, 1, 300, 2, 40, &err), 1e-6);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double ai[260];
+    ASSERT_NOT_NULL(inform_local_active_info(series, 1, 300, 2, 40, ai, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.970951, AVERAGE(ai), 1e-6);
+
+    ASSERT_TRUE(isnan(inform_active_info(series, 1, 300, 2, 63, &err)));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(ActiveInfoSweep)
+{
+    int series[600];
+    random_binary_series(series, 600, 31);
+    for (size_t i = 1; i < 600; ++i)
+    {
+        series[i] = (i % 5 == 0) ? series[i] : series[i - 1] ^ series[i];
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    size_t const kmax = 9;
+    double *ai = inform_active_info_sweep(series, 3, 200, 2, kmax, NULL, &err);
+    ASSERT_NOT_NULL(ai);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t k = 1; k <= kmax; ++k)
+    {
+        ASSERT_DBL_NEAR_TOL(inform_active_info(series, 3, 200, 2, k, &err), ai[k - 1],
+            1e-10);
+    }
+    free(ai);
+
+    ASSERT_NULL(inform_active_info_sweep(series, 3, 200, 2, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_active_info_sweep(series, 75, 8, 2, 8, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    ASSERT_NULL(inform_active_info_sweep(NULL, 3, 200, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(ActiveInfoValidatesWhileCounting)
+{
+    // the states are validated as they are counted, by every engine, and the
+    // first invalid state is the one reported
+    inform_engine const engines[] = {
+        INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE, INFORM_ENGINE_SORT
+    };
+    size_t const positions[] = {0, 2, 3, 9, 10, 19};
+    int series[20] = {0};
+    double local[20];
+    inform_error err = INFORM_SUCCESS;
+    for (size_t e = 0; e < 3; ++e)
+    {
+        inform_set_engine(engines[e]);
+        for (size_t p = 0; p < sizeof(positions) / sizeof(size_t); ++p)
+        {
+            size_t const i = positions[p];
+            series[i] = -1;
+            ASSERT_NAN(inform_active_info(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_active_info(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+            series[i] = 2;
+            series[19 - i] = (i == 19 - i) ? 2 : -1;
+            ASSERT_NAN(inform_active_info(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_active_info(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            series[i] = series[19 - i] = 0;
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(inform_active_info(series, 2, 10, 2, 3, &err), 0.0, 1e-12);
+    ASSERT_TRUE(inform_succeeded(&err));
+}
+
+UNIT(ActiveInfoWindowed)
+{
+    int series[600], slice[600];
+    random_binary_series(series, 600, 61);
+    size_t const strides[3] = {1, 7, 40};
+    inform_error err = INFORM_SUCCESS;
+    for (size_t s = 0; s < 3; ++s)
+    {
+        size_t const window = 30, stride = strides[s];
+        size_t const count = (200 - window) / stride + 1;
+        double *values = inform_active_info_windowed(series, 3, 200, 2, 2, window,
+            stride, NULL, &err);
+        ASSERT_NOT_NULL(values);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t w = 0; w < count; ++w)
+        {
+            window_slice(series, 3, 200, w * stride, window, slice);
+            ASSERT_DBL_NEAR_TOL(inform_active_info(slice, 3, window, 2, 2, &err),
+                values[w], 1e-10);
+        }
+        free(values);
+    }
+
+    ASSERT_NULL(inform_active_info_windowed(series, 3, 200, 2, 2, 2, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_active_info_windowed(series, 3, 200, 2, 2, 201, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_active_info_windowed(series, 3, 200, 2, 2, 30, 0, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    series[599] = 2;
+    ASSERT_NULL(inform_active_info_windowed(series, 3, 200, 2, 2, 30, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
 BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(ActiveInfoSeriesNULLSeries)
     ADD_UNIT(ActiveInfoSeriesNoInits)
@@ -412,4 +557,9 @@ BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(LocalActiveInfoSingleSeries_Base4)
     ADD_UNIT(LocalActiveInfoEnsemble)
     ADD_UNIT(LocalActiveInfoEnsemble_Base4)
+    ADD_UNIT(ActiveInfoSparseSupport)
+    ADD_UNIT(ActiveInfoLongHistory)
+    ADD_UNIT(ActiveInfoSweep)
+    ADD_UNIT(ActiveInfoValidatesWhileCounting)
+    ADD_UNIT(ActiveInfoWindowed)
 END_SUITE
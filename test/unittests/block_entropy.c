@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/engine.h>
 #include <inform/block_entropy.h>
 #include <math.h>
 #include <ginger/unit.h>
@@ -385,6 +386,104 @@ UNIT(LocalBlockEntropyEnsemble_Base4)
     }
 }
 
+UNIT(BlockEntropySparseSupport)
+{
+    int series[600];
+    random_binary_series(series, 600, 29);
+
+    double dense[578], sparse[578];
+    inform_error err = INFORM_SUCCESS;
+    double expect = inform_block_entropy(series, 2, 300, 2, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    double got = inform_block_entropy(series, 2, 300, 4, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 1e-10);
+
+    ASSERT_NOT_NULL(inform_local_block_entropy(series, 2, 300, 2, 12, dense, &err));
+    ASSERT_NOT_NULL(inform_local_block_entropy(series, 2, 300, 4, 12, sparse, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(dense, sparse, 578, 1e-10);
+}
+
+UNIT(BlockEntropyLongBlocks)
+{
+    int series[300];
+    for (size_t i = 0; i < 300; ++i) series[i] = (int[]){0,1,1,0,1}[i % 5];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(log2(5.0), inform_block_entropy(series, 1, 299, 2, 40, &err), 1e-6);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double be[260];
+    ASSERT_NOT_NULL(inform_local_block_entropy(series, 1, 299, 2, 40, be, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(log2(5.0), AVERAGE(be), 1e-6);
+
+    ASSERT_TRUE(isnan(inform_block_entropy(series, 1, 300, 2, 64, &err)));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(BlockEntropyLargeCounts)
+{
+    // counts beyond the reach of the logarithm table
+    size_t const m = 3 << 20;
+    int *series = malloc(m * sizeof(int));
+    double *be = malloc(m * sizeof(double));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(be);
+    for (size_t i = 0; i < m; ++i) series[i] = i % 2;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(1.0, inform_block_entropy(series, 1, m, 2, 1, &err), 1e-12);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    ASSERT_NOT_NULL(inform_local_block_entropy(series, 1, m, 2, 1, be, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(1.0, be[0], 1e-12);
+    ASSERT_DBL_NEAR_TOL(1.0, be[m - 1], 1e-12);
+
+    free(be);
+    free(series);
+}
+
+UNIT(BlockEntropyValidatesWhileCounting)
+{
+    // the states are validated as they are counted, by every engine, and the
+    // first invalid state is the one reported
+    inform_engine const engines[] = {
+        INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE, INFORM_ENGINE_SORT
+    };
+    size_t const positions[] = {0, 2, 3, 9, 10, 19};
+    int series[20] = {0};
+    double local[20];
+    inform_error err = INFORM_SUCCESS;
+    for (size_t e = 0; e < 3; ++e)
+    {
+        inform_set_engine(engines[e]);
+        for (size_t p = 0; p < sizeof(positions) / sizeof(size_t); ++p)
+        {
+            size_t const i = positions[p];
+            series[i] = -1;
+            ASSERT_NAN(inform_block_entropy(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_block_entropy(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+            series[i] = 2;
+            series[19 - i] = (i == 19 - i) ? 2 : -1;
+            ASSERT_NAN(inform_block_entropy(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_block_entropy(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            series[i] = series[19 - i] = 0;
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(inform_block_entropy(series, 2, 10, 2, 3, &err), 0.0, 1e-12);
+    ASSERT_TRUE(inform_succeeded(&err));
+}
+
 BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(BlockEntropyNULLSeries)
     ADD_UNIT(BlockEntropyNoInits)
@@ -411,4 +510,8 @@ BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(LocalBlockEntropySingleSeries_Base4)
     ADD_UNIT(LocalBlockEntropyEnsemble)
     ADD_UNIT(LocalBlockEntropyEnsemble_Base4)
+    ADD_UNIT(BlockEntropySparseSupport)
+    ADD_UNIT(BlockEntropyLongBlocks)
+    ADD_UNIT(BlockEntropyLargeCounts)
+    ADD_UNIT(BlockEntropyValidatesWhileCounting)
 END_SUITE
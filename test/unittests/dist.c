@@ -3,6 +3,8 @@
 // license that can be found in the LICENSE file.
 #include <ginger/unit.h>
 #include <inform/dist.h>
+#include <inform/engine.h>
+#include <stdio.h>
 
 UNIT(AllocZero)
 {
@@ -539,6 +541,323 @@ UNIT(Accumulate)
     inform_dist_free(dist);
 }
 
+UNIT(AccumulateLarge)
+{
+    size_t const n = 300000;
+    int *events = malloc(n * sizeof(int));
+    uint32_t expect[7] = {0};
+    ASSERT_NOT_NULL(events);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < n; ++i)
+    {
+        state = 1664525 * state + 1013904223;
+        // long runs of the same event interspersed with others
+        events[i] = (state >> 28) < 12 ? 0 : (int) ((state >> 8) % 7);
+    }
+
+    for (size_t threads = 1; threads <= 4; threads *= 4)
+    {
+        inform_set_num_threads(threads);
+        inform_dist *dist = inform_dist_alloc(7);
+        ASSERT_NOT_NULL(dist);
+        ASSERT_EQUAL_U(n, inform_dist_accumulate(dist, events, n));
+        ASSERT_EQUAL_U(n, inform_dist_counts(dist));
+        for (size_t i = 0; i < 7; ++i) expect[i] = 0;
+        for (size_t i = 0; i < n; ++i) expect[events[i]]++;
+        for (size_t i = 0; i < 7; ++i)
+        {
+            ASSERT_EQUAL_U(expect[i], inform_dist_get(dist, i));
+        }
+        inform_dist_free(dist);
+    }
+    inform_set_num_threads(1);
+
+    size_t const invalid[] = {0, 31, 32, 1000, 250001, n - 1};
+    for (size_t k = 0; k < sizeof(invalid) / sizeof(size_t); ++k)
+    {
+        for (int bad = -1; bad <= 7; bad += 8)
+        {
+            int const saved = events[invalid[k]];
+            events[invalid[k]] = bad;
+            inform_dist *dist = inform_dist_alloc(7);
+            ASSERT_NOT_NULL(dist);
+            ASSERT_EQUAL_U(invalid[k], inform_dist_accumulate(dist, events, n));
+            ASSERT_EQUAL_U(invalid[k], inform_dist_counts(dist));
+            inform_dist_free(dist);
+            events[invalid[k]] = saved;
+        }
+    }
+
+    free(events);
+}
+
+UNIT(Merge)
+{
+    inform_dist *a = inform_dist_create((uint32_t[]){1, 2, 3}, 3);
+    inform_dist *b = inform_dist_create((uint32_t[]){4, 0, 6}, 3);
+    inform_dist *c = inform_dist_create((uint32_t[]){1, 2}, 2);
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(b);
+    ASSERT_NOT_NULL(c);
+
+    ASSERT_NULL(inform_dist_merge(NULL, a));
+    ASSERT_NULL(inform_dist_merge(a, NULL));
+    ASSERT_NULL(inform_dist_merge(c, a));
+
+    ASSERT_TRUE(a == inform_dist_merge(b, a));
+    ASSERT_EQUAL(5, inform_dist_get(a, 0));
+    ASSERT_EQUAL(2, inform_dist_get(a, 1));
+    ASSERT_EQUAL(9, inform_dist_get(a, 2));
+    ASSERT_EQUAL(16, inform_dist_counts(a));
+
+    inform_dist_set(b, 1, UINT32_MAX);
+    ASSERT_NULL(inform_dist_merge(b, a));
+    ASSERT_EQUAL(2, inform_dist_get(a, 1));
+    ASSERT_EQUAL(16, inform_dist_counts(a));
+
+    inform_dist_free(c);
+    inform_dist_free(b);
+    inform_dist_free(a);
+}
+
+UNIT(MergeLarge)
+{
+    size_t const size = 1003;
+    inform_dist *a = inform_dist_alloc(size);
+    inform_dist *b = inform_dist_alloc(size);
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(b);
+    for (size_t i = 0; i < size; ++i)
+    {
+        inform_dist_set(a, i, (uint32_t) (3 * i));
+        inform_dist_set(b, i, (uint32_t) (i % 7));
+    }
+
+    ASSERT_TRUE(a == inform_dist_merge(b, a));
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSERT_EQUAL_U(3 * i + i % 7, inform_dist_get(a, i));
+    }
+    ASSERT_TRUE(a == inform_dist_subtract(b, a));
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSERT_EQUAL_U(3 * i, inform_dist_get(a, i));
+    }
+
+    // an overflow in the very last bin leaves everything untouched
+    inform_dist_set(b, size - 1, UINT32_MAX);
+    ASSERT_NULL(inform_dist_merge(b, a));
+    inform_dist_set(b, size - 1, 1);
+    inform_dist_set(b, 517, UINT32_MAX);
+    ASSERT_NULL(inform_dist_merge(b, a));
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSERT_EQUAL_U(3 * i, inform_dist_get(a, i));
+    }
+
+    inform_dist_free(b);
+    inform_dist_free(a);
+}
+
+UNIT(Subtract)
+{
+    inform_dist *a = inform_dist_create((uint32_t[]){5, 2, 9}, 3);
+    inform_dist *b = inform_dist_create((uint32_t[]){4, 0, 6}, 3);
+    inform_dist *c = inform_dist_create((uint32_t[]){1, 2}, 2);
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(b);
+    ASSERT_NOT_NULL(c);
+
+    ASSERT_NULL(inform_dist_subtract(NULL, a));
+    ASSERT_NULL(inform_dist_subtract(a, NULL));
+    ASSERT_NULL(inform_dist_subtract(c, a));
+
+    ASSERT_TRUE(a == inform_dist_subtract(b, a));
+    ASSERT_EQUAL(1, inform_dist_get(a, 0));
+    ASSERT_EQUAL(2, inform_dist_get(a, 1));
+    ASSERT_EQUAL(3, inform_dist_get(a, 2));
+    ASSERT_EQUAL(6, inform_dist_counts(a));
+
+    ASSERT_NULL(inform_dist_subtract(b, a));
+    ASSERT_EQUAL(1, inform_dist_get(a, 0));
+    ASSERT_EQUAL(6, inform_dist_counts(a));
+
+    inform_dist_free(c);
+    inform_dist_free(b);
+    inform_dist_free(a);
+}
+
+UNIT(ScatterGather)
+{
+    size_t const n = 200000;
+    int *events = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(events);
+    for (size_t i = 0; i < n; ++i)
+    {
+        events[i] = (int) ((i * i + 3 * i) % 5);
+    }
+
+    inform_dist *whole = inform_dist_alloc(5);
+    ASSERT_NOT_NULL(whole);
+    ASSERT_EQUAL_U(n, inform_dist_accumulate(whole, events, n));
+
+    for (size_t threads = 1; threads <= 3; threads += 2)
+    {
+        inform_set_num_threads(threads);
+        inform_dist *parts[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            parts[i] = inform_dist_alloc(5);
+            ASSERT_NOT_NULL(parts[i]);
+        }
+        ASSERT_EQUAL_U(n, inform_dist_scatter(events, n, parts, 4));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            ASSERT_EQUAL_U(n / 4, inform_dist_counts(parts[i]));
+        }
+
+        inform_dist *sum = inform_dist_alloc(5);
+        ASSERT_NOT_NULL(sum);
+        ASSERT_TRUE(sum == inform_dist_gather(parts, 4, sum));
+        ASSERT_EQUAL_U(n, inform_dist_counts(sum));
+        for (size_t i = 0; i < 5; ++i)
+        {
+            ASSERT_EQUAL_U(inform_dist_get(whole, i), inform_dist_get(sum, i));
+        }
+
+        inform_dist_set(parts[3], 0, UINT32_MAX);
+        ASSERT_NULL(inform_dist_gather(parts, 4, sum));
+        ASSERT_EQUAL_U(n, inform_dist_counts(sum));
+        for (size_t i = 0; i < 5; ++i)
+        {
+            ASSERT_EQUAL_U(inform_dist_get(whole, i), inform_dist_get(sum, i));
+        }
+
+        inform_dist_free(sum);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            inform_dist_free(parts[i]);
+        }
+    }
+    inform_set_num_threads(1);
+
+    inform_dist *parts[2] = { inform_dist_alloc(5), inform_dist_alloc(4) };
+    ASSERT_NOT_NULL(parts[0]);
+    ASSERT_NOT_NULL(parts[1]);
+    ASSERT_EQUAL_U(0, inform_dist_scatter(events, n, parts, 2));
+    ASSERT_EQUAL_U(0, inform_dist_scatter(events, n, parts, 0));
+    ASSERT_NULL(inform_dist_gather(parts, 2, whole));
+    inform_dist_free(parts[1]);
+
+    parts[1] = inform_dist_alloc(5);
+    ASSERT_NOT_NULL(parts[1]);
+    events[1001] = 5;
+    ASSERT_EQUAL_U(1001, inform_dist_scatter(events, n, parts, 2));
+    ASSERT_EQUAL_U(500, inform_dist_counts(parts[0]));
+    ASSERT_EQUAL_U(501, inform_dist_counts(parts[1]));
+
+    inform_dist_free(parts[1]);
+    inform_dist_free(parts[0]);
+    inform_dist_free(whole);
+    free(events);
+}
+
+UNIT(Serialize)
+{
+    inform_dist *dist = inform_dist_create((uint32_t[]){3, 0, 300, 1, 70000}, 5);
+    ASSERT_NOT_NULL(dist);
+
+    size_t const n = inform_dist_serialize(dist, NULL, 0);
+    ASSERT_TRUE(n > 8);
+    uint8_t *buffer = malloc(n + 4);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_EQUAL_U(n, inform_dist_serialize(dist, buffer, n - 1));
+    ASSERT_EQUAL_U(n, inform_dist_serialize(dist, buffer, n + 4));
+
+    size_t used = 0;
+    inform_dist *copy = inform_dist_deserialize(buffer, n + 4, &used);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_EQUAL_U(n, used);
+    ASSERT_EQUAL_U(inform_dist_size(dist), inform_dist_size(copy));
+    ASSERT_EQUAL_U(inform_dist_counts(dist), inform_dist_counts(copy));
+    for (size_t i = 0; i < 5; ++i)
+    {
+        ASSERT_EQUAL_U(inform_dist_get(dist, i), inform_dist_get(copy, i));
+    }
+    inform_dist_free(copy);
+
+    // every truncation and every single-byte corruption of the header is
+    // rejected
+    for (size_t i = 0; i < n; ++i)
+    {
+        ASSERT_NULL(inform_dist_deserialize(buffer, i, NULL));
+    }
+    for (size_t i = 0; i < 5; ++i)
+    {
+        buffer[i] ^= 0x10;
+        ASSERT_NULL(inform_dist_deserialize(buffer, n, NULL));
+        buffer[i] ^= 0x10;
+    }
+    // a count which disagrees with the total is rejected
+    buffer[n - 1] ^= 0x01;
+    ASSERT_NULL(inform_dist_deserialize(buffer, n, NULL));
+
+    ASSERT_EQUAL_U(0, inform_dist_serialize(NULL, buffer, n));
+    ASSERT_NULL(inform_dist_deserialize(NULL, n, NULL));
+
+    free(buffer);
+    inform_dist_free(dist);
+}
+
+UNIT(SerializeSparse)
+{
+    size_t const size = 1 << 20;
+    inform_dist *dist = inform_dist_alloc(size);
+    ASSERT_NOT_NULL(dist);
+    size_t const n = inform_dist_serialize(dist, NULL, 0);
+    // an empty distribution takes a handful of bytes, not one per bin
+    ASSERT_TRUE(n < 16);
+
+    inform_dist_set(dist, 17, 5);
+    inform_dist_set(dist, 1000, 1);
+    inform_dist_set(dist, size - 1, 123456);
+    uint8_t buffer[64];
+    size_t const m = inform_dist_serialize(dist, buffer, sizeof(buffer));
+    ASSERT_TRUE(m < 32);
+
+    inform_dist *copy = inform_dist_deserialize(buffer, m, NULL);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_EQUAL_U(size, inform_dist_size(copy));
+    ASSERT_EQUAL_U(123462, inform_dist_counts(copy));
+    ASSERT_EQUAL_U(5, inform_dist_get(copy, 17));
+    ASSERT_EQUAL_U(1, inform_dist_get(copy, 1000));
+    ASSERT_EQUAL_U(123456, inform_dist_get(copy, size - 1));
+    inform_dist_free(copy);
+    inform_dist_free(dist);
+}
+
+UNIT(SaveLoad)
+{
+    char const *path = "inform_dist_save_load.bin";
+    inform_dist *dist = inform_dist_create((uint32_t[]){1, 2, 3, 0}, 4);
+    ASSERT_NOT_NULL(dist);
+    ASSERT_EQUAL_U(inform_dist_serialize(dist, NULL, 0),
+        inform_dist_save(dist, path));
+
+    inform_dist *copy = inform_dist_load(path);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_EQUAL_U(6, inform_dist_counts(copy));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQUAL_U(inform_dist_get(dist, i), inform_dist_get(copy, i));
+    }
+    remove(path);
+    ASSERT_NULL(inform_dist_load(path));
+
+    inform_dist_free(copy);
+    inform_dist_free(dist);
+}
+
 BEGIN_SUITE(Distribution)
     ADD_UNIT(AllocZero)
     ADD_UNIT(AllocOne)
@@ -565,4 +884,12 @@ BEGIN_SUITE(Distribution)
     ADD_UNIT(Prob)
     ADD_UNIT(Dump)
     ADD_UNIT(Accumulate)
+    ADD_UNIT(AccumulateLarge)
+    ADD_UNIT(Merge)
+    ADD_UNIT(MergeLarge)
+    ADD_UNIT(Subtract)
+    ADD_UNIT(ScatterGather)
+    ADD_UNIT(Serialize)
+    ADD_UNIT(SerializeSparse)
+    ADD_UNIT(SaveLoad)
 END_SUITE
@@ -0,0 +1,297 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/engine.h>
+#include <inform/entropy_rate.h>
+#include <inform/mutual_info.h>
+#include <inform/predictive_info.h>
+#include <inform/transfer_entropy.h>
+#include "util.h"
+
+#define ENGINE_TOL 1e-10
+
+static inform_engine const engines[] = {
+    INFORM_ENGINE_AUTO, INFORM_ENGINE_SPARSE, INFORM_ENGINE_SORT
+};
+#define NUM_ENGINES (sizeof(engines) / sizeof(inform_engine))
+
+static void random_ternary_series(int *series, size_t n, uint32_t seed)
+{
+    int *bits = malloc(2 * n * sizeof(int));
+    random_binary_series(bits, 2 * n, seed);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = bits[i] + bits[n + i];
+    }
+    free(bits);
+}
+
+UNIT(EngineDefault)
+{
+    ASSERT_EQUAL(INFORM_ENGINE_AUTO, inform_get_engine());
+}
+
+UNIT(EngineSetAndGet)
+{
+    inform_set_engine(INFORM_ENGINE_SORT);
+    ASSERT_EQUAL(INFORM_ENGINE_SORT, inform_get_engine());
+    inform_set_engine((inform_engine) 42);
+    ASSERT_EQUAL(INFORM_ENGINE_SORT, inform_get_engine());
+    inform_set_engine(INFORM_ENGINE_DENSE);
+    ASSERT_EQUAL(INFORM_ENGINE_DENSE, inform_get_engine());
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    ASSERT_EQUAL(INFORM_ENGINE_AUTO, inform_get_engine());
+}
+
+UNIT(EngineActiveInfo)
+{
+    int series[600];
+    random_ternary_series(series, 600, 11);
+
+    inform_error err = INFORM_SUCCESS;
+    for (size_t k = 1; k <= 8; ++k)
+    {
+        inform_set_engine(INFORM_ENGINE_DENSE);
+        double expect = inform_active_info(series, 3, 200, 3, k, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < NUM_ENGINES; ++i)
+        {
+            inform_set_engine(engines[i]);
+            double got = inform_active_info(series, 3, 200, 3, k, &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            ASSERT_DBL_NEAR_TOL(expect, got, ENGINE_TOL);
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EngineBlockEntropy)
+{
+    int series[600];
+    random_ternary_series(series, 600, 13);
+
+    inform_error err = INFORM_SUCCESS;
+    for (size_t k = 1; k <= 8; ++k)
+    {
+        inform_set_engine(INFORM_ENGINE_DENSE);
+        double expect = inform_block_entropy(series, 3, 200, 3, k, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < NUM_ENGINES; ++i)
+        {
+            inform_set_engine(engines[i]);
+            double got = inform_block_entropy(series, 3, 200, 3, k, &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            ASSERT_DBL_NEAR_TOL(expect, got, ENGINE_TOL);
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EngineEntropyRate)
+{
+    int series[600];
+    random_ternary_series(series, 600, 17);
+
+    inform_error err = INFORM_SUCCESS;
+    for (size_t k = 1; k <= 8; ++k)
+    {
+        inform_set_engine(INFORM_ENGINE_DENSE);
+        double expect = inform_entropy_rate(series, 3, 200, 3, k, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < NUM_ENGINES; ++i)
+        {
+            inform_set_engine(engines[i]);
+            double got = inform_entropy_rate(series, 3, 200, 3, k, &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            ASSERT_DBL_NEAR_TOL(expect, got, ENGINE_TOL);
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EnginePredictiveInfo)
+{
+    int series[600];
+    random_ternary_series(series, 600, 19);
+
+    inform_error err = INFORM_SUCCESS;
+    for (size_t kpast = 1; kpast <= 4; ++kpast)
+    {
+        for (size_t kfuture = 1; kfuture <= 4; ++kfuture)
+        {
+            inform_set_engine(INFORM_ENGINE_DENSE);
+            double expect = inform_predictive_info(series, 3, 200, 3, kpast,
+                kfuture, &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            for (size_t i = 0; i < NUM_ENGINES; ++i)
+            {
+                inform_set_engine(engines[i]);
+                double got = inform_predictive_info(series, 3, 200, 3, kpast,
+                    kfuture, &err);
+                ASSERT_TRUE(inform_succeeded(&err));
+                ASSERT_DBL_NEAR_TOL(expect, got, ENGINE_TOL);
+            }
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EngineTransferEntropy)
+{
+    int series[1800];
+    random_ternary_series(series, 1800, 23);
+    int const *src = series, *dst = series + 600, *back = series + 1200;
+
+    inform_error err = INFORM_SUCCESS;
+    for (size_t l = 0; l <= 1; ++l)
+    {
+        for (size_t k = 1; k <= 6; ++k)
+        {
+            inform_set_engine(INFORM_ENGINE_DENSE);
+            double expect = inform_transfer_entropy(src, dst, back, l, 3, 200,
+                3, k, &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            for (size_t i = 0; i < NUM_ENGINES; ++i)
+            {
+                inform_set_engine(engines[i]);
+                double got = inform_transfer_entropy(src, dst, back, l, 3, 200,
+                    3, k, &err);
+                ASSERT_TRUE(inform_succeeded(&err));
+                ASSERT_DBL_NEAR_TOL(expect, got, ENGINE_TOL);
+            }
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EngineLocalFallsBack)
+{
+    int series[600];
+    random_ternary_series(series, 600, 29);
+
+    double expect[594], got[594];
+    inform_error err = INFORM_SUCCESS;
+    inform_set_engine(INFORM_ENGINE_DENSE);
+    ASSERT_NOT_NULL(inform_local_active_info(series, 3, 200, 3, 2, expect, &err));
+    inform_set_engine(INFORM_ENGINE_SORT);
+    ASSERT_NOT_NULL(inform_local_active_info(series, 3, 200, 3, 2, got, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, 594, ENGINE_TOL);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(EngineNumThreads)
+{
+    ASSERT_EQUAL_U(1, inform_get_num_threads());
+    inform_set_num_threads(4);
+    ASSERT_EQUAL_U(4, inform_get_num_threads());
+    inform_set_num_threads(0);
+    ASSERT_EQUAL_U(4, inform_get_num_threads());
+    inform_set_num_threads(1);
+    ASSERT_EQUAL_U(1, inform_get_num_threads());
+}
+
+UNIT(EngineThreadedMutualInfo)
+{
+    size_t const m = 1 << 18;
+    int *series = malloc(2 * m * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    random_ternary_series(series, 2 * m, 17);
+
+    inform_error err = INFORM_SUCCESS;
+    double const expect = inform_mutual_info(series, 2, m, (int[]){3, 3}, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_set_num_threads(4);
+    double const got = inform_mutual_info(series, 2, m, (int[]){3, 3}, &err);
+    inform_set_num_threads(1);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 0.0);
+
+    free(series);
+}
+
+/**
+ * Compute each time series measure of an ensemble serially and on 4 threads,
+ * which split the initial conditions if there are at least 4 of them and
+ * the time series otherwise
+ */
+static void assert_threads_agree(int const *series, size_t n, size_t m,
+    double tol)
+{
+    int const *src = series, *dst = series + n * m, *back = series + 2 * n * m;
+    double expect[6], got[6];
+    inform_error err = INFORM_SUCCESS;
+    for (size_t t = 0; t < 2; ++t)
+    {
+        double *values = (t == 0) ? expect : got;
+        inform_set_num_threads((t == 0) ? 1 : 4);
+        values[0] = inform_active_info(dst, n, m, 3, 4, &err);
+        values[1] = inform_block_entropy(dst, n, m, 3, 5, &err);
+        values[2] = inform_entropy_rate(dst, n, m, 3, 4, &err);
+        values[3] = inform_predictive_info(dst, n, m, 3, 3, 2, &err);
+        values[4] = inform_transfer_entropy(src, dst, NULL, 0, n, m, 3, 3,
+            &err);
+        values[5] = inform_transfer_entropy(src, dst, back, 1, n, m, 3, 2,
+            &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+    }
+    inform_set_num_threads(1);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, 6, tol);
+}
+
+UNIT(EngineThreadedTimeSeries)
+{
+    size_t const N = 1 << 18;
+    int *series = malloc(3 * N * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    random_ternary_series(series, 3 * N, 31);
+
+    assert_threads_agree(series, 16, N / 16, 0.0);
+    assert_threads_agree(series, 2, N / 2, 0.0);
+    assert_threads_agree(series, 1, N, 0.0);
+    inform_set_engine(INFORM_ENGINE_SPARSE);
+    assert_threads_agree(series, 3, N / 3, ENGINE_TOL);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+
+    double *expect = malloc(2 * N * sizeof(double)), *got = expect + N;
+    ASSERT_NOT_NULL(expect);
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(series, series + N, NULL, 0,
+        2, N / 2, 3, 2, expect, &err));
+    inform_set_num_threads(4);
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(series, series + N, NULL, 0,
+        2, N / 2, 3, 2, got, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, N - 4, 0.0);
+
+    // an invalid state read by any thread is reported as it would be serially
+    series[N - 10] = 3;
+    ASSERT_NAN(inform_active_info(series, 1, N, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    series[N - 10] = -1;
+    ASSERT_NAN(inform_transfer_entropy(series + N, series, NULL, 0, 4, N / 4,
+        3, 2, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    inform_set_num_threads(1);
+
+    free(expect);
+    free(series);
+}
+
+BEGIN_SUITE(Engine)
+    ADD_UNIT(EngineDefault)
+    ADD_UNIT(EngineSetAndGet)
+    ADD_UNIT(EngineActiveInfo)
+    ADD_UNIT(EngineBlockEntropy)
+    ADD_UNIT(EngineEntropyRate)
+    ADD_UNIT(EnginePredictiveInfo)
+    ADD_UNIT(EngineTransferEntropy)
+    ADD_UNIT(EngineLocalFallsBack)
+    ADD_UNIT(EngineNumThreads)
+    ADD_UNIT(EngineThreadedMutualInfo)
+    ADD_UNIT(EngineThreadedTimeSeries)
+END_SUITE
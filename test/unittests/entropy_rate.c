@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/engine.h>
 #include <inform/entropy_rate.h>
 #include <math.h>
 #include <ginger/unit.h>
@@ -388,6 +389,148 @@ UNIT(LocalEntropyRateEnsemble_Base4)
     }
 }
 
+UNIT(EntropyRateSparseSupport)
+{
+    int series[600];
+    random_binary_series(series, 600, 23);
+
+    double dense[576], sparse[576];
+    inform_error err = INFORM_SUCCESS;
+    double expect = inform_entropy_rate(series, 2, 300, 2, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    double got = inform_entropy_rate(series, 2, 300, 4, 12, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 1e-10);
+
+    ASSERT_NOT_NULL(inform_local_entropy_rate(series, 2, 300, 2, 12, dense, &err));
+    ASSERT_NOT_NULL(inform_local_entropy_rate(series, 2, 300, 4, 12, sparse, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(dense, sparse, 576, 1e-10);
+}
+
+UNIT(EntropyRateLongHistory)
+{
+    int series[300];
+    for (size_t i = 0; i < 300; ++i) series[i] = (int[]){0,1,1,0,1}[i % 5];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.0, inform_entropy_rate(series, 1, 300, 2, 50, &err), 1e-6);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double er[250];
+    ASSERT_NOT_NULL(inform_local_entropy_rate(series, 1, 300, 2, 50, er, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.0, AVERAGE(er), 1e-6);
+
+    ASSERT_TRUE(isnan(inform_entropy_rate(series, 1, 300, 2, 63, &err)));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(EntropyRateSweep)
+{
+    int series[600];
+    random_binary_series(series, 600, 31);
+    for (size_t i = 1; i < 600; ++i)
+    {
+        series[i] = (i % 5 == 0) ? series[i] : series[i - 1] ^ series[i];
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    size_t const kmax = 9;
+    double *er = inform_entropy_rate_sweep(series, 3, 200, 2, kmax, NULL, &err);
+    ASSERT_NOT_NULL(er);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t k = 1; k <= kmax; ++k)
+    {
+        ASSERT_DBL_NEAR_TOL(inform_entropy_rate(series, 3, 200, 2, k, &err), er[k - 1],
+            1e-10);
+    }
+    free(er);
+
+    ASSERT_NULL(inform_entropy_rate_sweep(series, 3, 200, 2, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_entropy_rate_sweep(series, 75, 8, 2, 8, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    ASSERT_NULL(inform_entropy_rate_sweep(NULL, 3, 200, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(EntropyRateValidatesWhileCounting)
+{
+    // the states are validated as they are counted, by every engine, and the
+    // first invalid state is the one reported
+    inform_engine const engines[] = {
+        INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE, INFORM_ENGINE_SORT
+    };
+    size_t const positions[] = {0, 2, 3, 9, 10, 19};
+    int series[20] = {0};
+    double local[20];
+    inform_error err = INFORM_SUCCESS;
+    for (size_t e = 0; e < 3; ++e)
+    {
+        inform_set_engine(engines[e]);
+        for (size_t p = 0; p < sizeof(positions) / sizeof(size_t); ++p)
+        {
+            size_t const i = positions[p];
+            series[i] = -1;
+            ASSERT_NAN(inform_entropy_rate(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_entropy_rate(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+            series[i] = 2;
+            series[19 - i] = (i == 19 - i) ? 2 : -1;
+            ASSERT_NAN(inform_entropy_rate(series, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            ASSERT_NULL(inform_local_entropy_rate(series, 2, 10, 2, 3, local, &err));
+            ASSERT_EQUAL((i < 10) ? INFORM_EBADSTATE : INFORM_ENEGSTATE, err);
+            series[i] = series[19 - i] = 0;
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(inform_entropy_rate(series, 2, 10, 2, 3, &err), 0.0, 1e-12);
+    ASSERT_TRUE(inform_succeeded(&err));
+}
+
+UNIT(EntropyRateWindowed)
+{
+    int series[600], slice[600];
+    random_binary_series(series, 600, 62);
+    size_t const strides[3] = {1, 7, 40};
+    inform_error err = INFORM_SUCCESS;
+    for (size_t s = 0; s < 3; ++s)
+    {
+        size_t const window = 30, stride = strides[s];
+        size_t const count = (200 - window) / stride + 1;
+        double *values = inform_entropy_rate_windowed(series, 3, 200, 2, 2, window,
+            stride, NULL, &err);
+        ASSERT_NOT_NULL(values);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t w = 0; w < count; ++w)
+        {
+            window_slice(series, 3, 200, w * stride, window, slice);
+            ASSERT_DBL_NEAR_TOL(inform_entropy_rate(slice, 3, window, 2, 2, &err),
+                values[w], 1e-10);
+        }
+        free(values);
+    }
+
+    ASSERT_NULL(inform_entropy_rate_windowed(series, 3, 200, 2, 2, 2, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_entropy_rate_windowed(series, 3, 200, 2, 2, 201, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_entropy_rate_windowed(series, 3, 200, 2, 2, 30, 0, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    series[599] = 2;
+    ASSERT_NULL(inform_entropy_rate_windowed(series, 3, 200, 2, 2, 30, 1, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
 BEGIN_SUITE(EntropyRate)
     ADD_UNIT(EntropyRateNULLSeries)
     ADD_UNIT(EntropyRateNoInits)
@@ -414,4 +557,9 @@ BEGIN_SUITE(EntropyRate)
     ADD_UNIT(LocalEntropyRateSingleSeries_Base4)
     ADD_UNIT(LocalEntropyRateEnsemble)
     ADD_UNIT(LocalEntropyRateEnsemble_Base4)
+    ADD_UNIT(EntropyRateSparseSupport)
+    ADD_UNIT(EntropyRateLongHistory)
+    ADD_UNIT(EntropyRateSweep)
+    ADD_UNIT(EntropyRateValidatesWhileCounting)
+    ADD_UNIT(EntropyRateWindowed)
 END_SUITE
@@ -0,0 +1,160 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/engine.h>
+#include <inform/entropy_rate.h>
+#include <inform/excess_entropy.h>
+#include <inform/fused.h>
+#include <inform/predictive_info.h>
+#include "util.h"
+
+#define FUSED_TOL 1e-10
+
+static inform_fused_spec const specs[] = {
+    { INFORM_FUSED_ACTIVE_INFO, 2, 0 },
+    { INFORM_FUSED_ENTROPY_RATE, 2, 0 },
+    { INFORM_FUSED_BLOCK_ENTROPY, 2, 0 },
+    { INFORM_FUSED_BLOCK_ENTROPY, 1, 0 },
+    { INFORM_FUSED_PREDICTIVE_INFO, 2, 3 },
+    { INFORM_FUSED_EXCESS_ENTROPY, 2, 0 },
+    { INFORM_FUSED_ACTIVE_INFO, 4, 0 },
+    { INFORM_FUSED_ENTROPY_RATE, 1, 0 },
+};
+#define NUM_SPECS (sizeof(specs) / sizeof(inform_fused_spec))
+
+static double expected(int const *series, size_t n, size_t m, int b,
+    inform_fused_spec const *spec, inform_error *err)
+{
+    switch (spec->measure)
+    {
+        case INFORM_FUSED_ACTIVE_INFO:
+            return inform_active_info(series, n, m, b, spec->k, err);
+        case INFORM_FUSED_BLOCK_ENTROPY:
+            return inform_block_entropy(series, n, m, b, spec->k, err);
+        case INFORM_FUSED_ENTROPY_RATE:
+            return inform_entropy_rate(series, n, m, b, spec->k, err);
+        case INFORM_FUSED_EXCESS_ENTROPY:
+            return inform_excess_entropy(series, n, m, b, spec->k, err);
+        default:
+            return inform_predictive_info(series, n, m, b, spec->k,
+                spec->kfuture, err);
+    }
+}
+
+static void assert_matches(int const *series, size_t n, size_t m, int b)
+{
+    inform_error err = INFORM_SUCCESS;
+    double *values = inform_fused_measures(series, n, m, b, specs, NUM_SPECS,
+        NULL, &err);
+    ASSERT_NOT_NULL(values);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t i = 0; i < NUM_SPECS; ++i)
+    {
+        double const expect = expected(series, n, m, b, specs + i, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(expect, values[i], FUSED_TOL);
+    }
+    free(values);
+}
+
+UNIT(FusedMatchesSeparate)
+{
+    int series[400];
+    random_binary_series(series, 400, 2018);
+    assert_matches(series, 1, 400, 2);
+    assert_matches(series, 4, 100, 2);
+    assert_matches(series, 50, 8, 2);
+}
+
+UNIT(FusedMatchesSeparateBase)
+{
+    int bits[800], series[400];
+    random_binary_series(bits, 800, 17);
+    for (size_t i = 0; i < 400; ++i)
+    {
+        series[i] = bits[i] + bits[400 + i];
+    }
+    assert_matches(series, 2, 200, 3);
+    // an unused state widens the support without changing the values
+    assert_matches(series, 2, 200, 4);
+}
+
+UNIT(FusedSparse)
+{
+    int series[600];
+    random_binary_series(series, 600, 5);
+    inform_set_engine(INFORM_ENGINE_SPARSE);
+    assert_matches(series, 3, 200, 2);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(FusedSingle)
+{
+    int series[9] = {0,0,1,1,1,1,0,0,0};
+    inform_error err = INFORM_SUCCESS;
+    double value = 0.0;
+    inform_fused_spec const spec = { INFORM_FUSED_ACTIVE_INFO, 2, 0 };
+    ASSERT_EQUAL_P(&value, inform_fused_measures(series, 1, 9, 2, &spec, 1,
+        &value, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.305958, value, 1e-6);
+}
+
+UNIT(FusedErrors)
+{
+    int series[8] = {0,1,1,0,1,0,0,1};
+    inform_fused_spec const ai = { INFORM_FUSED_ACTIVE_INFO, 2, 0 };
+    inform_error err = INFORM_SUCCESS;
+
+    ASSERT_NULL(inform_fused_measures(NULL, 1, 8, 2, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NULL(inform_fused_measures(series, 0, 8, 2, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOINITS, err);
+    ASSERT_NULL(inform_fused_measures(series, 1, 1, 2, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 1, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, NULL, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, &ai, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    inform_fused_spec bad[2] = { ai, { (inform_fused_measure) 42, 2, 0 } };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    bad[1] = (inform_fused_spec){ INFORM_FUSED_BLOCK_ENTROPY, 0, 0 };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    bad[1] = (inform_fused_spec){ INFORM_FUSED_PREDICTIVE_INFO, 2, 0 };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+
+    bad[1] = (inform_fused_spec){ INFORM_FUSED_ENTROPY_RATE, 8, 0 };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    bad[1] = (inform_fused_spec){ INFORM_FUSED_EXCESS_ENTROPY, 4, 0 };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    bad[1] = (inform_fused_spec){ INFORM_FUSED_PREDICTIVE_INFO, 3, 5 };
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, bad, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    series[5] = -1;
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    series[5] = 2;
+    ASSERT_NULL(inform_fused_measures(series, 1, 8, 2, &ai, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+BEGIN_SUITE(FusedMeasures)
+    ADD_UNIT(FusedMatchesSeparate)
+    ADD_UNIT(FusedMatchesSeparateBase)
+    ADD_UNIT(FusedSparse)
+    ADD_UNIT(FusedSingle)
+    ADD_UNIT(FusedErrors)
+END_SUITE
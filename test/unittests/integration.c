@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/integration.h>
+#include <inform/utilities/partitions.h>
 #include <inform/utilities/random.h>
 #include <ginger/unit.h>
 
@@ -304,6 +305,53 @@ UNIT(IntegrationEvidenceSynchronized)
     free(evidence);
 }
 
+UNIT(IntegrationEvidenceMatchesPartitions)
+{
+    srand(2025);
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 5;
+    size_t const n = 200;
+    int const bases[] = {2, 3, 2, 4, 2};
+    int series[5 * 200];
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            // correlate each series with the one before it
+            series[j + n*i] = (i != 0 && rand() % 3)
+                ? series[j + n*(i-1)] % bases[i]
+                : rand() % bases[i];
+        }
+    }
+
+    double evidence[2 * 200];
+    ASSERT_NOT_NULL(inform_integration_evidence(series, l, n, bases, evidence,
+        &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double minimum[200], maximum[200], lmi[2 * 200];
+    for (size_t i = 0; i < n; ++i)
+    {
+        minimum[i] = INFINITY;
+        maximum[i] = -INFINITY;
+    }
+    size_t *parts = inform_first_partitioning(l);
+    size_t nparts;
+    while ((nparts = inform_next_partitioning(parts, l)))
+    {
+        ASSERT_NOT_NULL(inform_integration_evidence_part(series, l, n, bases,
+            parts, nparts, lmi, &err));
+        for (size_t i = 0; i < n; ++i)
+        {
+            minimum[i] = (lmi[i] < minimum[i]) ? lmi[i] : minimum[i];
+            maximum[i] = (lmi[i] > maximum[i]) ? lmi[i] : maximum[i];
+        }
+    }
+    free(parts);
+    ASSERT_DBL_ARRAY_NEAR_TOL(minimum, evidence, n, 1e-10);
+    ASSERT_DBL_ARRAY_NEAR_TOL(maximum, evidence + n, n, 1e-10);
+}
+
 UNIT(IntegrationEvidencePartNULLSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -765,6 +813,7 @@ BEGIN_SUITE(Integration)
     ADD_UNIT(IntegrationEvidenceTwoSeries)
     ADD_UNIT(IntegrationEvidenceThreeSeries)
     ADD_UNIT(IntegrationEvidenceSynchronized)
+    ADD_UNIT(IntegrationEvidenceMatchesPartitions)
 
     ADD_UNIT(IntegrationEvidencePartNULLSeries)
     ADD_UNIT(IntegrationEvidencePartTooFewSeries)
@@ -0,0 +1,207 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/entropy_rate.h>
+#include <inform/local_summary.h>
+#include <inform/transfer_entropy.h>
+#include <math.h>
+#include "util.h"
+
+#define SUMMARY_TOL 1e-10
+
+UNIT(LocalSummaryAlloc)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_local_summary *summary = inform_local_summary_alloc(0, 0.0, 0.0,
+        &err);
+    ASSERT_NOT_NULL(summary);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_EQUAL(0, summary->count);
+    ASSERT_NULL(summary->histogram);
+    ASSERT_NAN(inform_local_summary_variance(summary));
+    ASSERT_NAN(inform_local_summary_quantile(summary, 0.5));
+    inform_local_summary_free(summary);
+
+    ASSERT_NULL(inform_local_summary_alloc(4, 1.0, 1.0, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_local_summary_alloc(4, 1.0, 0.0, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(LocalSummaryStatistics)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_local_summary *summary = inform_local_summary_alloc(10, 0.0, 10.0,
+        &err);
+    ASSERT_NOT_NULL(summary);
+    for (int i = 0; i < 10; ++i)
+    {
+        inform_local_summary_add(summary, i + 0.5);
+    }
+    ASSERT_EQUAL(10, summary->count);
+    ASSERT_DBL_NEAR_TOL(5.0, summary->mean, SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(8.25, inform_local_summary_variance(summary),
+        SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(0.5, summary->min, SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(9.5, summary->max, SUMMARY_TOL);
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQUAL(1, summary->histogram[i]);
+    }
+    ASSERT_DBL_NEAR_TOL(5.0, inform_local_summary_quantile(summary, 0.5),
+        SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(0.5, inform_local_summary_quantile(summary, 0.0),
+        SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(9.5, inform_local_summary_quantile(summary, 1.0),
+        SUMMARY_TOL);
+    ASSERT_NAN(inform_local_summary_quantile(summary, 1.5));
+
+    // values outside of the range land in the first or last bin
+    inform_local_summary_add(summary, -3.0);
+    inform_local_summary_add(summary, 12.0);
+    ASSERT_EQUAL(2, summary->histogram[0]);
+    ASSERT_EQUAL(2, summary->histogram[9]);
+    ASSERT_DBL_NEAR_TOL(-3.0, summary->min, SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(12.0, summary->max, SUMMARY_TOL);
+
+    inform_local_summary_clear(summary);
+    ASSERT_EQUAL(0, summary->count);
+    ASSERT_EQUAL(10, summary->bins);
+    ASSERT_EQUAL(0, summary->histogram[0]);
+    inform_local_summary_free(summary);
+}
+
+static void assert_summarizes(double const *expect, size_t N,
+    inform_local_summary const *summary)
+{
+    double mean = 0.0, variance = 0.0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        mean += expect[i];
+    }
+    mean /= N;
+    for (size_t i = 0; i < N; ++i)
+    {
+        variance += (expect[i] - mean) * (expect[i] - mean);
+    }
+    variance /= N;
+    ASSERT_EQUAL(N, summary->count);
+    ASSERT_DBL_NEAR_TOL(mean, summary->mean, SUMMARY_TOL);
+    ASSERT_DBL_NEAR_TOL(variance, inform_local_summary_variance(summary),
+        SUMMARY_TOL);
+}
+
+static void assert_floats(double const *expect, float const *got, size_t N)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[i], got[i], 1e-6);
+    }
+}
+
+UNIT(LocalSummaryMeasures)
+{
+    int src[400], dst[400];
+    random_binary_series(src, 400, 41);
+    random_binary_series(dst, 400, 42);
+
+    inform_error err = INFORM_SUCCESS;
+    inform_local_summary *summary = inform_local_summary_alloc(0, 0.0, 0.0,
+        &err);
+    double expect[400];
+    float got[400];
+
+    ASSERT_NOT_NULL(inform_local_active_info(src, 4, 100, 2, 3, expect, &err));
+    ASSERT_TRUE(inform_local_active_info_float(src, 4, 100, 2, 3, got, &err) == got);
+    assert_floats(expect, got, 388);
+    ASSERT_TRUE(inform_local_active_info_summary(src, 4, 100, 2, 3, summary,
+        &err) == summary);
+    assert_summarizes(expect, 388, summary);
+    ASSERT_DBL_NEAR_TOL(inform_active_info(src, 4, 100, 2, 3, &err),
+        summary->mean, SUMMARY_TOL);
+
+    inform_local_summary_clear(summary);
+    ASSERT_NOT_NULL(inform_local_entropy_rate(src, 4, 100, 2, 3, expect, &err));
+    ASSERT_NOT_NULL(inform_local_entropy_rate_float(src, 4, 100, 2, 3, got, &err));
+    assert_floats(expect, got, 388);
+    ASSERT_NOT_NULL(inform_local_entropy_rate_summary(src, 4, 100, 2, 3,
+        summary, &err));
+    assert_summarizes(expect, 388, summary);
+
+    inform_local_summary_clear(summary);
+    ASSERT_NOT_NULL(inform_local_block_entropy(src, 4, 100, 2, 3, expect, &err));
+    ASSERT_NOT_NULL(inform_local_block_entropy_float(src, 4, 100, 2, 3, got, &err));
+    assert_floats(expect, got, 392);
+    ASSERT_NOT_NULL(inform_local_block_entropy_summary(src, 4, 100, 2, 3,
+        summary, &err));
+    assert_summarizes(expect, 392, summary);
+
+    inform_local_summary_clear(summary);
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, NULL, 0, 4, 100, 2,
+        2, expect, &err));
+    ASSERT_NOT_NULL(inform_local_transfer_entropy_float(src, dst, NULL, 0, 4,
+        100, 2, 2, got, &err));
+    assert_floats(expect, got, 392);
+    ASSERT_NOT_NULL(inform_local_transfer_entropy_summary(src, dst, NULL, 0, 4,
+        100, 2, 2, summary, &err));
+    assert_summarizes(expect, 392, summary);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_summary_free(summary);
+}
+
+UNIT(LocalSummaryAllocatesFloats)
+{
+    int series[100];
+    random_binary_series(series, 100, 43);
+    inform_error err = INFORM_SUCCESS;
+    double expect[98];
+    ASSERT_NOT_NULL(inform_local_active_info(series, 1, 100, 2, 2, expect, &err));
+    float *got = inform_local_active_info_float(series, 1, 100, 2, 2, NULL, &err);
+    ASSERT_NOT_NULL(got);
+    ASSERT_TRUE(inform_succeeded(&err));
+    assert_floats(expect, got, 98);
+    free(got);
+}
+
+UNIT(LocalSummaryErrors)
+{
+    int series[8] = {0,1,1,0,1,0,0,1};
+    inform_error err = INFORM_SUCCESS;
+    inform_local_summary *summary = inform_local_summary_alloc(0, 0.0, 0.0,
+        &err);
+
+    ASSERT_NULL(inform_local_active_info_summary(series, 1, 8, 2, 2, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_local_entropy_rate_summary(series, 1, 8, 2, 0, summary,
+        &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_local_block_entropy_float(NULL, 1, 8, 2, 2, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    // a failed call adds nothing to the summary
+    series[5] = 2;
+    ASSERT_NULL(inform_local_transfer_entropy_summary(series, series, NULL, 0,
+        1, 8, 2, 2, summary, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    series[5] = -1;
+    ASSERT_NULL(inform_local_active_info_summary(series, 1, 8, 2, 2, summary,
+        &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    ASSERT_EQUAL(0, summary->count);
+
+    inform_local_summary_free(summary);
+}
+
+BEGIN_SUITE(LocalSummary)
+    ADD_UNIT(LocalSummaryAlloc)
+    ADD_UNIT(LocalSummaryStatistics)
+    ADD_UNIT(LocalSummaryMeasures)
+    ADD_UNIT(LocalSummaryAllocatesFloats)
+    ADD_UNIT(LocalSummaryErrors)
+END_SUITE
@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include <ginger/unit.h>
 
+IMPORT_SUITE(Accumulator);
 IMPORT_SUITE(ActiveInformation);
 IMPORT_SUITE(BlockEntropy);
 IMPORT_SUITE(Canary);
@@ -10,21 +11,29 @@ IMPORT_SUITE(ConditionalEntropy);
 IMPORT_SUITE(CrossEntropy);
 IMPORT_SUITE(Distribution);
 IMPORT_SUITE(EffectiveInformation);
+IMPORT_SUITE(Engine);
 IMPORT_SUITE(EntropyRate);
 IMPORT_SUITE(ExcessEntropy);
+IMPORT_SUITE(FusedMeasures);
 IMPORT_SUITE(InformationFlow);
 IMPORT_SUITE(Integration);
+IMPORT_SUITE(LocalSummary);
 IMPORT_SUITE(MutualInfo);
 IMPORT_SUITE(PID);
 IMPORT_SUITE(PredictiveInformation);
 IMPORT_SUITE(RelativeEntropy);
 IMPORT_SUITE(SeparableInformation);
+IMPORT_SUITE(Series);
 IMPORT_SUITE(ShannonMulti);
 IMPORT_SUITE(ShannonUni);
+IMPORT_SUITE(Significance);
+IMPORT_SUITE(SparseDistribution);
 IMPORT_SUITE(TransferEntropy);
 IMPORT_SUITE(Utilities);
+IMPORT_SUITE(WindowDistribution);
 
 BEGIN_REGISTRATION
+    REGISTER(Accumulator)
     REGISTER(ActiveInformation)
     REGISTER(BlockEntropy)
     REGISTER(Canary)
@@ -32,19 +41,26 @@ BEGIN_REGISTRATION
     REGISTER(CrossEntropy)
     REGISTER(Distribution)
     REGISTER(EffectiveInformation)
+    REGISTER(Engine)
     REGISTER(EntropyRate)
     REGISTER(ExcessEntropy)
+    REGISTER(FusedMeasures)
     REGISTER(InformationFlow)
     REGISTER(Integration)
+    REGISTER(LocalSummary)
     REGISTER(MutualInfo)
     REGISTER(PID)
     REGISTER(PredictiveInformation)
     REGISTER(RelativeEntropy)
     REGISTER(SeparableInformation)
+    REGISTER(Series)
     REGISTER(ShannonMulti)
     REGISTER(ShannonUni)
+    REGISTER(Significance)
+    REGISTER(SparseDistribution)
     REGISTER(TransferEntropy)
     REGISTER(Utilities)
+    REGISTER(WindowDistribution)
 END_REGISTRATION
 
 UNIT_MAIN();
@@ -920,6 +920,43 @@ UNIT(LocalPredictiveInfoEnsemble23_Base4)
     }
 }
 
+UNIT(PredictiveInfoSparseSupport)
+{
+    int series[600];
+    random_binary_series(series, 600, 31);
+
+    double dense[578], sparse[578];
+    inform_error err = INFORM_SUCCESS;
+    double expect = inform_predictive_info(series, 2, 300, 2, 6, 6, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    double got = inform_predictive_info(series, 2, 300, 4, 6, 6, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 1e-10);
+
+    ASSERT_NOT_NULL(inform_local_predictive_info(series, 2, 300, 2, 6, 6, dense, &err));
+    ASSERT_NOT_NULL(inform_local_predictive_info(series, 2, 300, 4, 6, 6, sparse, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(dense, sparse, 578, 1e-10);
+}
+
+UNIT(PredictiveInfoLongBlocks)
+{
+    int series[300];
+    for (size_t i = 0; i < 300; ++i) series[i] = (int[]){0,1,1,0,1}[i % 5];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(log2(5.0), inform_predictive_info(series, 1, 299, 2, 30, 30, &err), 1e-6);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double pi[240];
+    ASSERT_NOT_NULL(inform_local_predictive_info(series, 1, 299, 2, 30, 30, pi, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(log2(5.0), AVERAGE(pi), 1e-6);
+
+    ASSERT_TRUE(isnan(inform_predictive_info(series, 1, 300, 2, 32, 32, &err)));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
 BEGIN_SUITE(PredictiveInformation)
     ADD_UNIT(PredictiveInfoSeriesNULLSeries)
     ADD_UNIT(PredictiveInfoSeriesNoInits)
@@ -968,4 +1005,6 @@ BEGIN_SUITE(PredictiveInformation)
     ADD_UNIT(LocalPredictiveInfoEnsemble23)
     ADD_UNIT(LocalPredictiveInfoEnsemble21_Base4)
     ADD_UNIT(LocalPredictiveInfoEnsemble23_Base4)
+    ADD_UNIT(PredictiveInfoSparseSupport)
+    ADD_UNIT(PredictiveInfoLongBlocks)
 END_SUITE
@@ -0,0 +1,508 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/conditional_entropy.h>
+#include <inform/cross_entropy.h>
+#include <inform/engine.h>
+#include <inform/entropy_rate.h>
+#include <inform/excess_entropy.h>
+#include <inform/fused.h>
+#include <inform/mutual_info.h>
+#include <inform/predictive_info.h>
+#include <inform/relative_entropy.h>
+#include <inform/separable_info.h>
+#include <inform/series.h>
+#include <inform/transfer_entropy.h>
+#include "util.h"
+
+#define SERIES_TOL 1e-10
+
+static inform_engine const engines[] = {
+    INFORM_ENGINE_AUTO, INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE,
+    INFORM_ENGINE_SORT
+};
+#define NUM_ENGINES (sizeof(engines) / sizeof(inform_engine))
+
+UNIT(SeriesAlloc)
+{
+    int data[6] = {0,2,1,1,0,2};
+    inform_error err = INFORM_SUCCESS;
+    inform_series *series = inform_series_alloc(data, 2, 3, 4, &err);
+    ASSERT_NOT_NULL(series);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_TRUE(series->data == data);
+    ASSERT_EQUAL(2, series->n);
+    ASSERT_EQUAL(3, series->m);
+    ASSERT_EQUAL(4, series->b);
+    ASSERT_EQUAL(2, series->max_state);
+    ASSERT_EQUAL(0, series->k);
+    ASSERT_NULL(series->histories);
+
+    ASSERT_FALSE(inform_series_encode(series, 2, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_EQUAL(2, series->k);
+    ASSERT_NOT_NULL(series->histories);
+    ASSERT_EQUAL(2, series->histories[0]);
+    ASSERT_EQUAL(4, series->histories[1]);
+
+    ASSERT_FALSE(inform_series_encode(series, 1, &err));
+    ASSERT_EQUAL(1, series->k);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQUAL(data[i / 2 * 3 + i % 2], series->histories[i]);
+    }
+    inform_series_free(series);
+}
+
+UNIT(SeriesErrors)
+{
+    int data[6] = {0,1,1,0,1,0};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_series_alloc(NULL, 2, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NULL(inform_series_alloc(data, 0, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_ENOINITS, err);
+    ASSERT_NULL(inform_series_alloc(data, 2, 0, 2, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+    ASSERT_NULL(inform_series_alloc(data, 2, 3, 1, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    data[4] = -1;
+    ASSERT_NULL(inform_series_alloc(data, 2, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    data[4] = 2;
+    ASSERT_NULL(inform_series_alloc(data, 2, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    data[4] = 1;
+
+    inform_series *series = inform_series_alloc(data, 2, 3, 2, &err);
+    ASSERT_NOT_NULL(series);
+    ASSERT_TRUE(inform_series_encode(NULL, 1, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_TRUE(inform_series_encode(series, 0, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_TRUE(inform_series_encode(series, 3, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    ASSERT_NAN(inform_active_info_series(NULL, 1, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NAN(inform_entropy_rate_series(series, 0, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NAN(inform_block_entropy_series(series, 4, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    ASSERT_NAN(inform_transfer_entropy_series(series, series, NULL, 3,
+        &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    inform_series *other = inform_series_alloc(data, 1, 6, 2, &err);
+    ASSERT_NOT_NULL(other);
+    ASSERT_NAN(inform_transfer_entropy_series(series, other, NULL, 1, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_FALSE(isnan(inform_mutual_info_series(series, other, &err)));
+    inform_series_free(other);
+
+    other = inform_series_alloc(data, 1, 5, 2, &err);
+    ASSERT_NAN(inform_mutual_info_series(series, other, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    inform_series_free(other);
+
+    ASSERT_NULL(inform_fused_measures_series(series, NULL, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    inform_series_free(series);
+}
+
+static void assert_matches(int const *src, int const *dst, size_t n, size_t m,
+    int b, size_t k, bool encode)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, n, m, b, &err);
+    inform_series *ys = inform_series_alloc(dst, n, m, b, &err);
+    ASSERT_NOT_NULL(xs);
+    ASSERT_NOT_NULL(ys);
+    if (encode)
+    {
+        ASSERT_FALSE(inform_series_encode(xs, k, &err));
+        ASSERT_FALSE(inform_series_encode(ys, k, &err));
+    }
+
+    for (size_t i = 0; i < NUM_ENGINES; ++i)
+    {
+        inform_set_engine(engines[i]);
+        ASSERT_DBL_NEAR_TOL(inform_active_info(src, n, m, b, k, &err),
+            inform_active_info_series(xs, k, &err), SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(inform_entropy_rate(src, n, m, b, k, &err),
+            inform_entropy_rate_series(xs, k, &err), SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(inform_block_entropy(src, n, m, b, k, &err),
+            inform_block_entropy_series(xs, k, &err), SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, NULL, 0, n, m, b,
+            k, &err), inform_transfer_entropy_series(xs, ys, NULL, k, &err),
+            SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+
+    int *joint = malloc(2 * n * m * sizeof(int));
+    ASSERT_NOT_NULL(joint);
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        joint[i] = src[i];
+        joint[n * m + i] = dst[i];
+    }
+    ASSERT_DBL_NEAR_TOL(inform_mutual_info(joint, 2, n * m, (int[]){b, b},
+        &err), inform_mutual_info_series(xs, ys, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    free(joint);
+
+    inform_fused_spec const spec = { INFORM_FUSED_EXCESS_ENTROPY, 1, 0 };
+    double expect = 0.0, value = 0.0;
+    inform_fused_measures(src, n, m, b, &spec, 1, &expect, &err);
+    ASSERT_EQUAL_P(&value, inform_fused_measures_series(xs, &spec, 1, &value,
+        &err));
+    ASSERT_DBL_NEAR_TOL(expect, value, SERIES_TOL);
+
+    inform_series_free(xs);
+    inform_series_free(ys);
+}
+
+UNIT(SeriesMatchesMeasures)
+{
+    int src[400], dst[400];
+    random_binary_series(src, 400, 21);
+    random_binary_series(dst, 400, 22);
+    assert_matches(src, dst, 4, 100, 2, 2, false);
+    assert_matches(src, dst, 4, 100, 2, 2, true);
+    assert_matches(src, dst, 1, 400, 2, 5, true);
+}
+
+UNIT(SeriesMatchesOtherMeasures)
+{
+    int src[400], dst[400];
+    random_binary_series(src, 400, 27);
+    random_binary_series(dst, 400, 28);
+    for (size_t i = 0; i < 400; i += 3)
+    {
+        dst[i] += src[i];
+    }
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, 4, 100, 2, &err);
+    inform_series *ys = inform_series_alloc(dst, 4, 100, 3, &err);
+    ASSERT_NOT_NULL(xs);
+    ASSERT_NOT_NULL(ys);
+
+    ASSERT_DBL_NEAR_TOL(inform_predictive_info(src, 4, 100, 2, 2, 3, &err),
+        inform_predictive_info_series(xs, 2, 3, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_excess_entropy(dst, 4, 100, 3, 2, &err),
+        inform_excess_entropy_series(ys, 2, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_conditional_entropy(src, dst, 400, 2, 3, &err),
+        inform_conditional_entropy_series(xs, ys, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_relative_entropy(src, dst, 400, 3, &err),
+        inform_relative_entropy_series(xs, ys, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_cross_entropy(dst, src, 400, 3, &err),
+        inform_cross_entropy_series(ys, xs, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    // two sources stacked in one handle, which must match the destination's
+    // length
+    inform_series *zs = inform_series_alloc(src, 2, 200, 2, &err);
+    inform_series *ws = inform_series_alloc(dst, 1, 100, 3, &err);
+    ASSERT_NAN(inform_separable_info_series(zs, ws, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    inform_series_free(ws);
+    err = INFORM_SUCCESS;
+    ws = inform_series_alloc(dst, 1, 200, 3, &err);
+    ASSERT_DBL_NEAR_TOL(inform_separable_info(src, dst, 2, 1, 200, 3, 2,
+        &err), inform_separable_info_series(zs, ws, 2, &err), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    inform_series_free(ws);
+    inform_series_free(zs);
+
+    ASSERT_NAN(inform_predictive_info_series(NULL, 1, 1, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NAN(inform_excess_entropy_series(xs, 0, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    inform_series *other = inform_series_alloc(src, 1, 300, 2, &err);
+    ASSERT_NAN(inform_conditional_entropy_series(xs, other, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NAN(inform_relative_entropy_series(other, ys, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NAN(inform_cross_entropy_series(xs, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    inform_series_free(other);
+
+    inform_series_free(xs);
+    inform_series_free(ys);
+}
+
+/**
+ * Check the local values of a handle, in each of the forms in which they can
+ * be had, against those of the raw series.
+ */
+static void assert_local_forms(double *expect, double *got, float *got_float,
+    inform_local_summary *summary, size_t N)
+{
+    ASSERT_NOT_NULL(got);
+    ASSERT_NOT_NULL(got_float);
+    ASSERT_NOT_NULL(summary);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect, got, N, SERIES_TOL);
+    double mean = 0.0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[i], got_float[i], 1e-5);
+        mean += expect[i];
+    }
+    ASSERT_EQUAL(N, summary->count);
+    ASSERT_DBL_NEAR_TOL(mean / N, summary->mean, 1e-9);
+}
+
+static void assert_locals_match(int const *src, int const *dst, size_t n,
+    size_t m, int b, size_t k, bool encode)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, n, m, b, &err);
+    inform_series *ys = inform_series_alloc(dst, n, m, b, &err);
+    ASSERT_NOT_NULL(xs);
+    ASSERT_NOT_NULL(ys);
+    if (encode)
+    {
+        ASSERT_FALSE(inform_series_encode(xs, k, &err));
+        ASSERT_FALSE(inform_series_encode(ys, k, &err));
+    }
+
+    size_t const N = n * m;
+    double *expect = malloc(N * sizeof(double));
+    double *got = malloc(N * sizeof(double));
+    float *got_float = malloc(N * sizeof(float));
+    inform_local_summary *summary = inform_local_summary_alloc(0, 0.0, 0.0,
+        &err);
+    ASSERT_NOT_NULL(expect);
+    ASSERT_NOT_NULL(got);
+    ASSERT_NOT_NULL(got_float);
+    ASSERT_NOT_NULL(summary);
+
+    inform_local_active_info(src, n, m, b, k, expect, &err);
+    inform_local_summary_clear(summary);
+    assert_local_forms(expect,
+        inform_local_active_info_series(xs, k, got, &err),
+        inform_local_active_info_float_series(xs, k, got_float, &err),
+        inform_local_active_info_summary_series(xs, k, summary, &err),
+        n * (m - k));
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_entropy_rate(src, n, m, b, k, expect, &err);
+    inform_local_summary_clear(summary);
+    assert_local_forms(expect,
+        inform_local_entropy_rate_series(xs, k, got, &err),
+        inform_local_entropy_rate_float_series(xs, k, got_float, &err),
+        inform_local_entropy_rate_summary_series(xs, k, summary, &err),
+        n * (m - k));
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_block_entropy(src, n, m, b, k, expect, &err);
+    inform_local_summary_clear(summary);
+    assert_local_forms(expect,
+        inform_local_block_entropy_series(xs, k, got, &err),
+        inform_local_block_entropy_float_series(xs, k, got_float, &err),
+        inform_local_block_entropy_summary_series(xs, k, summary, &err),
+        n * (m - k + 1));
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_transfer_entropy(src, dst, NULL, 0, n, m, b, k, expect,
+        &err);
+    inform_local_summary_clear(summary);
+    assert_local_forms(expect,
+        inform_local_transfer_entropy_series(xs, ys, NULL, k, got, &err),
+        inform_local_transfer_entropy_float_series(xs, ys, NULL, k, got_float,
+            &err),
+        inform_local_transfer_entropy_summary_series(xs, ys, NULL, k, summary,
+            &err),
+        n * (m - k));
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_predictive_info(src, n, m, b, k, 1, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_predictive_info_series(xs, k, 1, got, &err), n * (m - k),
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_excess_entropy(src, n, m, b, k, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_excess_entropy_series(xs, k, got, &err),
+        n * (m - 2 * k + 1), SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_separable_info(src, dst, 1, n, m, b, k, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_separable_info_series(xs, ys, k, got, &err), n * (m - k),
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    int *joint = malloc(2 * N * sizeof(int));
+    ASSERT_NOT_NULL(joint);
+    for (size_t i = 0; i < N; ++i)
+    {
+        joint[i] = src[i];
+        joint[N + i] = dst[i];
+    }
+    inform_local_mutual_info(joint, 2, N, (int[]){b, b}, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_mutual_info_series(xs, ys, got, &err), N, SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    free(joint);
+
+    inform_local_conditional_entropy(src, dst, N, b, b, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_conditional_entropy_series(xs, ys, got, &err), N,
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_relative_entropy(src, dst, N, b, expect, &err);
+    ASSERT_DBL_ARRAY_NEAR_TOL(expect,
+        inform_local_relative_entropy_series(xs, ys, got, &err), b,
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_local_summary_free(summary);
+    free(got_float);
+    free(got);
+    free(expect);
+    inform_series_free(xs);
+    inform_series_free(ys);
+}
+
+UNIT(SeriesMatchesLocalMeasures)
+{
+    int src[400], dst[400];
+    random_binary_series(src, 400, 29);
+    random_binary_series(dst, 400, 30);
+    assert_locals_match(src, dst, 4, 100, 2, 2, false);
+    assert_locals_match(src, dst, 4, 100, 2, 2, true);
+    assert_locals_match(src, dst, 1, 400, 2, 3, true);
+
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, 4, 100, 2, &err);
+    ASSERT_NULL(inform_local_active_info_series(NULL, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NULL(inform_local_entropy_rate_float_series(xs, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_local_block_entropy_summary_series(xs, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_local_transfer_entropy_series(xs, xs, NULL, 100, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    inform_series_free(xs);
+}
+
+UNIT(SeriesStaleHistories)
+{
+    // histories of another length are ignored
+    int data[400];
+    random_binary_series(data, 400, 23);
+    inform_error err = INFORM_SUCCESS;
+    inform_series *series = inform_series_alloc(data, 2, 200, 2, &err);
+    ASSERT_FALSE(inform_series_encode(series, 3, &err));
+    ASSERT_DBL_NEAR_TOL(inform_active_info(data, 2, 200, 2, 2, &err),
+        inform_active_info_series(series, 2, &err), SERIES_TOL);
+    ASSERT_DBL_NEAR_TOL(inform_active_info(data, 2, 200, 2, 3, &err),
+        inform_active_info_series(series, 3, &err), SERIES_TOL);
+    inform_series_free(series);
+}
+
+UNIT(SeriesMixedBases)
+{
+    int bits[400], src[200], dst[200];
+    random_binary_series(bits, 400, 24);
+    for (size_t i = 0; i < 200; ++i)
+    {
+        src[i] = bits[i] + bits[200 + i];
+        dst[i] = bits[(i + 1) % 200];
+    }
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, 1, 200, 3, &err);
+    inform_series *ys = inform_series_alloc(dst, 1, 200, 2, &err);
+    ASSERT_FALSE(inform_series_encode(ys, 2, &err));
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, NULL, 0, 1, 200, 3,
+        2, &err), inform_transfer_entropy_series(xs, ys, NULL, 2, &err),
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(dst, src, NULL, 0, 1, 200, 3,
+        2, &err), inform_transfer_entropy_series(ys, xs, NULL, 2, &err),
+        SERIES_TOL);
+    ASSERT_TRUE(inform_succeeded(&err));
+    inform_series_free(xs);
+    inform_series_free(ys);
+}
+
+UNIT(SeriesBackground)
+{
+    int src[200], dst[200], back[400];
+    random_binary_series(src, 200, 25);
+    random_binary_series(back, 400, 26);
+    for (size_t i = 0; i < 400; ++i)
+    {
+        back[i] += back[(i + 7) % 400];
+    }
+    for (size_t i = 0; i < 200; ++i)
+    {
+        dst[i] = (i % 100 == 0) ? 0 : src[i - 1] ^ (back[i - 1] == 1);
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_series *xs = inform_series_alloc(src, 2, 100, 2, &err);
+    inform_series *ys = inform_series_alloc(dst, 2, 100, 2, &err);
+    inform_series *zs = inform_series_alloc(back, 4, 100, 3, &err);
+    ASSERT_NOT_NULL(zs);
+    // the destination's histories omit the background, so they are ignored
+    ASSERT_FALSE(inform_series_encode(ys, 2, &err));
+    // a handle of the first background node alone
+    inform_series *ws = inform_series_alloc(back, 2, 100, 3, &err);
+    ASSERT_NOT_NULL(ws);
+    for (size_t i = 0; i < NUM_ENGINES; ++i)
+    {
+        inform_set_engine(engines[i]);
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, back, 2, 2, 100,
+            3, 2, &err), inform_transfer_entropy_series(xs, ys, zs, 2, &err),
+            SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, back, 1, 2, 100,
+            3, 2, &err), inform_transfer_entropy_series(xs, ys, ws, 2, &err),
+            SERIES_TOL);
+        ASSERT_TRUE(inform_succeeded(&err));
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    inform_series_free(ws);
+    inform_series_free(zs);
+
+    // the background must hold whole ensembles of the same length
+    zs = inform_series_alloc(back, 3, 100, 3, &err);
+    ASSERT_NAN(inform_transfer_entropy_series(xs, ys, zs, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    inform_series_free(zs);
+    zs = inform_series_alloc(back, 2, 200, 3, &err);
+    ASSERT_NAN(inform_transfer_entropy_series(xs, ys, zs, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    inform_series_free(zs);
+
+    inform_series_free(xs);
+    inform_series_free(ys);
+}
+
+BEGIN_SUITE(Series)
+    ADD_UNIT(SeriesAlloc)
+    ADD_UNIT(SeriesErrors)
+    ADD_UNIT(SeriesMatchesMeasures)
+    ADD_UNIT(SeriesMatchesOtherMeasures)
+    ADD_UNIT(SeriesMatchesLocalMeasures)
+    ADD_UNIT(SeriesStaleHistories)
+    ADD_UNIT(SeriesMixedBases)
+    ADD_UNIT(SeriesBackground)
+END_SUITE
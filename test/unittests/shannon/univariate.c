@@ -499,6 +499,94 @@ UNIT(ShannonUniCrossEntropyDefined)
     inform_dist_free(p);
 }
 
+static inform_dist *random_dist(size_t n, uint32_t seed, size_t zeros)
+{
+    inform_dist *dist = inform_dist_alloc(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        seed = 1664525u * seed + 1013904223u;
+        // leave every zeros-th bin empty, and spread the counts over several
+        // orders of magnitude
+        uint32_t const count = (zeros && i % zeros == 0) ? 0 : (seed >> (8 + seed % 20));
+        inform_dist_set(dist, i, count);
+    }
+    return dist;
+}
+
+static double reference_entropy(inform_dist const *dist)
+{
+    double h = 0.0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        if (dist->histogram[i] != 0)
+        {
+            double const p = (double) dist->histogram[i] / dist->counts;
+            h -= p * log2(p);
+        }
+    }
+    return h;
+}
+
+UNIT(ShannonUniLargeEntropy)
+{
+    size_t const sizes[] = {256, 1001, 65536 + 7};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); ++i)
+    {
+        inform_dist *dist = random_dist(sizes[i], 7 + i, 3);
+        double const expect = reference_entropy(dist);
+        ASSERT_DBL_NEAR_TOL(expect, inform_shannon_entropy(dist, 2), 1e-12);
+        ASSERT_DBL_NEAR_TOL(expect / log2(3.0), inform_shannon_entropy(dist, 3), 1e-12);
+        inform_dist_free(dist);
+    }
+}
+
+UNIT(ShannonUniLargeRelativeEntropy)
+{
+    inform_dist *p = random_dist(4099, 11, 0);
+    inform_dist *q = random_dist(4099, 13, 0);
+
+    double expect = 0.0;
+    for (size_t i = 0; i < p->size; ++i)
+    {
+        double const u = (double) p->histogram[i] / p->counts;
+        double const v = (double) q->histogram[i] / q->counts;
+        expect += u * log2(u / v);
+    }
+    ASSERT_DBL_NEAR_TOL(expect, inform_shannon_re(p, q, 2), 1e-10);
+    ASSERT_DBL_NEAR_TOL(0.0, inform_shannon_re(p, p, 2), 1e-10);
+
+    inform_dist_set(q, 4098, 0);
+    ASSERT_NAN(inform_shannon_re(p, q, 2));
+
+    inform_dist_free(q);
+    inform_dist_free(p);
+}
+
+UNIT(ShannonUniLargeCrossEntropy)
+{
+    inform_dist *p = random_dist(4099, 17, 5);
+    inform_dist *q = random_dist(4099, 19, 0);
+
+    double expect = 0.0;
+    for (size_t i = 0; i < p->size; ++i)
+    {
+        if (p->histogram[i] != 0)
+        {
+            double const u = (double) p->histogram[i] / p->counts;
+            double const v = (double) q->histogram[i] / q->counts;
+            expect -= u * log2(v);
+        }
+    }
+    ASSERT_DBL_NEAR_TOL(expect, inform_shannon_cross(p, q, 2), 1e-10);
+    ASSERT_DBL_NEAR_TOL(reference_entropy(p), inform_shannon_cross(p, p, 2), 1e-10);
+
+    inform_dist_set(q, 4098, 0);
+    ASSERT_TRUE(isinf(inform_shannon_cross(p, q, 2)));
+
+    inform_dist_free(q);
+    inform_dist_free(p);
+}
+
 BEGIN_SUITE(ShannonUni)
     ADD_UNIT(ShannonUniInvalidDistribution)
     ADD_UNIT(ShannonUniDeltaFunction)
@@ -527,4 +615,7 @@ BEGIN_SUITE(ShannonUni)
     ADD_UNIT(ShannonUniCrossEntropyUndefined)
     ADD_UNIT(ShannonUniCrossEntropySameDist)
     ADD_UNIT(ShannonUniCrossEntropyDefined)
+    ADD_UNIT(ShannonUniLargeEntropy)
+    ADD_UNIT(ShannonUniLargeRelativeEntropy)
+    ADD_UNIT(ShannonUniLargeCrossEntropy)
 END_SUITE
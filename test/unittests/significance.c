@@ -0,0 +1,202 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/active_info.h>
+#include <inform/engine.h>
+#include <inform/mutual_info.h>
+#include <inform/significance.h>
+#include <inform/transfer_entropy.h>
+#include <string.h>
+#include "util.h"
+
+#define SIGNIFICANCE_TOL 1e-10
+#define SURROGATES 50
+
+UNIT(SignificanceTransferEntropyValue)
+{
+    int src[400], dst[400];
+    random_binary_series(src, 400, 3);
+    random_binary_series(dst, 400, 4);
+
+    inform_surrogates const surrogates = { INFORM_SURROGATE_PERMUTE, SURROGATES, 0, 1 };
+    inform_error err = INFORM_SUCCESS;
+    double null[SURROGATES], value = 0.0;
+    double const p = inform_transfer_entropy_significance(src, dst, 4, 100, 2,
+        2, &surrogates, null, &value, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, NULL, 0, 4, 100, 2,
+        2, &err), value, SIGNIFICANCE_TOL);
+    ASSERT_TRUE(0.0 < p && p <= 1.0);
+
+    size_t extreme = 0;
+    for (size_t i = 0; i < SURROGATES; ++i)
+    {
+        ASSERT_TRUE(null[i] >= 0.0);
+        extreme += (null[i] >= value);
+    }
+    ASSERT_DBL_NEAR_TOL((extreme + 1.0) / (SURROGATES + 1.0), p, 1e-12);
+}
+
+UNIT(SignificanceActiveInfoValue)
+{
+    int series[400];
+    random_binary_series(series, 400, 5);
+
+    inform_surrogates const surrogates = { INFORM_SURROGATE_SHIFT, SURROGATES, 0, 2 };
+    inform_error err = INFORM_SUCCESS;
+    double value = 0.0;
+    double const p = inform_active_info_significance(series, 2, 200, 2, 3,
+        &surrogates, NULL, &value, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_active_info(series, 2, 200, 2, 3, &err), value,
+        SIGNIFICANCE_TOL);
+    ASSERT_TRUE(0.0 < p && p <= 1.0);
+}
+
+UNIT(SignificanceMutualInfoValue)
+{
+    int bits[400], series[400];
+    random_binary_series(bits, 400, 6);
+    for (size_t i = 0; i < 200; ++i)
+    {
+        series[i] = bits[i] + bits[200 + i];
+        series[200 + i] = bits[200 + i];
+    }
+
+    inform_surrogates const surrogates = { INFORM_SURROGATE_BLOCK, SURROGATES, 8, 3 };
+    inform_error err = INFORM_SUCCESS;
+    double value = 0.0;
+    double const p = inform_mutual_info_significance(series, series + 200, 200,
+        3, 2, &surrogates, NULL, &value, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(inform_mutual_info(series, 2, 200, (int[]){3, 2},
+        &err), value, SIGNIFICANCE_TOL);
+    ASSERT_TRUE(0.0 < p && p <= 1.0);
+}
+
+UNIT(SignificanceDetectsCoupling)
+{
+    // the destination copies the source with a lag of one step
+    int src[500], dst[500], noise[500];
+    random_binary_series(src, 500, 7);
+    random_binary_series(noise, 500, 8);
+    dst[0] = 0;
+    for (size_t i = 1; i < 500; ++i)
+    {
+        dst[i] = src[i - 1];
+    }
+
+    inform_surrogates const surrogates = { INFORM_SURROGATE_PERMUTE, 99, 0, 9 };
+    inform_error err = INFORM_SUCCESS;
+    double p = inform_transfer_entropy_significance(src, dst, 1, 500, 2, 1,
+        &surrogates, NULL, NULL, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.01, p, 1e-12);
+
+    p = inform_transfer_entropy_significance(noise, dst, 1, 500, 2, 1,
+        &surrogates, NULL, NULL, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_TRUE(p > 0.05);
+
+    p = inform_mutual_info_significance(src, dst + 1, 499, 2, 2, &surrogates,
+        NULL, NULL, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.01, p, 1e-12);
+}
+
+static void assert_reproducible(inform_surrogate_method method)
+{
+    int src[600], dst[600];
+    random_binary_series(src, 600, 10);
+    random_binary_series(dst, 600, 11);
+
+    inform_surrogates const surrogates = { method, SURROGATES, 5, 12 };
+    inform_error err = INFORM_SUCCESS;
+    double serial[SURROGATES], parallel[SURROGATES];
+    double const p = inform_transfer_entropy_significance(src, dst, 3, 200, 2,
+        2, &surrogates, serial, NULL, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    inform_set_num_threads(3);
+    ASSERT_DBL_NEAR_TOL(p, inform_transfer_entropy_significance(src, dst, 3,
+        200, 2, 2, &surrogates, parallel, NULL, &err), 1e-12);
+    inform_set_num_threads(1);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_EQUAL(0, memcmp(serial, parallel, sizeof(serial)));
+
+    inform_set_engine(INFORM_ENGINE_SPARSE);
+    ASSERT_DBL_NEAR_TOL(p, inform_transfer_entropy_significance(src, dst, 3,
+        200, 2, 2, &surrogates, parallel, NULL, &err), 1e-12);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t i = 0; i < SURROGATES; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(serial[i], parallel[i], SIGNIFICANCE_TOL);
+    }
+}
+
+UNIT(SignificanceReproducible)
+{
+    assert_reproducible(INFORM_SURROGATE_PERMUTE);
+    assert_reproducible(INFORM_SURROGATE_BLOCK);
+    assert_reproducible(INFORM_SURROGATE_SHIFT);
+}
+
+UNIT(SignificanceErrors)
+{
+    int src[8] = {0,1,1,0,1,0,0,1}, dst[8] = {1,1,0,0,1,0,1,1};
+    inform_surrogates surrogates = { INFORM_SURROGATE_PERMUTE, 10, 0, 0 };
+    inform_error err = INFORM_SUCCESS;
+
+    ASSERT_NAN(inform_transfer_entropy_significance(NULL, dst, 1, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NAN(inform_transfer_entropy_significance(src, dst, 0, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOINITS, err);
+    ASSERT_NAN(inform_transfer_entropy_significance(src, dst, 1, 8, 2, 8,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    ASSERT_NAN(inform_active_info_significance(src, 1, 8, 2, 0,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NAN(inform_mutual_info_significance(src, dst, 8, 2, 1,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    ASSERT_NAN(inform_transfer_entropy_significance(src, dst, 1, 8, 2, 2,
+        NULL, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    surrogates.count = 0;
+    ASSERT_NAN(inform_active_info_significance(src, 1, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    surrogates = (inform_surrogates){ INFORM_SURROGATE_BLOCK, 10, 0, 0 };
+    ASSERT_NAN(inform_mutual_info_significance(src, dst, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    surrogates = (inform_surrogates){ (inform_surrogate_method) 42, 10, 0, 0 };
+    ASSERT_NAN(inform_mutual_info_significance(src, dst, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    surrogates.method = INFORM_SURROGATE_SHIFT;
+    src[3] = -1;
+    ASSERT_NAN(inform_transfer_entropy_significance(src, dst, 1, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    src[3] = 2;
+    ASSERT_NAN(inform_mutual_info_significance(src, dst, 8, 2, 2,
+        &surrogates, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+BEGIN_SUITE(Significance)
+    ADD_UNIT(SignificanceTransferEntropyValue)
+    ADD_UNIT(SignificanceActiveInfoValue)
+    ADD_UNIT(SignificanceMutualInfoValue)
+    ADD_UNIT(SignificanceDetectsCoupling)
+    ADD_UNIT(SignificanceReproducible)
+    ADD_UNIT(SignificanceErrors)
+END_SUITE
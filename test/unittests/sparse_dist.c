@@ -0,0 +1,193 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/shannon.h>
+#include <inform/sparse_dist.h>
+#include <math.h>
+
+UNIT(SparseAlloc)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+    ASSERT_EQUAL(0, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(0, inform_sparse_dist_counts(dist));
+    ASSERT_FALSE(inform_sparse_dist_is_valid(dist));
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseNull)
+{
+    ASSERT_EQUAL(0, inform_sparse_dist_size(NULL));
+    ASSERT_EQUAL(0, inform_sparse_dist_counts(NULL));
+    ASSERT_FALSE(inform_sparse_dist_is_valid(NULL));
+    ASSERT_EQUAL(0, inform_sparse_dist_get(NULL, 3));
+    ASSERT_EQUAL(0, inform_sparse_dist_set(NULL, 3, 2));
+    ASSERT_EQUAL(0, inform_sparse_dist_tick(NULL, 3));
+    ASSERT_DBL_NEAR(0.0, inform_sparse_dist_prob(NULL, 3));
+    ASSERT_NULL(inform_sparse_dist_dup(NULL));
+    ASSERT_NAN(inform_shannon_sparse_entropy(NULL, 2.0));
+}
+
+UNIT(SparseTickAndGet)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(2);
+    ASSERT_NOT_NULL(dist);
+
+    uint64_t const big = UINT64_C(1) << 62;
+    ASSERT_EQUAL(1, inform_sparse_dist_tick(dist, big));
+    ASSERT_EQUAL(2, inform_sparse_dist_tick(dist, big));
+    ASSERT_EQUAL(1, inform_sparse_dist_tick(dist, 7));
+    ASSERT_TRUE(inform_sparse_dist_is_valid(dist));
+
+    ASSERT_EQUAL(2, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(3, inform_sparse_dist_counts(dist));
+    ASSERT_EQUAL(2, inform_sparse_dist_get(dist, big));
+    ASSERT_EQUAL(1, inform_sparse_dist_get(dist, 7));
+    ASSERT_EQUAL(0, inform_sparse_dist_get(dist, 8));
+    ASSERT_DBL_NEAR(2.0 / 3.0, inform_sparse_dist_prob(dist, big));
+
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseTickSaturated)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+
+    ASSERT_EQUAL(UINT32_MAX, inform_sparse_dist_set(dist, 5, UINT32_MAX));
+    ASSERT_EQUAL(0, inform_sparse_dist_tick(dist, 5));
+    ASSERT_EQUAL(UINT32_MAX, inform_sparse_dist_get(dist, 5));
+    ASSERT_EQUAL(1, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(UINT32_MAX, inform_sparse_dist_counts(dist));
+
+    ASSERT_EQUAL(1, inform_sparse_dist_tick(dist, 6));
+    ASSERT_EQUAL(2, inform_sparse_dist_size(dist));
+
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseGrow)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+    for (uint64_t i = 0; i < 10000; ++i)
+    {
+        for (uint64_t j = 0; j <= i % 3; ++j)
+        {
+            inform_sparse_dist_tick(dist, i * 1000003);
+        }
+    }
+    ASSERT_EQUAL(10000, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(19999, inform_sparse_dist_counts(dist));
+    for (uint64_t i = 0; i < 10000; ++i)
+    {
+        ASSERT_EQUAL(i % 3 + 1, inform_sparse_dist_get(dist, i * 1000003));
+    }
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseSetAndRemove)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQUAL(i + 1, inform_sparse_dist_set(dist, i, (uint32_t)(i + 1)));
+    }
+    ASSERT_EQUAL(1000, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(500500, inform_sparse_dist_counts(dist));
+
+    for (uint64_t i = 0; i < 1000; i += 2)
+    {
+        ASSERT_EQUAL(0, inform_sparse_dist_set(dist, i, 0));
+    }
+    ASSERT_EQUAL(500, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(250500, inform_sparse_dist_counts(dist));
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQUAL((i % 2) ? i + 1 : 0, inform_sparse_dist_get(dist, i));
+    }
+
+    inform_sparse_dist_clear(dist);
+    ASSERT_EQUAL(0, inform_sparse_dist_size(dist));
+    ASSERT_EQUAL(0, inform_sparse_dist_counts(dist));
+    ASSERT_EQUAL(0, inform_sparse_dist_get(dist, 1));
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseDup)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+    inform_sparse_dist_set(dist, 12, 3);
+    inform_sparse_dist_set(dist, 99, 5);
+
+    inform_sparse_dist *dup = inform_sparse_dist_dup(dist);
+    ASSERT_NOT_NULL(dup);
+    inform_sparse_dist_tick(dist, 12);
+    ASSERT_EQUAL(3, inform_sparse_dist_get(dup, 12));
+    ASSERT_EQUAL(5, inform_sparse_dist_get(dup, 99));
+    ASSERT_EQUAL(8, inform_sparse_dist_counts(dup));
+    ASSERT_EQUAL(2, inform_sparse_dist_size(dup));
+
+    inform_sparse_dist_free(dup);
+    inform_sparse_dist_free(dist);
+}
+
+UNIT(SparseDenseRoundTrip)
+{
+    inform_dist *dense = inform_dist_create((uint32_t[6]){0,3,0,2,5,0}, 6);
+    ASSERT_NOT_NULL(dense);
+
+    inform_sparse_dist *sparse = inform_sparse_dist_from_dist(dense);
+    ASSERT_NOT_NULL(sparse);
+    ASSERT_EQUAL(3, inform_sparse_dist_size(sparse));
+    ASSERT_EQUAL(10, inform_sparse_dist_counts(sparse));
+    ASSERT_EQUAL(5, inform_sparse_dist_get(sparse, 4));
+
+    ASSERT_NULL(inform_sparse_dist_to_dist(sparse, 4));
+    inform_dist *back = inform_sparse_dist_to_dist(sparse, 6);
+    ASSERT_NOT_NULL(back);
+    ASSERT_EQUAL(10, inform_dist_counts(back));
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(inform_dist_get(dense, i), inform_dist_get(back, i));
+    }
+
+    ASSERT_DBL_NEAR_TOL(inform_shannon_entropy(dense, 2.0),
+        inform_shannon_sparse_entropy(sparse, 2.0), 1e-12);
+    ASSERT_DBL_NEAR_TOL(inform_shannon_entropy(dense, 3.0),
+        inform_shannon_sparse_entropy(sparse, 3.0), 1e-12);
+
+    inform_dist_free(back);
+    inform_sparse_dist_free(sparse);
+    inform_dist_free(dense);
+}
+
+UNIT(SparseAccumulate)
+{
+    inform_sparse_dist *dist = inform_sparse_dist_alloc(0);
+    ASSERT_NOT_NULL(dist);
+    ASSERT_EQUAL(0, inform_sparse_dist_accumulate(NULL, (int[2]){0, 1}, 2));
+    ASSERT_EQUAL(0, inform_sparse_dist_accumulate(dist, NULL, 2));
+    ASSERT_EQUAL(5, inform_sparse_dist_accumulate(dist, (int[5]){0,9,9,1000,0}, 5));
+    ASSERT_EQUAL(1, inform_sparse_dist_accumulate(dist, (int[3]){9,-1,9}, 3));
+    ASSERT_EQUAL(2, inform_sparse_dist_get(dist, 0));
+    ASSERT_EQUAL(3, inform_sparse_dist_get(dist, 9));
+    ASSERT_EQUAL(1, inform_sparse_dist_get(dist, 1000));
+    ASSERT_EQUAL(6, inform_sparse_dist_counts(dist));
+    inform_sparse_dist_free(dist);
+}
+
+BEGIN_SUITE(SparseDistribution)
+    ADD_UNIT(SparseAlloc)
+    ADD_UNIT(SparseNull)
+    ADD_UNIT(SparseTickAndGet)
+    ADD_UNIT(SparseTickSaturated)
+    ADD_UNIT(SparseGrow)
+    ADD_UNIT(SparseSetAndRemove)
+    ADD_UNIT(SparseDup)
+    ADD_UNIT(SparseDenseRoundTrip)
+    ADD_UNIT(SparseAccumulate)
+END_SUITE
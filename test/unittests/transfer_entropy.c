@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/engine.h>
 #include <inform/transfer_entropy.h>
 #include <math.h>
 #include <ginger/unit.h>
@@ -591,6 +592,32 @@ UNIT(LocalCompleteTransferEntropy)
     }
 }
 
+UNIT(LocalCompleteTransferEntropyEnsemble)
+{
+    // the background is laid out node by node, then initial condition by
+    // initial condition, just as it is for inform_transfer_entropy
+    int src[300], dst[300], back[600];
+    random_binary_series(src, 300, 31);
+    random_binary_series(back, 600, 32);
+    for (size_t i = 0; i < 300; ++i)
+    {
+        dst[i] = (i % 100 == 0) ? 0 : (src[i - 1] ^ back[i - 1] ^ back[300 + i - 1]);
+    }
+
+    double te[294];
+    inform_error err = INFORM_SUCCESS;
+    for (size_t l = 1; l <= 2; ++l)
+    {
+        double const expect = inform_transfer_entropy(src, dst, back, l, 3,
+            100, 2, 2, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, back, l, 3,
+            100, 2, 2, te, &err));
+        ASSERT_TRUE(inform_succeeded(&err));
+        ASSERT_DBL_NEAR_TOL(expect, AVERAGE(te), 1e-10);
+    }
+}
+
 UNIT(LocalTransferEntropyEnsemble_Base2)
 {
     {
@@ -697,6 +724,478 @@ UNIT(LocalTransferEntropyEnsemble_Base2)
     }
 }
 
+UNIT(TransferEntropySparseSupport)
+{
+    int series[1200];
+    random_binary_series(series, 1200, 37);
+    int const *src = series, *dst = series + 600;
+
+    double dense[580], sparse[580];
+    inform_error err = INFORM_SUCCESS;
+    double expect = inform_transfer_entropy(src, dst, NULL, 0, 2, 300, 2, 10, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    double got = inform_transfer_entropy(src, dst, NULL, 0, 2, 300, 4, 10, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(expect, got, 1e-10);
+
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, NULL, 0, 2, 300, 2, 10, dense, &err));
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, NULL, 0, 2, 300, 4, 10, sparse, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_ARRAY_NEAR_TOL(dense, sparse, 580, 1e-10);
+}
+
+UNIT(TransferEntropyLongHistory)
+{
+    // rare events in the source are copied to the destination, so that the
+    // long histories of the destination are mostly quiescent and recur
+    int bits[2000], series[1500];
+    random_binary_series(bits, 2000, 41);
+    random_binary_series(series, 1500, 43);
+    int *src = series, *dst = series + 500, *back = series + 1000;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        src[i] = bits[i] & bits[i + 500] & bits[i + 1000] & bits[i + 1500];
+        dst[i] = (i == 0) ? 0 : src[i - 1];
+        back[i] = 0;
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    double te = inform_transfer_entropy(src, dst, back, 1, 1, 500, 2, 30, &err);
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_TRUE(te > 0.0);
+
+    double local[470];
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, back, 1, 1, 500, 2, 30, local, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(te, AVERAGE(local), 1e-6);
+
+    ASSERT_TRUE(isnan(inform_transfer_entropy(src, dst, back, 1, 1, 500, 2, 61, &err)));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+static void coupled_series(int *series, size_t l, size_t n, size_t m, int b,
+    uint32_t seed)
+{
+    random_binary_series(series, l * n * m, seed);
+    // each node copies the previous node's last state most of the time
+    for (size_t u = 1; u < l; ++u)
+    {
+        int *node = series + u * n * m;
+        int const *prev = node - n * m;
+        for (size_t i = 0; i < n * m; ++i)
+        {
+            if (i % m != 0 && i % 4 != 0)
+            {
+                node[i] = prev[i - 1];
+            }
+            node[i] %= b;
+        }
+    }
+}
+
+static void assert_matrix_matches(int const *series, size_t l, size_t n,
+    size_t m, int b, size_t k)
+{
+    inform_error err = INFORM_SUCCESS;
+    double *te = inform_transfer_entropy_matrix(series, l, n, m, b, k, NULL,
+        &err);
+    ASSERT_NOT_NULL(te);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < l; ++j)
+        {
+            double expect = 0.0;
+            if (i != j)
+            {
+                expect = inform_transfer_entropy(series + i * n * m,
+                    series + j * n * m, NULL, 0, n, m, b, k, &err);
+                ASSERT_TRUE(inform_succeeded(&err));
+            }
+            ASSERT_DBL_NEAR_TOL(expect, te[i * l + j], 1e-10);
+        }
+    }
+    free(te);
+}
+
+UNIT(TransferEntropyMatrix)
+{
+    size_t const l = 11, n = 3, m = 2000;
+    int *series = malloc(l * n * m * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    coupled_series(series, l, n, m, 2, 2018);
+
+    assert_matrix_matches(series, l, n, m, 2, 1);
+    assert_matrix_matches(series, l, n, m, 2, 3);
+    assert_matrix_matches(series, 2, n, m, 2, 2);
+
+    inform_set_num_threads(3);
+    assert_matrix_matches(series, l, n, m, 2, 2);
+    assert_matrix_matches(series, 2, n, m, 2, 2);
+    inform_set_num_threads(1);
+
+    inform_set_engine(INFORM_ENGINE_SPARSE);
+    assert_matrix_matches(series, 4, n, m, 2, 2);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+
+    free(series);
+}
+
+UNIT(TransferEntropyMatrixProvidedOutput)
+{
+    int series[24] = {0,0,1,1,1,1,0,0,
+                      0,0,0,1,1,1,1,0,
+                      1,0,0,0,1,1,1,1};
+    inform_error err = INFORM_SUCCESS;
+    double te[9];
+    ASSERT_EQUAL_P(te, inform_transfer_entropy_matrix(series, 3, 1, 8, 2, 2,
+        te, &err));
+    ASSERT_TRUE(inform_succeeded(&err));
+    ASSERT_DBL_NEAR_TOL(0.0, te[0], 1e-12);
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(series, series + 8, NULL, 0,
+        1, 8, 2, 2, &err), te[1], 1e-10);
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(series + 16, series, NULL, 0,
+        1, 8, 2, 2, &err), te[6], 1e-10);
+}
+
+UNIT(TransferEntropyMatrixErrors)
+{
+    int series[16] = {0,0,1,1,1,1,0,0, 0,0,0,1,1,1,1,0};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_matrix(NULL, 2, 1, 8, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 1, 1, 8, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 0, 8, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOINITS, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 1, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 8, 1, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 8, 2, 8, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 8, 2, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    series[12] = -1;
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 8, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    series[12] = 2;
+    ASSERT_NULL(inform_transfer_entropy_matrix(series, 2, 1, 8, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(TransferEntropyValidatesWhileCounting)
+{
+    // the states are validated as they are counted, by every engine, even
+    // those which the counting never reads, e.g. the last of the source
+    inform_engine const engines[] = {
+        INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE, INFORM_ENGINE_SORT
+    };
+    int series[60] = {0};
+    inform_error err = INFORM_SUCCESS;
+    for (size_t e = 0; e < 3; ++e)
+    {
+        inform_set_engine(engines[e]);
+        for (size_t i = 0; i < 60; ++i)
+        {
+            series[i] = -1;
+            ASSERT_NAN(inform_transfer_entropy(series, series + 20, series + 40,
+                1, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+            series[i] = 2;
+            ASSERT_NAN(inform_transfer_entropy(series, series + 20, series + 40,
+                1, 2, 10, 2, 3, &err));
+            ASSERT_EQUAL(INFORM_EBADSTATE, err);
+            series[i] = 0;
+        }
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.0, inform_transfer_entropy(series, series + 20,
+        series + 40, 1, 2, 10, 2, 3, &err), 1e-12);
+    ASSERT_TRUE(inform_succeeded(&err));
+}
+
+UNIT(OnlineTransferEntropyMatchesBatch)
+{
+    int src[500], dst[500];
+    random_binary_series(src, 500, 51);
+    random_binary_series(dst, 500, 52);
+    for (size_t i = 1; i < 500; i += 3)
+    {
+        dst[i] = src[i - 1];
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_online_te *te = inform_transfer_entropy_online(2, 2, 0, &err);
+    ASSERT_NOT_NULL(te);
+    ASSERT_NAN(inform_online_te_value(te));
+    for (size_t t = 0; t < 500; ++t)
+    {
+        double const value = inform_online_te_push(te, src[t], dst[t], &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        if (t < 2)
+        {
+            ASSERT_NAN(value);
+            continue;
+        }
+        ASSERT_EQUAL(t - 1, inform_online_te_observations(te));
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, NULL, 0, 1,
+            t + 1, 2, 2, &err), value, 1e-10);
+    }
+
+    // a restart begins a new initial condition
+    inform_online_te_restart(te);
+    for (size_t t = 0; t < 500; ++t)
+    {
+        inform_online_te_push(te, dst[t], src[t], &err);
+    }
+    int xs[1000], ys[1000];
+    for (size_t t = 0; t < 500; ++t)
+    {
+        xs[t] = src[t];
+        xs[500 + t] = dst[t];
+        ys[t] = dst[t];
+        ys[500 + t] = src[t];
+    }
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(xs, ys, NULL, 0, 2, 500, 2, 2,
+        &err), inform_online_te_value(te), 1e-10);
+    inform_online_te_free(te);
+}
+
+UNIT(OnlineTransferEntropyWindow)
+{
+    int src[600], dst[600];
+    random_binary_series(src, 600, 53);
+    random_binary_series(dst, 600, 54);
+    for (size_t i = 1; i < 300; ++i)
+    {
+        dst[i] = src[i - 1];
+    }
+
+    size_t const window = 64, k = 3;
+    inform_error err = INFORM_SUCCESS;
+    inform_engine const engines[] = { INFORM_ENGINE_DENSE, INFORM_ENGINE_SPARSE };
+    for (size_t e = 0; e < 2; ++e)
+    {
+        inform_set_engine(engines[e]);
+        inform_online_te *te = inform_transfer_entropy_online(2, k, window,
+            &err);
+        ASSERT_NOT_NULL(te);
+        for (size_t t = 0; t < 600; ++t)
+        {
+            double const value = inform_online_te_push(te, src[t], dst[t],
+                &err);
+            ASSERT_TRUE(inform_succeeded(&err));
+            if (t >= window + k)
+            {
+                // the window holds the observations of the last window + k
+                // time steps
+                size_t const start = t + 1 - window - k;
+                ASSERT_EQUAL(window, inform_online_te_observations(te));
+                ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src + start,
+                    dst + start, NULL, 0, 1, window + k, 2, k, &err), value,
+                    1e-10);
+            }
+        }
+        inform_online_te_free(te);
+    }
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(OnlineTransferEntropyErrors)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_online(1, 2, 0, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+    ASSERT_NULL(inform_transfer_entropy_online(2, 0, 0, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_transfer_entropy_online(2, 62, 0, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+    ASSERT_NAN(inform_online_te_push(NULL, 0, 0, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    inform_online_te *te = inform_transfer_entropy_online(2, 1, 4, &err);
+    ASSERT_NOT_NULL(te);
+    inform_online_te_push(te, 0, 1, &err);
+    inform_online_te_push(te, 1, 1, &err);
+    double const value = inform_online_te_value(te);
+    ASSERT_NAN(inform_online_te_push(te, -1, 0, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+    ASSERT_NAN(inform_online_te_push(te, 0, 2, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    ASSERT_EQUAL(1, inform_online_te_observations(te));
+    ASSERT_DBL_NEAR_TOL(value, inform_online_te_value(te), 1e-12);
+    inform_online_te_free(te);
+}
+
+UNIT(TransferEntropyWindowed)
+{
+    int src[600], dst[600], xs[600], ys[600];
+    random_binary_series(src, 600, 63);
+    random_binary_series(dst, 600, 64);
+    for (size_t i = 1; i < 300; ++i)
+    {
+        dst[i] = src[i - 1];
+    }
+    size_t const strides[3] = {1, 7, 40};
+    inform_error err = INFORM_SUCCESS;
+    for (size_t s = 0; s < 3; ++s)
+    {
+        size_t const window = 30, stride = strides[s];
+        size_t const count = (200 - window) / stride + 1;
+        double *te = inform_transfer_entropy_windowed(src, dst, 3, 200, 2, 2,
+            window, stride, NULL, &err);
+        ASSERT_NOT_NULL(te);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t w = 0; w < count; ++w)
+        {
+            window_slice(src, 3, 200, w * stride, window, xs);
+            window_slice(dst, 3, 200, w * stride, window, ys);
+            ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(xs, ys, NULL, 0, 3,
+                window, 2, 2, &err), te[w], 1e-10);
+        }
+        free(te);
+    }
+
+    ASSERT_NULL(inform_transfer_entropy_windowed(src, dst, 3, 200, 2, 2, 2, 1,
+        NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    dst[0] = -1;
+    ASSERT_NULL(inform_transfer_entropy_windowed(src, dst, 3, 200, 2, 2, 30, 1,
+        NULL, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+}
+
+/**
+ * Shift the source of each initial condition by `lag` and embed `ks` of its
+ * time steps into a single state of base `b^ks`, trimming the destination to
+ * the observations shared by every lag up to `max_lag`
+ */
+static size_t lagged_series(int const *src, int const *dst, size_t n,
+    size_t m, int b, size_t k, size_t ks, size_t lag, size_t max_lag,
+    int *xs, int *ys)
+{
+    size_t const start = (k < max_lag + ks - 1) ? max_lag + ks - 1 : k;
+    size_t const w = m - start + k;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t t = 0; t < w; ++t)
+        {
+            size_t const end = t + 1 + start - k;
+            int x = 0;
+            if (end >= lag + ks - 1)
+            {
+                for (size_t u = end - lag + 1 - ks; u <= end - lag; ++u)
+                {
+                    x = x * b + src[i * m + u];
+                }
+            }
+            xs[i * w + t] = x;
+            ys[i * w + t] = dst[i * m + t + start - k];
+        }
+    }
+    return w;
+}
+
+static void assert_lag_scan_matches(int const *src, int const *dst, size_t n,
+    size_t m, size_t k, size_t ks, size_t min_lag, size_t max_lag)
+{
+    int *xs = malloc(n * m * sizeof(int)), *ys = malloc(n * m * sizeof(int));
+    inform_error err = INFORM_SUCCESS;
+    double *te = inform_transfer_entropy_lag_scan(src, dst, n, m, 2, k, ks,
+        min_lag, max_lag, NULL, &err);
+    ASSERT_NOT_NULL(te);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t lag = min_lag; lag <= max_lag; ++lag)
+    {
+        size_t const w = lagged_series(src, dst, n, m, 2, k, ks, lag, max_lag,
+            xs, ys);
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(xs, ys, NULL, 0, n, w,
+            1 << ks, k, &err), te[lag - min_lag], 1e-10);
+    }
+    free(te);
+    free(ys);
+    free(xs);
+}
+
+UNIT(TransferEntropyLagScan)
+{
+    int src[1500], dst[1500];
+    random_binary_series(src, 1500, 65);
+    random_binary_series(dst, 1500, 66);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t t = 3; t < 400; ++t)
+        {
+            dst[i * 500 + t] = src[i * 500 + t - 3];
+        }
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    double te[6];
+    ASSERT_TRUE(inform_transfer_entropy_lag_scan(src, dst, 3, 500, 2, 2, 1, 1,
+        6, te, &err) == te);
+    ASSERT_TRUE(inform_succeeded(&err));
+    for (size_t lag = 1; lag <= 6; ++lag)
+    {
+        if (lag != 3)
+        {
+            ASSERT_TRUE(te[lag - 1] < te[2]);
+        }
+    }
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, dst, NULL, 0, 3, 500, 2,
+        2, &err), *inform_transfer_entropy_lag_scan(src, dst, 3, 500, 2, 2, 1,
+        1, 1, te, &err), 1e-10);
+
+    assert_lag_scan_matches(src, dst, 3, 500, 2, 1, 1, 6);
+    assert_lag_scan_matches(src, dst, 3, 500, 1, 2, 2, 20);
+    assert_lag_scan_matches(src, dst, 3, 500, 4, 3, 1, 2);
+
+    inform_set_num_threads(3);
+    assert_lag_scan_matches(src, dst, 3, 500, 2, 2, 1, 30);
+    assert_lag_scan_matches(src, dst, 3, 500, 2, 1, 4, 5);
+    inform_set_num_threads(1);
+
+    inform_set_engine(INFORM_ENGINE_SPARSE);
+    assert_lag_scan_matches(src, dst, 3, 500, 2, 2, 1, 10);
+    inform_set_engine(INFORM_ENGINE_AUTO);
+}
+
+UNIT(TransferEntropyLagScanErrors)
+{
+    int src[8] = {0,0,1,1,1,1,0,0}, dst[8] = {0,0,0,1,1,1,1,0};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(NULL, dst, 1, 8, 2, 2, 1, 1,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 0, 1, 1,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 0, 1,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 1, 0,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 1, 3,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 2, 1,
+        7, NULL, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+    src[7] = 2;
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 1, 1,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+    src[7] = 0;
+    dst[0] = -1;
+    ASSERT_NULL(inform_transfer_entropy_lag_scan(src, dst, 1, 8, 2, 2, 1, 1,
+        2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+}
+
 BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(TransferEntropyNULLSeries)
     ADD_UNIT(TransferEntropyNoInits)
@@ -724,4 +1223,17 @@ BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(LocalTransferEntropySingleSeries_Base2)
     ADD_UNIT(LocalTransferEntropyEnsemble_Base2)
     ADD_UNIT(LocalCompleteTransferEntropy)
+    ADD_UNIT(LocalCompleteTransferEntropyEnsemble)
+    ADD_UNIT(TransferEntropySparseSupport)
+    ADD_UNIT(TransferEntropyLongHistory)
+    ADD_UNIT(TransferEntropyMatrix)
+    ADD_UNIT(TransferEntropyMatrixProvidedOutput)
+    ADD_UNIT(TransferEntropyMatrixErrors)
+    ADD_UNIT(TransferEntropyValidatesWhileCounting)
+    ADD_UNIT(OnlineTransferEntropyMatchesBatch)
+    ADD_UNIT(OnlineTransferEntropyWindow)
+    ADD_UNIT(OnlineTransferEntropyErrors)
+    ADD_UNIT(TransferEntropyWindowed)
+    ADD_UNIT(TransferEntropyLagScan)
+    ADD_UNIT(TransferEntropyLagScanErrors)
 END_SUITE
@@ -12,3 +12,26 @@ double average(double const *xs, size_t n)
     }
     return x / n;
 }
+
+void random_binary_series(int *series, size_t n, uint32_t seed)
+{
+    // a small linear congruential generator keeps the tests reproducible
+    for (size_t i = 0; i < n; ++i)
+    {
+        seed = 1664525u * seed + 1013904223u;
+        series[i] = (int)(seed >> 31);
+    }
+}
+
+void window_slice(int const *series, size_t n, size_t m, size_t start,
+    size_t window, int *slice)
+{
+    // copy time steps [start, start + window) of each initial condition
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < window; ++j)
+        {
+            slice[i * window + j] = series[i * m + start + j];
+        }
+    }
+}
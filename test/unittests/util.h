@@ -10,6 +10,11 @@
 #define AVERAGE(XS) average(XS, sizeof(XS) / sizeof(double))
 double average(double const *xs, size_t n);
 
+void random_binary_series(int *series, size_t n, uint32_t seed);
+
+void window_slice(int const *series, size_t n, size_t m, size_t start,
+    size_t window, int *slice);
+
 #define inform_dist_fill_array(dist, array) \
     ASSERT_NOT_NULL(dist); \
     ASSERT_EQUAL(sizeof(array)/sizeof(int), inform_dist_size(dist)); \
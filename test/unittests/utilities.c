@@ -556,6 +556,62 @@ UNIT(DecodeEncode)
     }
 }
 
+UNIT(Encode64)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(UINT64_MAX, inform_encode64(NULL, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(UINT64_MAX, inform_encode64((int[]){0,0,1}, 3, 1, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(UINT64_MAX, inform_encode64((int[]){0,-1,1}, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+
+    int state[64];
+    for (size_t i = 0; i < 64; ++i) state[i] = 1;
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(UINT64_MAX, inform_encode64(state, 64, 2, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(UINT64_MAX >> 1, inform_encode64(state, 63, 2, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_EQUAL(UINT64_C(1) << 60, inform_encode64((int[]){1,0,0,0,0,0,0,0,0,0,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31, 4, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    for (int i = 0; i < 81; ++i)
+    {
+        int small[4];
+        inform_decode(i, 3, small, 4, NULL);
+        ASSERT_EQUAL((uint64_t) i, inform_encode64(small, 4, 3, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+}
+
+UNIT(Decode64Encode64)
+{
+    int state[40];
+    inform_error err = INFORM_SUCCESS;
+    uint64_t const encodings[] = {0, 1, 12345678901ULL, (UINT64_C(1) << 40) - 1};
+    for (size_t i = 0; i < sizeof(encodings) / sizeof(uint64_t); ++i)
+    {
+        inform_decode64(encodings[i], 2, state, 40, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        ASSERT_EQUAL(encodings[i], inform_encode64(state, 40, 2, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+
+    inform_decode64(UINT64_C(1) << 40, 2, state, 40, &err);
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
 UNIT(RandomInt)
 {
     for (int b = 2; b < 5; ++b)
@@ -910,6 +966,46 @@ UNIT(BlackBoxEncodingError)
     }
 }
 
+UNIT(BlackBox64)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        int series[32] = {0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,
+                          0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1};
+        ASSERT_NULL(inform_black_box64(series, 1, 1, 32, (int[]){4},
+            (size_t[]){30}, (size_t[]){2}, NULL, &err));
+        ASSERT_EQUAL(INFORM_EENCODE, err);
+    }
+    {
+        int series[16] = {0,1,1,0,1,1,0,0,
+                          0,1,2,0,1,1,0,2};
+        int box[12];
+        uint64_t box64[12];
+        err = INFORM_SUCCESS;
+        ASSERT_NOT_NULL(inform_black_box(series, 2, 1, 8, (int[]){2,3},
+            (size_t[]){1,2}, (size_t[]){2,1}, box, &err));
+        ASSERT_NOT_NULL(inform_black_box64(series, 2, 1, 8, (int[]){2,3},
+            (size_t[]){1,2}, (size_t[]){2,1}, box64, &err));
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < 5; ++i)
+            ASSERT_EQUAL((uint64_t) box[i], box64[i]);
+    }
+    {
+        int series[48];
+        for (size_t i = 0; i < 48; ++i) series[i] = (i % 3 == 0);
+        err = INFORM_SUCCESS;
+        uint64_t *box = inform_black_box64(series, 1, 1, 48, (int[]){2},
+            (size_t[]){45}, NULL, NULL, &err);
+        ASSERT_NOT_NULL(box);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            ASSERT_EQUAL(inform_encode64(series + i, 45, 2, NULL), box[i]);
+        }
+        free(box);
+    }
+}
+
 UNIT(BlackBoxAllocates)
 {
     inform_error err = INFORM_SUCCESS;
@@ -1748,6 +1844,8 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(DecodeBaseThree)
 
     ADD_UNIT(DecodeEncode)
+    ADD_UNIT(Encode64)
+    ADD_UNIT(Decode64Encode64)
 
     ADD_UNIT(RandomInt)
     ADD_UNIT(RandomIntMinMax)
@@ -1773,6 +1871,7 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(BlackBoxInvalidHistory)
     ADD_UNIT(BlackBoxHistoryFutureTooLong)
     ADD_UNIT(BlackBoxEncodingError)
+    ADD_UNIT(BlackBox64)
     ADD_UNIT(BlackBoxAllocates)
     ADD_UNIT(BlackBoxSingleSeries)
     ADD_UNIT(BlackBoxSingleSeriesEnsemble)
@@ -0,0 +1,203 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <ginger/unit.h>
+#include <inform/shannon.h>
+#include <inform/window_dist.h>
+#include <math.h>
+#include "util.h"
+
+UNIT(WindowAlloc)
+{
+    ASSERT_NULL(inform_window_dist_alloc(0, 3));
+    ASSERT_NULL(inform_window_dist_alloc(3, 0));
+
+    inform_window_dist *wd = inform_window_dist_alloc(4, 3);
+    ASSERT_NOT_NULL(wd);
+    ASSERT_EQUAL(4, inform_dist_size(wd->dist));
+    ASSERT_EQUAL(3, wd->width);
+    ASSERT_EQUAL(0, inform_window_dist_counts(wd));
+    ASSERT_NAN(inform_window_dist_entropy(wd, 2.0));
+    inform_window_dist_free(wd);
+}
+
+UNIT(WindowNull)
+{
+    ASSERT_EQUAL(0, inform_window_dist_counts(NULL));
+    ASSERT_EQUAL(0, inform_window_dist_tick(NULL, 0));
+    ASSERT_EQUAL(0, inform_window_dist_untick(NULL));
+    ASSERT_NAN(inform_window_dist_entropy(NULL, 2.0));
+    ASSERT_NAN(inform_window_dist_mi(NULL, NULL, NULL, 2.0));
+    ASSERT_NAN(inform_window_dist_ce(NULL, NULL, 2.0));
+    inform_window_dist_clear(NULL);
+    inform_window_dist_free(NULL);
+}
+
+UNIT(WindowTickAndEvict)
+{
+    inform_window_dist *wd = inform_window_dist_alloc(3, 3);
+    ASSERT_NOT_NULL(wd);
+
+    ASSERT_EQUAL(0, inform_window_dist_tick(wd, 3));
+    ASSERT_EQUAL(0, inform_window_dist_counts(wd));
+
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 0));
+    ASSERT_EQUAL(2, inform_window_dist_tick(wd, 0));
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 1));
+    ASSERT_EQUAL(3, inform_window_dist_counts(wd));
+    ASSERT_DBL_NEAR_TOL(0.918296, inform_window_dist_entropy(wd, 2.0), 1e-6);
+
+    // the window is full, so the first 0 is evicted
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 2));
+    ASSERT_EQUAL(3, inform_window_dist_counts(wd));
+    ASSERT_EQUAL(1, inform_dist_get(wd->dist, 0));
+    ASSERT_EQUAL(1, inform_dist_get(wd->dist, 1));
+    ASSERT_EQUAL(1, inform_dist_get(wd->dist, 2));
+    ASSERT_DBL_NEAR_TOL(log2(3.0), inform_window_dist_entropy(wd, 2.0), 1e-12);
+    ASSERT_DBL_NEAR_TOL(1.0, inform_window_dist_entropy(wd, 3.0), 1e-12);
+
+    ASSERT_EQUAL(2, inform_window_dist_untick(wd));
+    ASSERT_EQUAL(0, inform_dist_get(wd->dist, 0));
+    ASSERT_DBL_NEAR_TOL(1.0, inform_window_dist_entropy(wd, 2.0), 1e-12);
+    ASSERT_EQUAL(1, inform_window_dist_untick(wd));
+    ASSERT_DBL_NEAR_TOL(0.0, inform_window_dist_entropy(wd, 2.0), 1e-12);
+    ASSERT_EQUAL(0, inform_window_dist_untick(wd));
+    ASSERT_EQUAL(0, inform_window_dist_untick(wd));
+    ASSERT_NAN(inform_window_dist_entropy(wd, 2.0));
+
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 1));
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 2));
+    inform_window_dist_clear(wd);
+    ASSERT_EQUAL(0, inform_window_dist_counts(wd));
+    ASSERT_EQUAL(0, inform_dist_get(wd->dist, 1));
+    ASSERT_EQUAL(1, inform_window_dist_tick(wd, 1));
+    ASSERT_DBL_NEAR_TOL(0.0, inform_window_dist_entropy(wd, 2.0), 1e-12);
+
+    inform_window_dist_free(wd);
+}
+
+UNIT(WindowEntropySlides)
+{
+    size_t const n = 2000, width = 37;
+    int *series = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    random_binary_series(series, n, 2018);
+    for (size_t i = n - 1; i > 0; --i)
+    {
+        series[i] = 2 * series[i] + series[i - 1];
+    }
+
+    inform_window_dist *wd = inform_window_dist_alloc(4, width);
+    ASSERT_NOT_NULL(wd);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ASSERT_TRUE(inform_window_dist_tick(wd, series[i]) > 0);
+        size_t const start = (i + 1 > width) ? i + 1 - width : 0;
+        inform_dist *expect = inform_dist_alloc(4);
+        ASSERT_NOT_NULL(expect);
+        inform_dist_accumulate(expect, series + start, i + 1 - start);
+        ASSERT_EQUAL(i + 1 - start, inform_window_dist_counts(wd));
+        ASSERT_DBL_NEAR_TOL(inform_shannon_entropy(expect, 2.0),
+            inform_window_dist_entropy(wd, 2.0), 1e-10);
+        inform_dist_free(expect);
+    }
+    inform_window_dist_free(wd);
+    free(series);
+}
+
+UNIT(WindowMutualInfo)
+{
+    size_t const n = 1000, width = 50;
+    int *xs = malloc(n * sizeof(int));
+    int *ys = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    ASSERT_NOT_NULL(ys);
+    random_binary_series(xs, n, 7);
+    random_binary_series(ys, n, 11);
+    for (size_t i = 1; i < n; ++i)
+    {
+        // make y partially predictable from x
+        ys[i] = (i % 3 == 0) ? ys[i] : xs[i - 1];
+    }
+
+    inform_window_dist *x = inform_window_dist_alloc(2, width);
+    inform_window_dist *y = inform_window_dist_alloc(2, width);
+    inform_window_dist *xy = inform_window_dist_alloc(4, width);
+    ASSERT_NOT_NULL(x);
+    ASSERT_NOT_NULL(y);
+    ASSERT_NOT_NULL(xy);
+    ASSERT_NAN(inform_window_dist_mi(xy, x, y, 2.0));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        inform_window_dist_tick(x, xs[i]);
+        inform_window_dist_tick(y, ys[i]);
+        inform_window_dist_tick(xy, 2 * xs[i] + ys[i]);
+
+        size_t const start = (i + 1 > width) ? i + 1 - width : 0;
+        inform_dist *ex = inform_dist_alloc(2);
+        inform_dist *ey = inform_dist_alloc(2);
+        inform_dist *exy = inform_dist_alloc(4);
+        for (size_t j = start; j <= i; ++j)
+        {
+            inform_dist_tick(ex, xs[j]);
+            inform_dist_tick(ey, ys[j]);
+            inform_dist_tick(exy, 2 * xs[j] + ys[j]);
+        }
+        ASSERT_DBL_NEAR_TOL(inform_shannon_mi(exy, ex, ey, 2.0),
+            inform_window_dist_mi(xy, x, y, 2.0), 1e-10);
+        ASSERT_DBL_NEAR_TOL(inform_shannon_ce(exy, ex, 2.0),
+            inform_window_dist_ce(xy, x, 2.0), 1e-10);
+        inform_dist_free(exy);
+        inform_dist_free(ey);
+        inform_dist_free(ex);
+    }
+
+    // windows out of step are rejected
+    inform_window_dist_untick(x);
+    ASSERT_NAN(inform_window_dist_mi(xy, x, y, 2.0));
+    ASSERT_NAN(inform_window_dist_ce(xy, x, 2.0));
+
+    inform_window_dist_free(xy);
+    inform_window_dist_free(y);
+    inform_window_dist_free(x);
+    free(ys);
+    free(xs);
+}
+
+UNIT(WindowLongRun)
+{
+    // run well past the point at which the running sum is recomputed
+    size_t const n = 300000, width = 1000;
+    int *series = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    random_binary_series(series, n, 42);
+    for (size_t i = n - 1; i > 1; --i)
+    {
+        series[i] = 4 * series[i] + 2 * series[i - 1] + series[i - 2];
+    }
+
+    inform_window_dist *wd = inform_window_dist_alloc(8, width);
+    ASSERT_NOT_NULL(wd);
+    for (size_t i = 0; i < n; ++i)
+    {
+        inform_window_dist_tick(wd, series[i]);
+    }
+    inform_dist *expect = inform_dist_alloc(8);
+    ASSERT_NOT_NULL(expect);
+    inform_dist_accumulate(expect, series + n - width, width);
+    ASSERT_DBL_NEAR_TOL(inform_shannon_entropy(expect, 2.0),
+        inform_window_dist_entropy(wd, 2.0), 1e-12);
+    inform_dist_free(expect);
+    inform_window_dist_free(wd);
+    free(series);
+}
+
+BEGIN_SUITE(WindowDistribution)
+    ADD_UNIT(WindowAlloc)
+    ADD_UNIT(WindowNull)
+    ADD_UNIT(WindowTickAndEvict)
+    ADD_UNIT(WindowEntropySlides)
+    ADD_UNIT(WindowMutualInfo)
+    ADD_UNIT(WindowLongRun)
+END_SUITE